@@ -223,6 +223,8 @@ static void update_global_location_list (enum ugll_insert_mode);
 
 static void update_global_location_list_nothrow (enum ugll_insert_mode);
 
+static void update_global_location_list_deferrable (enum ugll_insert_mode);
+
 static int is_hardware_watchpoint (const struct breakpoint *bpt);
 
 static void insert_breakpoint_locations (void);
@@ -409,6 +411,12 @@ breakpoints_should_be_inserted_now (void)
 	  return 1;
 	}
 
+      /* The target hides inserted breakpoints from memory reads, and
+	 would rather not have them removed and reinserted around each
+	 stop.  */
+      if (target_keep_breakpoints_inserted ())
+	return 1;
+
       if (threads_are_executing ())
 	return 1;
 
@@ -541,6 +549,23 @@ static struct bp_location **bp_locations;
 
 static unsigned bp_locations_count;
 
+/* Generation number of the current BP_LOCATIONS array.  Bumped by
+   each update_global_location_list call; see
+   bp_location::global_generation.  Never zero.  */
+
+static unsigned int bp_locations_generation = 1;
+
+/* Nesting depth of scoped_defer_location_list_update instances.  */
+
+static int location_list_update_defer_depth;
+
+/* Whether an update of the global location list was deferred while
+   LOCATION_LIST_UPDATE_DEFER_DEPTH was non-zero, and the strongest
+   insert mode requested by the deferred updates.  */
+
+static bool location_list_update_pending;
+static enum ugll_insert_mode location_list_update_pending_mode;
+
 /* Maximum alignment offset between bp_target_info.PLACED_ADDRESS and
    ADDRESS for the current elements of BP_LOCATIONS which get a valid
    result from bp_location_has_shadow.  You can use it for roughly
@@ -785,53 +810,39 @@ show_condition_evaluation_mode (struct ui_file *file, int from_tty,
 		      value);
 }
 
-/* A comparison function for bp_location AP and BP that is used by
-   bsearch.  This comparison function only cares about addresses, unlike
-   the more general bp_locations_compare function.  */
+/* Return true if the address of location LOC is less than ADDRESS.
+   For std::lower_bound over bp_locations, which is sorted by address
+   first.  */
 
-static int
-bp_locations_compare_addrs (const void *ap, const void *bp)
+static bool
+bp_location_address_is_less_than (const bp_location *loc, CORE_ADDR address)
 {
-  const struct bp_location *a = *(const struct bp_location **) ap;
-  const struct bp_location *b = *(const struct bp_location **) bp;
+  return loc->address < address;
+}
 
-  if (a->address == b->address)
-    return 0;
-  else
-    return ((a->address > b->address) - (a->address < b->address));
+/* Return the first location in bp_locations whose address is greater
+   than or equal to ADDRESS.  */
+
+static struct bp_location **
+lower_bound_locp (CORE_ADDR address)
+{
+  return std::lower_bound (bp_locations, bp_locations + bp_locations_count,
+			   address, bp_location_address_is_less_than);
 }
 
 /* Helper function to skip all bp_locations with addresses
    less than ADDRESS.  It returns the first bp_location that
-   is greater than or equal to ADDRESS.  If none is found, just
-   return NULL.  */
+   is at ADDRESS.  If none is found, just return NULL.  */
 
 static struct bp_location **
 get_first_locp_gte_addr (CORE_ADDR address)
 {
-  struct bp_location dummy_loc;
-  struct bp_location *dummy_locp = &dummy_loc;
-  struct bp_location **locp_found = NULL;
-
-  /* Initialize the dummy location's address field.  */
-  dummy_loc.address = address;
+  struct bp_location **locp_found = lower_bound_locp (address);
 
-  /* Find a close match to the first location at ADDRESS.  */
-  locp_found = ((struct bp_location **)
-		bsearch (&dummy_locp, bp_locations, bp_locations_count,
-			 sizeof (struct bp_location **),
-			 bp_locations_compare_addrs));
-
-  /* Nothing was found, nothing left to do.  */
-  if (locp_found == NULL)
+  if (locp_found == bp_locations + bp_locations_count
+      || (*locp_found)->address != address)
     return NULL;
 
-  /* We may have found a location that is at ADDRESS but is not the first in the
-     location's list.  Go backwards (if possible) and locate the first one.  */
-  while ((locp_found - 1) >= bp_locations
-	 && (*(locp_found - 1))->address == address)
-    locp_found--;
-
   return locp_found;
 }
 
@@ -2926,6 +2937,62 @@ update_inserted_breakpoint_locations (void)
     }
 }
 
+/* RAII class that opens a breakpoint batch on the current target,
+   letting it coalesce the insertions and removals made while the
+   batch is open.  The target reports the requests that failed once
+   the batch is closed.  */
+
+class scoped_breakpoint_batch
+{
+public:
+  scoped_breakpoint_batch ()
+  {
+    target_begin_breakpoint_batch ();
+  }
+
+  ~scoped_breakpoint_batch ()
+  {
+    if (!m_finished)
+      {
+	std::vector<bp_target_info *> failed;
+
+	TRY
+	  {
+	    target_end_breakpoint_batch (&failed);
+	  }
+	CATCH (ex, RETURN_MASK_ALL)
+	  {
+	    exception_print (gdb_stderr, ex);
+	  }
+	END_CATCH
+      }
+  }
+
+  /* Close the batch and return the bp_location objects whose request
+     failed on the target.  */
+  std::vector<bp_location *> finish ()
+  {
+    std::vector<bp_target_info *> failed;
+    std::vector<bp_location *> result;
+    struct bp_location *bl, **blp_tmp;
+
+    m_finished = true;
+    target_end_breakpoint_batch (&failed);
+
+    if (!failed.empty ())
+      ALL_BP_LOCATIONS (bl, blp_tmp)
+	if (std::find (failed.begin (), failed.end (), &bl->target_info)
+	    != failed.end ())
+	  result.push_back (bl);
+    return result;
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_breakpoint_batch);
+
+private:
+  bool m_finished = false;
+};
+
 /* Used when starting or continuing the program.  */
 
 static void
@@ -2946,6 +3013,7 @@ insert_breakpoint_locations (void)
   tmp_error_stream.puts ("Warning:\n");
 
   scoped_restore_current_pspace_and_thread restore_pspace_thread;
+  scoped_breakpoint_batch batch;
 
   ALL_BP_LOCATIONS (bl, blp_tmp)
     {
@@ -2975,6 +3043,15 @@ insert_breakpoint_locations (void)
 	error_flag = val;
     }
 
+  /* Requests the target queued may only fail now.  */
+  for (bp_location *failed : batch.finish ())
+    {
+      failed->inserted = 0;
+      tmp_error_stream.printf ("Cannot insert breakpoint %d.\n",
+			       failed->owner->number);
+      error_flag = 1;
+    }
+
   /* If we failed to insert all locations of a watchpoint, remove
      them, as half-inserted watchpoint is of limited use.  */
   ALL_BREAKPOINTS (bpt)  
@@ -3034,12 +3111,19 @@ remove_breakpoints (void)
 {
   struct bp_location *bl, **blp_tmp;
   int val = 0;
+  scoped_breakpoint_batch batch;
 
   ALL_BP_LOCATIONS (bl, blp_tmp)
   {
     if (bl->inserted && !is_tracepoint (bl->owner))
       val |= remove_breakpoint (bl);
   }
+
+  for (bp_location *failed : batch.finish ())
+    {
+      failed->inserted = 1;
+      val = 1;
+    }
   return val;
 }
 
@@ -8217,7 +8301,7 @@ install_breakpoint (int internal, std::unique_ptr<breakpoint> &&arg, int update_
   gdb::observers::breakpoint_created.notify (b);
 
   if (update_gll)
-    update_global_location_list (UGLL_MAY_INSERT);
+    update_global_location_list_deferrable (UGLL_MAY_INSERT);
 }
 
 static void
@@ -8773,12 +8857,10 @@ update_dprintf_command_list (struct breakpoint *b)
 						    command_lines_deleter ()));
 }
 
-/* Update all dprintf commands, making their command lists reflect
-   current style settings.  */
+/* See breakpoint.h.  */
 
-static void
-update_dprintf_commands (const char *args, int from_tty,
-			 struct cmd_list_element *c)
+void
+update_dprintf_breakpoints (void)
 {
   struct breakpoint *b;
 
@@ -8789,6 +8871,16 @@ update_dprintf_commands (const char *args, int from_tty,
     }
 }
 
+/* Update all dprintf commands, making their command lists reflect
+   current style settings.  */
+
+static void
+update_dprintf_commands (const char *args, int from_tty,
+			 struct cmd_list_element *c)
+{
+  update_dprintf_breakpoints ();
+}
+
 /* Create a breakpoint with SAL as location.  Use LOCATION
    as a description of the location, and COND_STRING
    as condition expression.  If LOCATION is NULL then create an
@@ -9419,7 +9511,7 @@ create_breakpoint (struct gdbarch *gdbarch,
   discard_cleanups (bkpt_chain);
 
   /* error call may happen here - have BKPT_CHAIN already discarded.  */
-  update_global_location_list (UGLL_MAY_INSERT);
+  update_global_location_list_deferrable (UGLL_MAY_INSERT);
 
   return 1;
 }
@@ -11604,6 +11696,16 @@ bp_locations_compare (const void *ap, const void *bp)
   return (a > b) - (a < b);
 }
 
+/* Return true if location A sorts before location B in the global
+   location list.  Same ordering as bp_locations_compare, for use with
+   the standard algorithms.  */
+
+static bool
+bp_location_is_less_than (const bp_location *a, const bp_location *b)
+{
+  return bp_locations_compare (&a, &b) < 0;
+}
+
 /* Set bp_locations_placed_address_before_address_max and
    bp_locations_shadow_len_after_address_max according to the current
    content of the bp_locations array.  */
@@ -11803,21 +11905,63 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   unsigned old_locations_count;
   gdb::unique_xmalloc_ptr<struct bp_location *> old_locations (bp_locations);
 
+  /* Locations that were not part of the former bp_locations array.  */
+  std::vector<bp_location *> added_locations;
+
   old_locations_count = bp_locations_count;
   bp_locations = NULL;
   bp_locations_count = 0;
 
+  /* Stamp every current location with a new generation, collecting
+     the ones never seen before.  Old locations whose generation is
+     not bumped here are no longer present.  */
+  if (++bp_locations_generation == 0)
+    bp_locations_generation = 1;
   ALL_BREAKPOINTS (b)
     for (loc = b->loc; loc; loc = loc->next)
-      bp_locations_count++;
+      {
+	if (loc->global_generation == 0)
+	  added_locations.push_back (loc);
+	loc->global_generation = bp_locations_generation;
+	bp_locations_count++;
+      }
+
+  /* The former array is already sorted, so only the added locations
+     need sorting; merge them with the surviving ones.  The sort keys
+     of a location can change after it was added though, for instance
+     the owner's number is cleared when a thread-specific breakpoint is
+     hidden.  If the survivors are no longer in order, sort it all.  */
+  std::sort (added_locations.begin (), added_locations.end (),
+	     bp_location_is_less_than);
 
   bp_locations = XNEWVEC (struct bp_location *, bp_locations_count);
   locp = bp_locations;
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      *locp++ = loc;
-  qsort (bp_locations, bp_locations_count, sizeof (*bp_locations),
-	 bp_locations_compare);
+  auto added_it = added_locations.begin ();
+  struct bp_location *prev_old = NULL;
+  bool survivors_sorted = true;
+  for (old_locp = old_locations.get ();
+       old_locp < old_locations.get () + old_locations_count;
+       old_locp++)
+    {
+      if ((*old_locp)->global_generation != bp_locations_generation)
+	continue;
+
+      if (prev_old != NULL && bp_location_is_less_than (*old_locp, prev_old))
+	survivors_sorted = false;
+      prev_old = *old_locp;
+
+      while (added_it != added_locations.end ()
+	     && bp_location_is_less_than (*added_it, *old_locp))
+	*locp++ = *added_it++;
+      *locp++ = *old_locp;
+    }
+  while (added_it != added_locations.end ())
+    *locp++ = *added_it++;
+  gdb_assert (locp == bp_locations + bp_locations_count);
+
+  if (!survivors_sorted)
+    std::sort (bp_locations, bp_locations + bp_locations_count,
+	       bp_location_is_less_than);
 
   bp_locations_target_extensions_update ();
 
@@ -11828,10 +11972,9 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
      marked as duplicate), we don't need to remove/insert the
      location.
      
-     LOCP is kept in sync with OLD_LOCP, each pointing to the current
-     and former bp_location array state respectively.  */
+     LOCP points to the first location in the new array at the address
+     of OLD_LOCP, or after it.  */
 
-  locp = bp_locations;
   for (old_locp = old_locations.get ();
        old_locp < old_locations.get () + old_locations_count;
        old_locp++)
@@ -11848,9 +11991,7 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
 
       /* Skip LOCP entries which will definitely never be needed.
 	 Stop either at or being the one matching OLD_LOC.  */
-      while (locp < bp_locations + bp_locations_count
-	     && (*locp)->address < old_loc->address)
-	locp++;
+      locp = lower_bound_locp (old_loc->address);
 
       for (loc2p = locp;
 	   (loc2p < bp_locations + bp_locations_count
@@ -12147,6 +12288,45 @@ update_global_location_list_nothrow (enum ugll_insert_mode insert_mode)
   END_CATCH
 }
 
+/* Like update_global_location_list, but if a
+   scoped_defer_location_list_update is live, only record that an
+   update is needed.  Must not be used by callers that are about to
+   free locations.  */
+
+static void
+update_global_location_list_deferrable (enum ugll_insert_mode insert_mode)
+{
+  if (location_list_update_defer_depth > 0)
+    {
+      if (!location_list_update_pending
+	  || insert_mode > location_list_update_pending_mode)
+	location_list_update_pending_mode = insert_mode;
+      location_list_update_pending = true;
+      return;
+    }
+
+  update_global_location_list (insert_mode);
+}
+
+/* See breakpoint.h.  */
+
+scoped_defer_location_list_update::scoped_defer_location_list_update ()
+{
+  location_list_update_defer_depth++;
+}
+
+/* See breakpoint.h.  */
+
+scoped_defer_location_list_update::~scoped_defer_location_list_update ()
+{
+  if (--location_list_update_defer_depth == 0
+      && location_list_update_pending)
+    {
+      location_list_update_pending = false;
+      update_global_location_list_nothrow (location_list_update_pending_mode);
+    }
+}
+
 /* Clear BKP from a BPS.  */
 
 static void
@@ -13205,6 +13385,12 @@ delete_breakpoint (struct breakpoint *bpt)
   if (bpt->number)
     gdb::observers::breakpoint_deleted.notify (bpt);
 
+  /* If adding this breakpoint's locations to the global location
+     list was deferred, do it now, so that the update below finds and
+     releases them.  */
+  if (location_list_update_pending)
+    update_global_location_list (UGLL_DONT_INSERT);
+
   if (breakpoint_chain == bpt)
     breakpoint_chain = bpt->next;
 
@@ -13853,22 +14039,73 @@ decode_location_default (struct breakpoint *b,
   return {};
 }
 
-/* Reset a breakpoint.  */
+/* Return true if the locations of breakpoint B may change now that
+   the objfiles in NEW_OBJFILES were added to the current program
+   space, and nothing else changed.  Only ordinary breakpoints whose
+   locations are all in place are looked at closely; for those, B's
+   location is looked up in NEW_OBJFILES alone, and if nothing is
+   found there, the locations B already has are still the right
+   ones.  */
+
+static bool
+breakpoint_affected_by_objfiles_p (struct breakpoint *b,
+				   const std::vector<objfile *> &new_objfiles)
+{
+  struct bp_location *loc;
+
+  if (b->ops != &bkpt_breakpoint_ops
+      || b->location == NULL
+      || b->location_range_end != NULL
+      || (b->condition_not_parsed && b->extra_string != NULL))
+    return true;
+
+  for (loc = b->loc; loc != NULL; loc = loc->next)
+    {
+      /* A condition that could not be parsed at some location might
+	 parse now.  */
+      if (loc->shlib_disabled
+	  || (b->cond_string != NULL && loc->cond == NULL))
+	return true;
+    }
+
+  scoped_restore restore_objfiles
+    = make_scoped_restore (&linespec_objfiles, &new_objfiles);
+
+  TRY
+    {
+      return !b->ops->decode_location (b, b->location.get (),
+				       current_program_space).empty ();
+    }
+  CATCH (e, RETURN_MASK_ERROR)
+    {
+      return e.error != NOT_FOUND_ERROR;
+    }
+  END_CATCH
+}
+
+/* Reset a breakpoint.  If NEW_OBJFILES is not NULL, only the objfiles
+   it lists were added since the last re-set, and B is left alone if
+   they cannot affect it.  */
 
 static void
-breakpoint_re_set_one (breakpoint *b)
+breakpoint_re_set_one (breakpoint *b,
+		       const std::vector<objfile *> *new_objfiles)
 {
   input_radix = b->input_radix;
   set_language (b->language);
 
+  if (new_objfiles != NULL
+      && !breakpoint_affected_by_objfiles_p (b, *new_objfiles))
+    return;
+
   b->ops->re_set (b);
 }
 
-/* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+/* Re-set breakpoint locations for the current program space, as for
+   breakpoint_re_set and breakpoint_re_set_objfiles.  */
 
-void
-breakpoint_re_set (void)
+static void
+breakpoint_re_set_1 (const std::vector<objfile *> *new_objfiles)
 {
   struct breakpoint *b, *b_tmp;
 
@@ -13899,7 +14136,7 @@ breakpoint_re_set (void)
       {
 	TRY
 	  {
-	    breakpoint_re_set_one (b);
+	    breakpoint_re_set_one (b, new_objfiles);
 	  }
 	CATCH (ex, RETURN_MASK_ALL)
 	  {
@@ -13921,6 +14158,23 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_1 (NULL);
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (const std::vector<objfile *> &new_objfiles)
+{
+  breakpoint_re_set_1 (&new_objfiles);
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -369,6 +369,13 @@ public:
 
   condition_status condition_changed {};
 
+  /* The generation of the global location list this location was
+     last found in by update_global_location_list, or zero if it has
+     never been part of the global list.  This lets the global list
+     be maintained incrementally, by merging in only the locations
+     that were added since the previous update.  */
+  unsigned int global_generation = 0;
+
   agent_expr_up cmd_bytecode;
 
   /* Signals that breakpoint conditions and/or commands need to be
@@ -1251,6 +1258,14 @@ extern void update_breakpoint_locations
 
 extern void breakpoint_re_set (void);
 
+/* Like breakpoint_re_set, but for when the only change since the
+   last re-set is that the objfiles in NEW_OBJFILES were added to the
+   current program space.  Breakpoints that none of those objfiles
+   can affect are not re-set.  */
+
+extern void breakpoint_re_set_objfiles
+  (const std::vector<objfile *> &new_objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
@@ -1645,6 +1660,23 @@ public:
   DISABLE_COPY_AND_ASSIGN (scoped_rbreak_breakpoints);
 };
 
+/* Create an instance of this to batch updates of the global
+   breakpoint location list while creating or enabling many
+   breakpoints at once (e.g. "rbreak").  Location list updates
+   requested by those operations are deferred, and done only once,
+   when the outermost instance is destroyed.  Operations that delete
+   locations still update the location list immediately.  */
+
+class scoped_defer_location_list_update
+{
+public:
+
+  scoped_defer_location_list_update ();
+  ~scoped_defer_location_list_update ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_defer_location_list_update);
+};
+
 /* Breakpoint iterator function.
 
    Calls a callback function once for each breakpoint, so long as the
@@ -1685,4 +1717,9 @@ extern void print_breakpoint (breakpoint *bp);
 /* Command element for the 'commands' command.  */
 extern cmd_list_element *commands_cmd_element;
 
+/* Rebuild the command lists of all dprintf breakpoints.  Targets call
+   this when they stop running agent-style dprintf commands, so that
+   GDB prints them instead.  */
+extern void update_dprintf_breakpoints (void);
+
 #endif /* !defined (BREAKPOINT_H) */
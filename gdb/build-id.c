@@ -26,6 +26,7 @@
 #include "objfiles.h"
 #include "filenames.h"
 #include "gdbcore.h"
+#include "debug-file-cache.h"
 
 /* See build-id.h.  */
 
@@ -102,7 +103,8 @@ build_id_to_debug_bfd (size_t build_id_len, const bfd_byte *build_id)
 
       /* lrealpath() is expensive even for the usually non-existent files.  */
       gdb::unique_xmalloc_ptr<char> filename;
-      if (access (link.c_str (), F_OK) == 0)
+      if (debug_file_cache_may_exist (link.c_str ())
+	  && access (link.c_str (), F_OK) == 0)
 	filename.reset (lrealpath (link.c_str ()));
 
       if (filename == NULL)
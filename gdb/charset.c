@@ -28,6 +28,8 @@
 #include "arch-utils.h"
 #include "gdb_vecs.h"
 #include <ctype.h>
+#include "common/gdb_optional.h"
+#include <unordered_map>
 
 #ifdef USE_WIN32API
 #include <windows.h>
@@ -481,20 +483,168 @@ host_hex_value (char c)
 
 /* Public character management functions.  */
 
+/* An iconv descriptor that is not in use, and the conversion it
+   performs.  */
+
+struct cached_iconv
+{
+  std::string to;
+  std::string from;
+  iconv_t desc;
+};
+
+/* Printing converts every string, and opening a conversion is much
+   more expensive than performing a short one, so descriptors are kept
+   here once their user is done with them, for the next conversion
+   between the same charsets.  */
+
+static std::vector<cached_iconv> iconv_cache;
+
+/* The number of descriptors ICONV_CACHE may hold.  */
+
+#define ICONV_CACHE_SIZE 8
+
+/* Return a descriptor converting from FROM to TO, in its initial
+   state, or (iconv_t) -1 with errno set if there is none.  Release it
+   with cached_iconv_close.  */
+
+static iconv_t
+cached_iconv_open (const char *to, const char *from)
+{
+  for (auto iter = iconv_cache.begin (); iter != iconv_cache.end (); ++iter)
+    if (iter->to == to && iter->from == from)
+      {
+	iconv_t desc = iter->desc;
+
+	iconv_cache.erase (iter);
+#ifndef PHONY_ICONV
+	iconv (desc, NULL, NULL, NULL, NULL);
+#endif
+	return desc;
+      }
+
+  return iconv_open (to, from);
+}
+
+/* Release DESC, which cached_iconv_open returned for TO and FROM.  */
+
+static void
+cached_iconv_close (const char *to, const char *from, iconv_t desc)
+{
+  if (iconv_cache.size () >= ICONV_CACHE_SIZE)
+    {
+      iconv_close (iconv_cache.front ().desc);
+      iconv_cache.erase (iconv_cache.begin ());
+    }
+
+  iconv_cache.push_back ({to, from, desc});
+}
+
+/* Whether each charset looked at by ascii_compatible_charset_p is
+   compatible, by name.  */
+
+static std::unordered_map<std::string, bool> ascii_compatible_charsets;
+
+/* Return true if the ASCII characters are single bytes with their
+   ASCII values in CHARSET, and converting them to and from
+   INTERMEDIATE_ENCODING gives each one's value as a single wide
+   character and back.  Such text can be copied instead of converted.
+   This is found out by converting all of ASCII both ways, which also
+   rules out charsets where bytes in the ASCII range change the
+   meaning of the bytes that follow.  */
+
+static bool
+ascii_compatible_charset_p (const char *charset)
+{
+  auto found = ascii_compatible_charsets.find (charset);
+  if (found != ascii_compatible_charsets.end ())
+    return found->second;
+
+  gdb_byte narrow[128];
+  gdb_wchar_t wide[128];
+  bool result = false;
+
+  for (int i = 0; i < 128; ++i)
+    narrow[i] = i;
+
+  iconv_t desc = cached_iconv_open (INTERMEDIATE_ENCODING, charset);
+  if (desc != (iconv_t) -1)
+    {
+      ICONV_CONST char *inp = (ICONV_CONST char *) narrow;
+      size_t inleft = sizeof (narrow);
+      char *outp = (char *) wide;
+      size_t outleft = sizeof (wide);
+
+      result = (iconv (desc, &inp, &inleft, &outp, &outleft) != (size_t) -1
+		&& inleft == 0 && outleft == 0);
+      for (int i = 0; result && i < 128; ++i)
+	result = wide[i] == i;
+      cached_iconv_close (INTERMEDIATE_ENCODING, charset, desc);
+    }
+
+  if (result)
+    {
+      desc = cached_iconv_open (charset, INTERMEDIATE_ENCODING);
+      result = desc != (iconv_t) -1;
+    }
+  if (result)
+    {
+      ICONV_CONST char *inp = (ICONV_CONST char *) wide;
+      size_t inleft = sizeof (wide);
+      char *outp = (char *) narrow;
+      size_t outleft = sizeof (narrow);
+
+      memset (narrow, 0xff, sizeof (narrow));
+      result = (iconv (desc, &inp, &inleft, &outp, &outleft) != (size_t) -1
+		&& inleft == 0 && outleft == 0);
+      for (int i = 0; result && i < 128; ++i)
+	result = narrow[i] == i;
+      cached_iconv_close (charset, INTERMEDIATE_ENCODING, desc);
+    }
+
+  ascii_compatible_charsets[charset] = result;
+  return result;
+}
+
+/* Return the number of ASCII bytes at the start of the NUM_BYTES
+   bytes at BYTES.  */
+
+static size_t
+ascii_prefix_length (const gdb_byte *bytes, size_t num_bytes)
+{
+  size_t i = 0;
+
+  /* Look at a word at a time while we can.  */
+  for (; i + sizeof (uint64_t) <= num_bytes; i += sizeof (uint64_t))
+    {
+      uint64_t word;
+
+      memcpy (&word, bytes + i, sizeof (word));
+      if ((word & 0x8080808080808080ull) != 0)
+	break;
+    }
+
+  while (i < num_bytes && bytes[i] < 0x80)
+    ++i;
+
+  return i;
+}
+
 class iconv_wrapper
 {
 public:
 
   iconv_wrapper (const char *to, const char *from)
+    : m_to (to), m_from (from)
   {
-    m_desc = iconv_open (to, from);
+    m_desc = cached_iconv_open (to, from);
     if (m_desc == (iconv_t) -1)
       perror_with_name (_("Converting character sets"));
   }
 
   ~iconv_wrapper ()
   {
-    iconv_close (m_desc);
+    cached_iconv_close (m_to, m_from, m_desc);
   }
 
   size_t convert (ICONV_CONST char **inp, size_t *inleft, char **outp,
@@ -505,28 +655,25 @@ public:
 
 private:
 
+  const char *m_to;
+  const char *m_from;
   iconv_t m_desc;
 };
 
-void
-convert_between_encodings (const char *from, const char *to,
-			   const gdb_byte *bytes, unsigned int num_bytes,
-			   int width, struct obstack *output,
-			   enum transliterations translit)
+/* Convert the NUM_BYTES bytes at BYTES using DESC, which converts to
+   TO, and append the result to OUTPUT.  The other arguments are as
+   for convert_between_encodings.  */
+
+static void
+convert_with_iconv (iconv_wrapper &desc, const char *to,
+		    const gdb_byte *bytes, size_t num_bytes,
+		    int width, struct obstack *output,
+		    enum transliterations translit)
 {
   size_t inleft;
   ICONV_CONST char *inp;
   unsigned int space_request;
 
-  /* Often, the host and target charsets will be the same.  */
-  if (!strcmp (from, to))
-    {
-      obstack_grow (output, bytes, num_bytes);
-      return;
-    }
-
-  iconv_wrapper desc (to, from);
-
   inleft = num_bytes;
   inp = (ICONV_CONST char *) bytes;
 
@@ -598,7 +745,91 @@ convert_between_encodings (const char *from, const char *to,
     }
 }
 
-
+/* Return the value of the wide character at BYTES if it is in ASCII,
+   or -1 if it is not.  */
+
+static int
+wide_ascii_value (const gdb_byte *bytes)
+{
+  gdb_wchar_t w;
+
+  memcpy (&w, bytes, sizeof (w));
+  if ((unsigned long) w < 0x80)
+    return w;
+  return -1;
+}
+
+void
+convert_between_encodings (const char *from, const char *to,
+			   const gdb_byte *bytes, unsigned int num_bytes,
+			   int width, struct obstack *output,
+			   enum transliterations translit)
+{
+  /* Often, the host and target charsets will be the same.  */
+  if (!strcmp (from, to))
+    {
+      obstack_grow (output, bytes, num_bytes);
+      return;
+    }
+
+  if (width == sizeof (gdb_wchar_t)
+      && !strcmp (from, INTERMEDIATE_ENCODING)
+      && ascii_compatible_charset_p (to))
+    {
+      /* Wide characters are whole characters, so ASCII can be copied
+	 wherever it is, and only the rest converted.  */
+      gdb::optional<iconv_wrapper> desc;
+      size_t i = 0;
+      int c;
+
+      while (i + width <= num_bytes)
+	{
+	  for (; (i + width <= num_bytes
+		  && (c = wide_ascii_value (bytes + i)) >= 0);
+	       i += width)
+	    obstack_1grow (output, c);
+
+	  size_t start = i;
+	  for (; (i + width <= num_bytes
+		  && wide_ascii_value (bytes + i) < 0);
+	       i += width)
+	    ;
+	  if (i > start)
+	    {
+	      if (!desc)
+		desc.emplace (to, from);
+	      convert_with_iconv (*desc, to, bytes + start, i - start,
+				  width, output, translit);
+	    }
+	}
+
+      /* An incomplete character at the end is dropped, as iconv
+	 would.  */
+      return;
+    }
+
+  if (width == 1
+      && ascii_compatible_charset_p (from)
+      && ascii_compatible_charset_p (to))
+    {
+      /* In some multibyte charsets, bytes in the ASCII range can also
+	 be the second byte of a character, so only the ASCII at the
+	 start can be told apart without converting.  */
+      size_t ascii = ascii_prefix_length (bytes, num_bytes);
+
+      obstack_grow (output, bytes, ascii);
+      bytes += ascii;
+      num_bytes -= ascii;
+      if (num_bytes == 0)
+	return;
+    }
+
+  iconv_wrapper desc (to, from);
+
+  convert_with_iconv (desc, to, bytes, num_bytes, width, output, translit);
+}
+
+
 
 /* Create a new iterator.  */
 wchar_iterator::wchar_iterator (const gdb_byte *input, size_t bytes, 
@@ -608,15 +839,17 @@ wchar_iterator::wchar_iterator (const gdb_byte *input, size_t bytes,
   m_width (width),
   m_out (1)
 {
-  m_desc = iconv_open (INTERMEDIATE_ENCODING, charset);
+  m_ascii = width == 1 && ascii_compatible_charset_p (charset);
+  m_desc = cached_iconv_open (INTERMEDIATE_ENCODING, charset);
   if (m_desc == (iconv_t) -1)
     perror_with_name (_("Converting character sets"));
+  m_charset = charset;
 }
 
 wchar_iterator::~wchar_iterator ()
 {
   if (m_desc != (iconv_t) -1)
-    iconv_close (m_desc);
+    cached_iconv_close (INTERMEDIATE_ENCODING, m_charset.c_str (), m_desc);
 }
 
 int
@@ -627,6 +860,21 @@ wchar_iterator::iterate (enum wchar_iterate_result *out_result,
 {
   size_t out_request;
 
+  /* ASCII stands for itself; see ascii_compatible_charset_p.  Every
+     call returns a whole character, so this is always the start of
+     one.  */
+  if (m_ascii && m_bytes > 0 && *m_input < 0x80)
+    {
+      m_out[0] = *m_input;
+      *out_result = wchar_iterate_ok;
+      *out_chars = m_out.data ();
+      *ptr = m_input;
+      *len = 1;
+      ++m_input;
+      --m_bytes;
+      return 1;
+    }
+
   /* Try to convert some characters.  At first we try to convert just
      a single character.  The reason for this is that iconv does not
      necessarily update its outgoing arguments when it encounters an
@@ -677,8 +925,14 @@ wchar_iterator::iterate (enum wchar_iterate_result *out_result,
 	      continue;
 
 	    case EINVAL:
-	      /* Incomplete input sequence.  Let the caller know, and
-		 arrange for future calls to see EOF.  */
+	      /* Incomplete input sequence.  We still might have
+		 converted a character; if so, return it, and report
+		 the rest next time.  */
+	      if (out_avail < out_request * sizeof (gdb_wchar_t))
+		break;
+
+	      /* Otherwise let the caller know, and arrange for future
+		 calls to see EOF.  */
 	      *out_result = wchar_iterate_incomplete;
 	      *ptr = m_input;
 	      *len = m_bytes;
@@ -135,6 +135,13 @@ class wchar_iterator
   iconv_t m_desc;
 #endif
 
+  /* The name of the input character set.  */
+  std::string m_charset;
+
+  /* True if ASCII characters in the input can be returned as they
+     are, without going through iconv.  */
+  bool m_ascii;
+
   /* The input string.  This is updated as we convert characters.  */
   const gdb_byte *m_input;
   /* The number of bytes remaining in the input.  */
@@ -21,6 +21,7 @@
 #include "arch-utils.h"
 #include <signal.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #ifdef HAVE_SYS_FILE_H
 #include <sys/file.h>		/* needed for F_OK and friends */
 #endif
@@ -45,6 +46,9 @@
 #include "gdb_bfd.h"
 #include "completer.h"
 #include "filestuff.h"
+#include "byte-vector.h"
+#include "common/scoped_fd.h"
+#include <zlib.h>
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -351,6 +355,117 @@ core_file_command (const char *filename, int from_tty)
     core_target_open (filename, from_tty);
 }
 
+/* A decompressed copy of a compressed core file (see "gcore -z").
+   The copy of the last compressed core file opened is kept on disk,
+   and opened again when the same core file is, until another
+   compressed core file is opened or GDB exits.  */
+
+struct decompressed_core
+{
+  ~decompressed_core ()
+  {
+    unlink (tmpname.c_str ());
+  }
+
+  /* The identity of the compressed core file, when it was
+     decompressed.  */
+  dev_t dev;
+  ino_t ino;
+  time_t mtime;
+  off_t size;
+
+  /* The name of the decompressed copy.  */
+  std::string tmpname;
+};
+
+static std::unique_ptr<decompressed_core> last_decompressed_core;
+
+/* If the core file open on FD, named FILENAME, is compressed with
+   gzip (see "gcore -z"), close FD, and return the name of a
+   decompressed copy of it; it is decompressed into a temporary file
+   unless it was the last compressed core file opened.  Otherwise,
+   return an empty string.  */
+
+static std::string
+core_file_decompress (const char *filename, int fd)
+{
+  gdb_byte magic[2];
+  struct stat st, tmp_st;
+
+  if (read (fd, magic, sizeof (magic)) != sizeof (magic)
+      || magic[0] != 0x1f || magic[1] != 0x8b)
+    {
+      if (lseek (fd, 0, SEEK_SET) != 0)
+	perror_with_name (filename);
+      return std::string ();
+    }
+  if (lseek (fd, 0, SEEK_SET) != 0 || fstat (fd, &st) != 0)
+    perror_with_name (filename);
+
+  decompressed_core *last = last_decompressed_core.get ();
+  if (last != NULL
+      && last->dev == st.st_dev
+      && last->ino == st.st_ino
+      && last->mtime == st.st_mtime
+      && last->size == st.st_size
+      && stat (last->tmpname.c_str (), &tmp_st) == 0)
+    {
+      close (fd);
+      return last->tmpname;
+    }
+
+  /* Only the copy of one core file is kept.  */
+  last_decompressed_core.reset (NULL);
+
+  const char *tmpdir = getenv ("TMPDIR");
+  std::string tmpname = string_printf ("%s/gdb-core-XXXXXX",
+				       tmpdir != NULL ? tmpdir : "/tmp");
+  scoped_fd tmp_fd (mkstemp (&tmpname[0]));
+  if (tmp_fd.get () < 0)
+    {
+      close (fd);
+      perror_with_name (tmpname.c_str ());
+    }
+
+  /* Removes the copy if it is not completed.  */
+  std::unique_ptr<decompressed_core> copy (new decompressed_core);
+  copy->dev = st.st_dev;
+  copy->ino = st.st_ino;
+  copy->mtime = st.st_mtime;
+  copy->size = st.st_size;
+  copy->tmpname = tmpname;
+
+  /* On success, closing the gzFile closes FD.  */
+  gzFile in = gzdopen (fd, "rb");
+  if (in == NULL)
+    {
+      close (fd);
+      error (_("\"%s\": can't decompress core file."), filename);
+    }
+
+  /* Leave all-zero chunks as holes, as "gcore" did.  */
+  gdb::byte_vector buf (1024 * 1024);
+  off_t pos = 0;
+  int n;
+
+  while ((n = gzread (in, buf.data (), buf.size ())) > 0)
+    {
+      if (buf[0] != 0 || memcmp (buf.data (), buf.data () + 1, n - 1) != 0)
+	{
+	  if (lseek (tmp_fd.get (), pos, SEEK_SET) != pos
+	      || write (tmp_fd.get (), buf.data (), n) != n)
+	    break;
+	}
+      pos += n;
+    }
+
+  if (gzclose (in) != Z_OK || n != 0 || ftruncate (tmp_fd.get (), pos) != 0)
+    error (_("\"%s\": can't decompress core file."), filename);
+
+  last_decompressed_core = std::move (copy);
+  return tmpname;
+}
+
 /* See gdbcore.h.  */
 
 void
@@ -386,7 +501,28 @@ core_target_open (const char *arg, int from_tty)
   if (scratch_chan < 0)
     perror_with_name (filename.get ());
 
-  gdb_bfd_ref_ptr temp_bfd (gdb_bfd_fopen (filename.get (), gnutarget,
+  /* BFD can not read compressed cores.  Open a decompressed copy
+     instead.  BFD may close and reopen the file by name, so the copy
+     is kept on disk.  */
+  std::string decompressed = core_file_decompress (filename.get (),
+						   scratch_chan);
+  if (!decompressed.empty ())
+    {
+      /* Writes would only change the temporary copy, and be lost.  */
+      if (write_files)
+	error (_("\"%s\" is a compressed core file, which can not be "
+		 "written to.\nUse \"set write off\" to read it."),
+	       filename.get ());
+
+      scratch_chan = gdb_open_cloexec (decompressed.c_str (), flags, 0);
+      if (scratch_chan < 0)
+	perror_with_name (decompressed.c_str ());
+    }
+
+  gdb_bfd_ref_ptr temp_bfd (gdb_bfd_fopen (decompressed.empty ()
+					   ? filename.get ()
+					   : decompressed.c_str (),
+					   gnutarget,
 					   write_files ? FOPEN_RUB : FOPEN_RB,
 					   scratch_chan));
   if (temp_bfd == NULL)
@@ -759,9 +895,7 @@ core_target::xfer_partial (enum target_object object, const char *annex,
       return (section_table_xfer_memory_partial
 	      (readbuf, writebuf,
 	       offset, len, xfered_len,
-	       m_core_section_table.sections,
-	       m_core_section_table.sections_end,
-	       NULL));
+	       &m_core_section_table, NULL));
 
     case TARGET_OBJECT_AUXV:
       if (readbuf)
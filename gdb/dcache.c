@@ -456,6 +456,53 @@ dcache_init (void)
   return dcache;
 }
 
+/* Fill the lines of DCACHE covering LEN bytes at MEMADDR that are not
+   cached yet, fetching them all with a single multi-range read rather
+   than with one target request per line.  Lines crossing a memory
+   region boundary, and lines that fail to read, are left for
+   dcache_read_line.  */
+
+static void
+dcache_read_lines (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len)
+{
+  std::vector<memory_read_request> requests;
+  ULONGEST nlines = ((XFORM (dcache, memaddr) + len + dcache->line_size - 1)
+		     / dcache->line_size);
+  CORE_ADDR addr = MASK (dcache, memaddr);
+  ULONGEST i;
+
+  for (i = 0;
+       i < nlines && requests.size () < dcache_size;
+       i++, addr += dcache->line_size)
+    {
+      struct mem_region *region;
+
+      if (splay_tree_lookup (dcache->tree, (splay_tree_key) addr) != NULL)
+	continue;
+
+      region = lookup_mem_region (addr);
+      if (region->attrib.mode == MEM_WO
+	  || (region->hi != 0 && addr + dcache->line_size > region->hi))
+	continue;
+
+      requests.push_back ({ addr, dcache->line_size, NULL, false });
+    }
+
+  if (requests.size () < 2)
+    return;
+
+  /* At most DCACHE_SIZE lines are allocated, so none of these evicts
+     another.  */
+  for (memory_read_request &r : requests)
+    r.buf = dcache_alloc (dcache, r.addr)->data;
+
+  target_read_raw_memory_list (&requests);
+
+  for (const memory_read_request &r : requests)
+    if (!r.ok)
+      dcache_invalidate_line (dcache, r.addr);
+}
+
 
 /* Read LEN bytes from dcache memory at MEMADDR, transferring to
    debugger address MYADDR.  If the data is presently cached, this
@@ -478,6 +525,9 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->ptid = inferior_ptid;
     }
 
+  if (XFORM (dcache, memaddr) + len > dcache->line_size)
+    dcache_read_lines (dcache, memaddr, len);
+
   for (i = 0; i < len; i++)
     {
       if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
@@ -0,0 +1,262 @@
+/* Cache of directory listings for separate debug file lookups.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "debug-file-cache.h"
+#include "gdb_bfd.h"
+#include "gdbcmd.h"
+#include "observable.h"
+#include "filenames.h"
+#include "common/filestuff.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/* What is known about one directory.  */
+
+struct debug_file_dir
+{
+  enum
+  {
+    /* The directory was read; ENTRIES holds its contents.  */
+    LISTED,
+
+    /* The directory does not exist, so nothing in it does either.  */
+    MISSING,
+
+    /* The directory exists but could not be read, for instance
+       because it is searchable but not readable.  Its contents are
+       not known.  */
+    UNKNOWN
+  } state;
+
+  std::unordered_set<std::string> entries;
+
+  /* For LISTED and UNKNOWN directories, the modification time of the
+     directory when it was read, and the time it was read at.  */
+  time_t mtime;
+  time_t read_time;
+};
+
+/* The directories read so far, by name.  */
+
+static std::unordered_map<std::string, debug_file_dir> debug_file_cache;
+
+/* Whether the cache is used at all.  */
+
+static int debug_file_cache_enabled = 1;
+
+/* Statistics, for "maint info debug-file-cache".  */
+
+static unsigned int debug_file_cache_lookups;
+static unsigned int debug_file_cache_ruled_out;
+static unsigned int debug_file_cache_listings;
+
+/* Return true if what DIR says about a directory is still true.  ST
+   is the result of stat on the directory, or NULL if stat failed.  */
+
+static bool
+debug_file_dir_current (const debug_file_dir &dir, const struct stat *st)
+{
+  if (dir.state == debug_file_dir::MISSING)
+    return st == NULL;
+
+  /* Adding or removing a file changes the modification time of the
+     directory.  Times only have a resolution of a second, so a
+     listing made in the same second as the last change may miss a
+     later change made in that second; make it again.  */
+  return (st != NULL
+	  && st->st_mtime == dir.mtime
+	  && dir.mtime < dir.read_time);
+}
+
+/* Read directory DIRNAME into its cache entry.  ST is the result of
+   stat on the directory, or NULL if stat failed.  */
+
+static debug_file_dir &
+debug_file_cache_read_dir (const std::string &dirname, const struct stat *st)
+{
+  debug_file_dir &dir = debug_file_cache[dirname];
+
+  ++debug_file_cache_listings;
+
+  dir.entries.clear ();
+  dir.mtime = st != NULL ? st->st_mtime : 0;
+  dir.read_time = time (NULL);
+
+  gdb_dir_up dirp (opendir (dirname.c_str ()));
+  if (dirp == NULL)
+    {
+      if (st == NULL && (errno == ENOENT || errno == ENOTDIR))
+	dir.state = debug_file_dir::MISSING;
+      else
+	dir.state = debug_file_dir::UNKNOWN;
+      return dir;
+    }
+
+  struct dirent *ent;
+  while ((ent = readdir (dirp.get ())) != NULL)
+    dir.entries.emplace (ent->d_name);
+
+  dir.state = debug_file_dir::LISTED;
+  return dir;
+}
+
+/* See debug-file-cache.h.  */
+
+bool
+debug_file_cache_may_exist (const char *name)
+{
+#ifdef HAVE_CASE_INSENSITIVE_FILE_SYSTEM
+  /* The names in a listing need not match the case of NAME.  */
+  return true;
+#else
+  if (!debug_file_cache_enabled
+      || is_target_filename (name)
+      || !IS_ABSOLUTE_PATH (name))
+    return true;
+
+  const char *base = lbasename (name);
+  if (*base == '\0')
+    return true;
+
+  ++debug_file_cache_lookups;
+
+  /* Keep the separator when the file is in the root directory.  */
+  std::string dirname (name, base - name > 1 ? base - name - 1 : 1);
+
+  /* Checking that the directory has not changed takes a single stat,
+     however many names are looked up in it.  */
+  struct stat st;
+  const struct stat *stp = stat (dirname.c_str (), &st) == 0 ? &st : NULL;
+
+  auto found = debug_file_cache.find (dirname);
+  const debug_file_dir &dir
+    = (found != debug_file_cache.end ()
+       && debug_file_dir_current (found->second, stp)
+       ? found->second
+       : debug_file_cache_read_dir (dirname, stp));
+
+  bool may_exist;
+  switch (dir.state)
+    {
+    case debug_file_dir::LISTED:
+      may_exist = dir.entries.find (base) != dir.entries.end ();
+      break;
+    case debug_file_dir::MISSING:
+      may_exist = false;
+      break;
+    default:
+      may_exist = true;
+      break;
+    }
+
+  if (!may_exist)
+    ++debug_file_cache_ruled_out;
+  return may_exist;
+#endif
+}
+
+/* See debug-file-cache.h.  */
+
+void
+debug_file_cache_clear (void)
+{
+  debug_file_cache.clear ();
+}
+
+/* Forget the listings when the symbols are reloaded, so that the
+   cache does not grow without bounds.  */
+
+static void
+debug_file_cache_new_objfile (struct objfile *objfile)
+{
+  if (objfile == NULL)
+    debug_file_cache_clear ();
+}
+
+/* The "maint set debug-file-cache" command.  */
+
+static void
+set_debug_file_cache (const char *args, int from_tty,
+		      struct cmd_list_element *c)
+{
+  debug_file_cache_clear ();
+}
+
+/* The "maint info debug-file-cache" command.  */
+
+static void
+maintenance_info_debug_file_cache (const char *args, int from_tty)
+{
+  size_t listed = 0, missing = 0, entries = 0;
+
+  for (const auto &iter : debug_file_cache)
+    {
+      if (iter.second.state == debug_file_dir::LISTED)
+	++listed;
+      else if (iter.second.state == debug_file_dir::MISSING)
+	++missing;
+      entries += iter.second.entries.size ();
+    }
+
+  printf_filtered (_("  directories cached: %s\n"),
+		   pulongest (debug_file_cache.size ()));
+  printf_filtered (_("    listed: %s\n"), pulongest (listed));
+  printf_filtered (_("    missing: %s\n"), pulongest (missing));
+  printf_filtered (_("  entries cached: %s\n"), pulongest (entries));
+  printf_filtered (_("  directory reads: %u\n"), debug_file_cache_listings);
+  printf_filtered (_("  lookups: %u\n"), debug_file_cache_lookups);
+  printf_filtered (_("  lookups ruled out: %u\n"),
+		   debug_file_cache_ruled_out);
+}
+
+/* The "maint flush-debug-file-cache" command.  */
+
+static void
+maintenance_flush_debug_file_cache (const char *args, int from_tty)
+{
+  debug_file_cache_clear ();
+}
+
+void
+_initialize_debug_file_cache (void)
+{
+  gdb::observers::new_objfile.attach (debug_file_cache_new_objfile);
+
+  add_setshow_boolean_cmd ("debug-file-cache", class_maintenance,
+			   &debug_file_cache_enabled, _("\
+Set whether to cache directory listings when looking for debug files."), _("\
+Show whether to cache directory listings when looking for debug files."), _("\
+When on, each directory that may hold separate debug files is read once,\n\
+and names not found in it are not looked up again."),
+			   set_debug_file_cache, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("debug-file-cache", class_maintenance,
+	   maintenance_info_debug_file_cache,
+	   _("Print statistics about the separate debug file cache."),
+	   &maintenanceinfolist);
+
+  add_cmd ("flush-debug-file-cache", class_maintenance,
+	   maintenance_flush_debug_file_cache,
+	   _("Flush the separate debug file cache."),
+	   &maintenancelist);
+}
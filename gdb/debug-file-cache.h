@@ -0,0 +1,41 @@
+/* Cache of directory listings for separate debug file lookups.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DEBUG_FILE_CACHE_H
+#define DEBUG_FILE_CACHE_H
+
+/* Return false if the separate debug file candidate NAME is known not
+   to exist, true if it may exist.
+
+   Looking for separate debug info tries several names for every
+   objfile, nearly all of which do not exist.  Rather than probing
+   each name, the containing directory is read once and remembered,
+   so that all the objfiles whose candidates live in the same
+   directory share one listing.  The listing is read again when the
+   directory's modification time changes, or when a missing directory
+   appears.  Names on the target, relative names, and names whose
+   directory cannot be read are never ruled out.  */
+
+extern bool debug_file_cache_may_exist (const char *name);
+
+/* Forget all the cached directory listings.  */
+
+extern void debug_file_cache_clear (void);
+
+#endif /* DEBUG_FILE_CACHE_H */
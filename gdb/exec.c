@@ -484,6 +484,7 @@ clear_section_table (struct target_section_table *table)
 {
   xfree (table->sections);
   table->sections = table->sections_end = NULL;
+  table->addr_index.clear ();
 }
 
 /* Resize section table TABLE by ADJUSTMENT.
@@ -506,6 +507,7 @@ resize_section_table (struct target_section_table *table, int adjustment)
       table->sections = XRESIZEVEC (struct target_section, table->sections,
 				    new_count);
       table->sections_end = table->sections + new_count;
+      table->addr_index.clear ();
     }
   else
     clear_section_table (table);
@@ -783,81 +785,130 @@ section_table_read_available_memory (gdb_byte *readbuf, ULONGEST offset,
   return TARGET_XFER_UNAVAILABLE;
 }
 
+/* See exec.h.  */
+
+struct target_section *
+target_section_table_lookup (struct target_section_table *table,
+			     CORE_ADDR addr, const char *section_name)
+{
+  std::vector<std::pair<int, CORE_ADDR>> &index = table->addr_index;
+  struct target_section *sections = table->sections;
+  size_t count = table->sections_end - table->sections;
+  struct target_section *best = NULL;
+
+  if (index.size () != count)
+    {
+      CORE_ADDR max_endaddr = 0;
+
+      index.resize (count);
+      for (size_t i = 0; i < count; i++)
+	index[i].first = i;
+      std::stable_sort (index.begin (), index.end (),
+			[=] (const std::pair<int, CORE_ADDR> &a,
+			     const std::pair<int, CORE_ADDR> &b)
+			{
+			  return sections[a.first].addr < sections[b.first].addr;
+			});
+      for (std::pair<int, CORE_ADDR> &entry : index)
+	{
+	  max_endaddr = std::max (max_endaddr, sections[entry.first].endaddr);
+	  entry.second = max_endaddr;
+	}
+    }
+
+  /* Find the first section starting after ADDR, then walk back over
+     the sections starting at or before it for as long as one of them
+     may still contain ADDR.  Sections can overlap, so keep the one
+     that comes first in the table, as a linear search would.  */
+  auto it = std::upper_bound (index.begin (), index.end (), addr,
+			      [=] (CORE_ADDR a,
+				   const std::pair<int, CORE_ADDR> &entry)
+			      {
+				return a < sections[entry.first].addr;
+			      });
+  while (it != index.begin ())
+    {
+      --it;
+      if (it->second <= addr)
+	break;
+
+      struct target_section *p = &sections[it->first];
+
+      if (addr < p->endaddr
+	  && (best == NULL || p < best)
+	  && (section_name == NULL
+	      || strcmp (section_name, p->the_bfd_section->name) == 0))
+	best = p;
+    }
+
+  return best;
+}
+
 enum target_xfer_status
 section_table_xfer_memory_partial (gdb_byte *readbuf, const gdb_byte *writebuf,
 				   ULONGEST offset, ULONGEST len,
 				   ULONGEST *xfered_len,
-				   struct target_section *sections,
-				   struct target_section *sections_end,
+				   struct target_section_table *table,
 				   const char *section_name)
 {
   int res;
   struct target_section *p;
   ULONGEST memaddr = offset;
-  ULONGEST memend = memaddr + len;
 
   if (len == 0)
     internal_error (__FILE__, __LINE__,
 		    _("failed internal consistency check"));
 
-  for (p = sections; p < sections_end; p++)
+  p = target_section_table_lookup (table, memaddr, section_name);
+  if (p == NULL)
+    return TARGET_XFER_EOF;		/* We can't help.  */
+
+  struct bfd_section *asect = p->the_bfd_section;
+  bfd *abfd = asect->owner;
+
+  /* If the section ends before the transfer does, just do half.  */
+  if (len > p->endaddr - memaddr)
+    len = p->endaddr - memaddr;
+
+  if (writebuf)
+    res = bfd_set_section_contents (abfd, asect,
+				    writebuf, memaddr - p->addr,
+				    len);
+  else
     {
-      struct bfd_section *asect = p->the_bfd_section;
-      bfd *abfd = asect->owner;
-
-      if (section_name && strcmp (section_name, asect->name) != 0)
-	continue;		/* not the section we need.  */
-      if (memaddr >= p->addr)
-        {
-	  if (memend <= p->endaddr)
-	    {
-	      /* Entire transfer is within this section.  */
-	      if (writebuf)
-		res = bfd_set_section_contents (abfd, asect,
-						writebuf, memaddr - p->addr,
-						len);
-	      else
-		res = bfd_get_section_contents (abfd, asect,
-						readbuf, memaddr - p->addr,
-						len);
+      /* Core files are never written to, so read their contents from
+	 a mapping of the section, set up on first access, rather than
+	 copying them out of the file for every transfer.  The sections
+	 of a truncated core file are read from the file as before, as
+	 far as they go.  */
+      if (bfd_get_format (abfd) == bfd_core
+	  && (bfd_get_section_flags (abfd, asect) & SEC_HAS_CONTENTS) != 0
+	  && !is_target_filename (bfd_get_filename (abfd))
+	  && gdb_bfd_section_in_file (asect))
+	{
+	  bfd_size_type size;
+	  const gdb_byte *data = gdb_bfd_map_section (asect, &size);
 
-	      if (res != 0)
-		{
-		  *xfered_len = len;
-		  return TARGET_XFER_OK;
-		}
-	      else
-		return TARGET_XFER_EOF;
-	    }
-	  else if (memaddr >= p->endaddr)
+	  if (data != NULL && memaddr - p->addr + len <= size)
 	    {
-	      /* This section ends before the transfer starts.  */
-	      continue;
-	    }
-	  else
-	    {
-	      /* This section overlaps the transfer.  Just do half.  */
-	      len = p->endaddr - memaddr;
-	      if (writebuf)
-		res = bfd_set_section_contents (abfd, asect,
-						writebuf, memaddr - p->addr,
-						len);
-	      else
-		res = bfd_get_section_contents (abfd, asect,
-						readbuf, memaddr - p->addr,
-						len);
-	      if (res != 0)
-		{
-		  *xfered_len = len;
-		  return TARGET_XFER_OK;
-		}
-	      else
-		return TARGET_XFER_EOF;
+	      memcpy (readbuf, data + (memaddr - p->addr), len);
+	      *xfered_len = len;
+	      return TARGET_XFER_OK;
 	    }
-        }
+	}
+
+      res = bfd_get_section_contents (abfd, asect,
+				      readbuf, memaddr - p->addr,
+				      len);
     }
 
-  return TARGET_XFER_EOF;		/* We can't help.  */
+  if (res != 0)
+    {
+      *xfered_len = len;
+      return TARGET_XFER_OK;
+    }
+  else
+    return TARGET_XFER_EOF;
 }
 
 struct target_section_table *
@@ -877,9 +928,7 @@ exec_target::xfer_partial (enum target_object object,
   if (object == TARGET_OBJECT_MEMORY)
     return section_table_xfer_memory_partial (readbuf, writebuf,
 					      offset, len, xfered_len,
-					      table->sections,
-					      table->sections_end,
-					      NULL);
+					      table, NULL);
   else
     return TARGET_XFER_E_IO;
 }
@@ -994,6 +1043,7 @@ set_section_command (const char *args, int from_tty)
 	  offset = secaddr - p->addr;
 	  p->addr += offset;
 	  p->endaddr += offset;
+	  table->addr_index.clear ();
 	  if (from_tty)
 	    exec_ops.files_info ();
 	  return;
@@ -1023,6 +1073,7 @@ exec_set_section_address (const char *filename, int index, CORE_ADDR address)
 	{
 	  p->endaddr += address - p->addr;
 	  p->addr = address;
+	  table->addr_index.clear ();
 	}
     }
 }
@@ -53,11 +53,19 @@ extern enum target_xfer_status
   exec_read_partial_read_only (gdb_byte *readbuf, ULONGEST offset,
 			       ULONGEST len, ULONGEST *xfered_len);
 
+/* Return the first section of TABLE, in table order, containing
+   ADDR.  If SECTION_NAME is not NULL, only consider sections with that
+   name.  Returns NULL if there is no such section.  */
+
+extern struct target_section *
+  target_section_table_lookup (struct target_section_table *table,
+			       CORE_ADDR addr,
+			       const char *section_name = NULL);
+
 /* Read or write from mappable sections of BFD executable files.
 
    Request to transfer up to LEN 8-bit bytes of the target sections
-   defined by SECTIONS and SECTIONS_END.  The OFFSET specifies the
-   starting address.
+   in TABLE.  The OFFSET specifies the starting address.
    If SECTION_NAME is not NULL, only access sections with that same
    name.
 
@@ -74,8 +82,7 @@ extern enum target_xfer_status
   section_table_xfer_memory_partial (gdb_byte *,
 				     const gdb_byte *,
 				     ULONGEST, ULONGEST, ULONGEST *,
-				     struct target_section *,
-				     struct target_section *,
+				     struct target_section_table *,
 				     const char *);
 
 /* Read from mappable read-only sections of BFD executable files.
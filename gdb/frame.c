@@ -1555,6 +1555,9 @@ create_sentinel_frame (struct program_space *pspace, struct regcache *regcache)
 
 static struct obstack frame_cache_obstack;
 
+/* Number of times the frame cache has been flushed.  */
+static unsigned int frame_cache_generation;
+
 void *
 frame_obstack_zalloc (unsigned long size)
 {
@@ -1811,6 +1814,14 @@ frame_observer_target_changed (struct target_ops *target)
   reinit_frame_cache ();
 }
 
+/* See frame.h.  */
+
+unsigned int
+get_frame_cache_generation (void)
+{
+  return frame_cache_generation;
+}
+
 /* Flush the entire frame cache.  */
 
 void
@@ -1818,6 +1829,8 @@ reinit_frame_cache (void)
 {
   struct frame_info *fi;
 
+  ++frame_cache_generation;
+
   /* Tear down all frame caches.  */
   for (fi = sentinel_frame; fi != NULL; fi = fi->prev)
     {
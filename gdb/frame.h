@@ -312,6 +312,11 @@ extern int has_stack_frames (void);
    modifies the target invalidating the frame cache).  */
 extern void reinit_frame_cache (void);
 
+/* Return the number of times the frame cache has been flushed.  The
+   registers and stack of the inferior can only have changed under
+   GDB's feet if this number has changed as well.  */
+extern unsigned int get_frame_cache_generation (void);
+
 /* On demand, create the selected frame and then return it.  If the
    selected frame can not be created, this function prints then throws
    an error.  When MESSAGE is non-NULL, use it for the error message,
@@ -37,16 +37,24 @@
 #include <algorithm>
 #include "common/gdb_unlinker.h"
 #include "byte-vector.h"
+#include "common/scoped_fd.h"
+#include "common/function-view.h"
+#include "filestuff.h"
+#include <zlib.h>
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* The granularity at which all-zero memory is left out of the core
+   file, leaving a hole.  */
+#define GCORE_BLOCK_BYTES 4096
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
-static int gcore_memory_sections (bfd *);
+static int gcore_memory_sections (bfd *, bool);
 
 /* create_gcore_bfd -- helper for gcore_command (exported).
    Open a new bfd core file for output, and return the handle.  */
@@ -63,10 +71,12 @@ create_gcore_bfd (const char *filename)
   return obfd;
 }
 
-/* write_gcore_file_1 -- do the actual work of write_gcore_file.  */
+/* write_gcore_file_1 -- do the actual work of write_gcore_file.
+   Unless COPY_MEMORY, the contents of memory are not written, and
+   their place in the file is left as holes.  */
 
 static void
-write_gcore_file_1 (bfd *obfd)
+write_gcore_file_1 (bfd *obfd, bool copy_memory)
 {
   gdb::unique_xmalloc_ptr<char> note_data;
   int note_size = 0;
@@ -99,7 +109,7 @@ write_gcore_file_1 (bfd *obfd)
   bfd_set_section_size (obfd, note_sec, note_size);
 
   /* Now create the memory/load sections.  */
-  if (gcore_memory_sections (obfd) == 0)
+  if (gcore_memory_sections (obfd, copy_memory) == 0)
     error (_("gcore: failed to get corefile memory sections from target."));
 
   /* Write out the contents of the note section.  */
@@ -108,11 +118,11 @@ write_gcore_file_1 (bfd *obfd)
     warning (_("writing note section (%s)"), bfd_errmsg (bfd_get_error ()));
 }
 
-/* write_gcore_file -- helper for gcore_command (exported).
-   Compose and write the corefile data to the core file.  */
+/* Call FUNC, which writes a core file, between telling the target
+   that a core file is about to be generated and that it was.  */
 
-void
-write_gcore_file (bfd *obfd)
+static void
+gcore_generate (gdb::function_view<void ()> func)
 {
   struct gdb_exception except = exception_none;
 
@@ -120,7 +130,7 @@ write_gcore_file (bfd *obfd)
 
   TRY
     {
-      write_gcore_file_1 (obfd);
+      func ();
     }
   CATCH (e, RETURN_MASK_ALL)
     {
@@ -134,6 +144,140 @@ write_gcore_file (bfd *obfd)
     throw_exception (except);
 }
 
+/* write_gcore_file -- helper for gcore_command (exported).
+   Compose and write the corefile data to the core file.  */
+
+void
+write_gcore_file (bfd *obfd)
+{
+  gcore_generate ([=] ()
+    {
+      write_gcore_file_1 (obfd, true);
+    });
+}
+
+/* A range of a core file that holds the contents of memory.  */
+
+struct gcore_memory_range
+{
+  file_ptr filepos;
+  CORE_ADDR vma;
+  bfd_size_type size;
+};
+
+/* Deleter for a gzFile that was not closed otherwise.  */
+
+struct gzfile_closer
+{
+  void operator() (gzFile file) const
+  {
+    gzclose (file);
+  }
+};
+
+/* Close the core file OBFD, written by write_gcore_file_1 without the
+   contents of memory, and write it compressed with gzip to FILENAME,
+   reading the contents of memory from the target into their place.
+   Only the headers and notes of the core file are thus written to
+   disk uncompressed; memory goes through the compressor as it is
+   read.  */
+
+static void
+gcore_write_compressed (gdb_bfd_ref_ptr &obfd, const char *filename)
+{
+  std::vector<gcore_memory_range> ranges;
+  asection *osec;
+
+  /* The file positions of the sections were set when the note section
+     was written.  */
+  for (osec = obfd->sections; osec != NULL; osec = osec->next)
+    if ((bfd_get_section_flags (obfd.get (), osec) & SEC_LOAD) != 0
+	&& startswith (bfd_section_name (obfd.get (), osec), "load")
+	&& bfd_section_size (obfd.get (), osec) > 0)
+      ranges.push_back ({osec->filepos,
+			 bfd_section_vma (obfd.get (), osec),
+			 bfd_section_size (obfd.get (), osec)});
+  std::sort (ranges.begin (), ranges.end (),
+	     [] (const gcore_memory_range &a, const gcore_memory_range &b)
+	     {
+	       return a.filepos < b.filepos;
+	     });
+
+  /* Closing the BFD writes out the headers around the holes.  */
+  std::string layout_name (bfd_get_filename (obfd.get ()));
+  obfd.reset (NULL);
+
+  scoped_fd fd (gdb_open_cloexec (layout_name.c_str (),
+				  O_RDONLY | O_BINARY, 0));
+  if (fd.get () < 0)
+    perror_with_name (layout_name.c_str ());
+
+  std::unique_ptr<gzFile_s, gzfile_closer> out (gzopen (filename, "wb"));
+  if (out == NULL)
+    error (_("Failed to open '%s' for output."), filename);
+
+  gdb::byte_vector buf (MAX_COPY_BYTES);
+  file_ptr pos = 0;
+
+  /* Copy the core file from POS up to END, or to its end if END is
+     negative.  */
+  auto copy_file = [&] (file_ptr end)
+    {
+      if (lseek (fd.get (), pos, SEEK_SET) != pos)
+	perror_with_name (layout_name.c_str ());
+      while (end < 0 || pos < end)
+	{
+	  size_t size = buf.size ();
+	  if (end >= 0)
+	    size = std::min (size, (size_t) (end - pos));
+
+	  ssize_t n = read (fd.get (), buf.data (), size);
+	  if (n < 0)
+	    perror_with_name (layout_name.c_str ());
+	  if (n == 0)
+	    break;
+	  if (gzwrite (out.get (), buf.data (), n) != n)
+	    error (_("Failed to write compressed corefile '%s'."), filename);
+	  pos += n;
+	}
+    };
+
+  for (const gcore_memory_range &range : ranges)
+    {
+      copy_file (range.filepos);
+
+      bfd_size_type offset, size;
+      bool read_failed = false;
+
+      for (offset = 0; offset < range.size; offset += size)
+	{
+	  size = std::min (range.size - offset, (bfd_size_type) buf.size ());
+
+	  /* What can not be read is left zero, as a hole would be.  */
+	  if (!read_failed
+	      && target_read_memory (range.vma + offset,
+				     buf.data (), size) != 0)
+	    {
+	      warning (_("Memory read failed for corefile "
+			 "section, %s bytes at %s."),
+		       plongest (size),
+		       paddress (target_gdbarch (), range.vma));
+	      read_failed = true;
+	    }
+	  if (read_failed)
+	    memset (buf.data (), 0, size);
+
+	  if (gzwrite (out.get (), buf.data (), size) != (int) size)
+	    error (_("Failed to write compressed corefile '%s'."), filename);
+	}
+      pos = range.filepos + range.size;
+    }
+  copy_file (-1);
+
+  if (gzclose (out.release ()) != Z_OK)
+    error (_("Failed to write compressed corefile '%s'."), filename);
+}
+
 /* gcore_command -- implements the 'gcore' command.
    Generate a core file from the inferior process.  */
 
@@ -141,11 +285,19 @@ static void
 gcore_command (const char *args, int from_tty)
 {
   gdb::unique_xmalloc_ptr<char> corefilename;
+  bool compress = false;
 
   /* No use generating a corefile without a target process.  */
   if (!target_has_execution)
     noprocess ();
 
+  if (args != NULL && startswith (args, "-z")
+      && (args[2] == '\0' || isspace (args[2])))
+    {
+      compress = true;
+      args = skip_spaces (args + 2);
+    }
+
   if (args && *args)
     corefilename.reset (tilde_expand (args));
   else
@@ -154,22 +306,42 @@ gcore_command (const char *args, int from_tty)
       corefilename.reset (xstrprintf ("core.%d", inferior_ptid.pid ()));
     }
 
+  /* For a compressed core, only its headers and notes are written out
+     uncompressed, next to its final name.  */
+  std::string outname (corefilename.get ());
+  if (compress)
+    outname += ".tmp";
+
   if (info_verbose)
     fprintf_filtered (gdb_stdout,
 		      "Opening corefile '%s' for output.\n",
-		      corefilename.get ());
+		      outname.c_str ());
 
   /* Open the output file.  */
-  gdb_bfd_ref_ptr obfd (create_gcore_bfd (corefilename.get ()));
+  gdb_bfd_ref_ptr obfd (create_gcore_bfd (outname.c_str ()));
 
   /* Arrange to unlink the file on failure.  */
-  gdb::unlinker unlink_file (corefilename.get ());
+  gdb::unlinker unlink_file (outname.c_str ());
+
+  if (compress)
+    {
+      gdb::unlinker unlink_compressed (corefilename.get ());
 
-  /* Call worker function.  */
-  write_gcore_file (obfd.get ());
+      gcore_generate ([&] ()
+	{
+	  write_gcore_file_1 (obfd.get (), false);
+	  gcore_write_compressed (obfd, corefilename.get ());
+	});
+      unlink_compressed.keep ();
+    }
+  else
+    {
+      /* Call worker function.  */
+      write_gcore_file (obfd.get ());
 
-  /* Succeeded.  */
-  unlink_file.keep ();
+      /* Succeeded.  */
+      unlink_file.keep ();
+    }
 
   fprintf_filtered (gdb_stdout, "Saved corefile %s\n", corefilename.get ());
 }
@@ -541,6 +713,14 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* Return true if the LEN bytes at BUF are all zero.  */
+
+static bool
+gcore_all_zero (const gdb_byte *buf, size_t len)
+{
+  return len == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
 static void
 gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 {
@@ -572,13 +752,39 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk.data (),
-				     offset, size))
+
+      /* Write only the runs of blocks holding some non-zero byte.
+	 Untouched pages of large processes are mostly zero, and
+	 leaving them out keeps them as holes in a sparse file.  */
+      auto write_run = [&] (bfd_size_type start, bfd_size_type end)
 	{
-	  warning (_("Failed to write corefile contents (%s)."),
-		   bfd_errmsg (bfd_get_error ()));
-	  break;
+	  if (end > start
+	      && !bfd_set_section_contents (obfd, osec,
+					    memhunk.data () + start,
+					    offset + start, end - start))
+	    {
+	      warning (_("Failed to write corefile contents (%s)."),
+		       bfd_errmsg (bfd_get_error ()));
+	      return false;
+	    }
+	  return true;
+	};
+
+      bfd_size_type run_start = 0;
+      bfd_size_type pos, block;
+      bool written = true;
+
+      for (pos = 0; written && pos < size; pos += block)
+	{
+	  block = std::min (size - pos, (bfd_size_type) GCORE_BLOCK_BYTES);
+	  if (gcore_all_zero (memhunk.data () + pos, block))
+	    {
+	      written = write_run (run_start, pos);
+	      run_start = pos + block;
+	    }
 	}
+      if (!written || !write_run (run_start, size))
+	break;
 
       total_size -= size;
       offset += size;
@@ -586,7 +792,7 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 }
 
 static int
-gcore_memory_sections (bfd *obfd)
+gcore_memory_sections (bfd *obfd, bool copy_memory)
 {
   /* Try gdbarch method first, then fall back to target method.  */
   if (!gdbarch_find_memory_regions_p (target_gdbarch ())
@@ -601,7 +807,8 @@ gcore_memory_sections (bfd *obfd)
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
   /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  if (copy_memory)
+    bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
 
   return 1;
 }
@@ -611,8 +818,10 @@ _initialize_gcore (void)
 {
   add_com ("generate-core-file", class_files, gcore_command, _("\
 Save a core file with the current state of the debugged process.\n\
-Usage: generate-core-file [FILENAME]\n\
-Argument is optional filename.  Default filename is 'core.PROCESS_ID'."));
+Usage: generate-core-file [-z] [FILENAME]\n\
+Argument is optional filename.  Default filename is 'core.PROCESS_ID'.\n\
+With -z, the core file is compressed with gzip; \"core-file\" reads\n\
+such files directly."));
 
   add_com_alias ("gcore", "generate-core-file", class_files, 1);
 }
@@ -47,6 +47,8 @@ struct gdb_bfd_section_data
   void *data;
   /* If the data was mmapped, this is the map address.  */
   void *map_addr;
+  /* Nonzero if the data could not be read; it is not tried again.  */
+  int read_failed;
 };
 
 /* A hash table holding every BFD that gdb knows about.  This is not
@@ -641,6 +643,23 @@ get_section_descriptor (asection *section)
 
 /* See gdb_bfd.h.  */
 
+bool
+gdb_bfd_section_in_file (asection *sectp)
+{
+  bfd *abfd = sectp->owner;
+  struct gdb_bfd_data *gdata = (struct gdb_bfd_data *) bfd_usrdata (abfd);
+
+  /* Use the size the file had when it was opened, rather than asking
+     for it on every call; if it is not known, assume the worst.  */
+  if (gdata == NULL || gdata->size <= 0)
+    return false;
+
+  return (abfd->origin + sectp->filepos + bfd_get_section_size (sectp)
+	  <= (ULONGEST) gdata->size);
+}
+
+/* See gdb_bfd.h.  */
+
 const gdb_byte *
 gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 {
@@ -659,8 +678,18 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   if (descriptor->data != NULL)
     goto done;
 
+  /* Nor try again to read it if that failed before.  */
+  if (descriptor->read_failed)
+    {
+      *size = 0;
+      return (const gdb_byte *) NULL;
+    }
+
 #ifdef HAVE_MMAP
-  if (!bfd_is_section_compressed (abfd, sectp))
+  /* The contents of a section in a truncated file may extend past its
+     end, and accessing a mapping of them would then fault.  */
+  if (!bfd_is_section_compressed (abfd, sectp)
+      && gdb_bfd_section_in_file (sectp))
     {
       /* The page size, used when mmapping.  */
       static int pagesize;
@@ -708,6 +737,7 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 	       bfd_get_filename (abfd));
       /* Set size to 0 to prevent further attempts to read the invalid
 	 section.  */
+      descriptor->read_failed = 1;
       *size = 0;
       return (const gdb_byte *) NULL;
     }
@@ -111,10 +111,17 @@ void gdb_bfd_record_inclusion (bfd *includer, bfd *includee);
    and will be destroyed when the BFD is destroyed.  There is no other way to
    free it; for temporary uses of section data, see bfd_malloc_and_get_section.
    SECT may not have relocations.  If there is an error reading the section,
-   this issues a warning, sets *SIZE to 0, and returns NULL.  */
+   this issues a warning, sets *SIZE to 0, and returns NULL; later calls
+   for the same section then return NULL without trying again.  */
 
 const gdb_byte *gdb_bfd_map_section (asection *section, bfd_size_type *size);
 
+/* Return true if the contents of SECTION lie wholly within the file of
+   its BFD, as they may not in a truncated file, such as a core file
+   that was cut short.  */
+
+bool gdb_bfd_section_in_file (asection *section);
+
 /* Compute the CRC for ABFD.  The CRC is used to find and verify
    separate debug files.  When successful, this fills in *CRC_OUT and
    returns 1.  Otherwise, this issues a warning and returns 0.  */
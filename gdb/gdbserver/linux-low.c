@@ -43,6 +43,7 @@
 #include <sys/stat.h>
 #include <sys/vfs.h>
 #include <sys/uio.h>
+#include <algorithm>
 #include "filestuff.h"
 #include "tracepoint.h"
 #include "hostio.h"
@@ -281,6 +282,7 @@ static void complete_ongoing_step_over (void);
 static int linux_low_ptrace_options (int attached);
 static int check_ptrace_stopped_lwp_gone (struct lwp_info *lp);
 static void proceed_one_lwp (thread_info *thread, lwp_info *except);
+static void free_svr4_library_state (struct svr4_library_state *state);
 
 /* When the event-loop is doing a step-over, this points at the thread
    being stepped.  */
@@ -434,6 +436,7 @@ linux_add_process (int pid, int attached)
 
   proc = add_process (pid, attached);
   proc->priv = XCNEW (struct process_info_private);
+  proc->priv->mem_fd = -1;
 
   if (the_low_target.new_process != NULL)
     proc->priv->arch_private = the_low_target.new_process ();
@@ -1669,6 +1672,9 @@ linux_mourn (struct process_info *process)
 
   /* Freeing all private data.  */
   priv = process->priv;
+  if (priv->mem_fd != -1)
+    close (priv->mem_fd);
+  free_svr4_library_state (priv->svr4_libraries);
   if (the_low_target.delete_process != NULL)
     the_low_target.delete_process (priv->arch_private);
   else
@@ -5745,6 +5751,55 @@ linux_store_registers (struct regcache *regcache, int regno)
 }
 
 
+/* Return the /proc/PID/mem file descriptor of the current process,
+   opening it if this is the first access.  Returns -1 if the file
+   can not be opened.  The descriptor is closed when the process is
+   mourned, which also happens when it execs.  */
+
+static int
+linux_proc_mem_fd (void)
+{
+  struct process_info_private *priv = current_process ()->priv;
+
+  if (priv->mem_fd == -1)
+    {
+      char filename[64];
+
+      /* Open through the current LWP rather than the process ID, as
+	 the thread group leader may be a zombie.  The file refers to
+	 the address space, so it remains usable after that LWP
+	 exits.  */
+      sprintf (filename, "/proc/%d/mem", lwpid_of (current_thread));
+      priv->mem_fd = gdb_open_cloexec (filename, O_RDONLY | O_LARGEFILE, 0);
+    }
+
+  return priv->mem_fd;
+}
+
+/* Read LEN bytes at MEMADDR from the address space of PID with
+   process_vm_readv.  Returns the number of bytes read, or -1 on
+   failure.  */
+
+static ssize_t
+linux_vm_read (int pid, CORE_ADDR memaddr, unsigned char *myaddr, int len)
+{
+#ifdef __NR_process_vm_readv
+  struct iovec local, remote;
+
+  local.iov_base = myaddr;
+  local.iov_len = len;
+  remote.iov_base = (void *) (uintptr_t) memaddr;
+  remote.iov_len = len;
+
+  if ((uintptr_t) remote.iov_base != memaddr)
+    return -1;
+
+  return syscall (__NR_process_vm_readv, pid, &local, 1, &remote, 1, 0);
+#else
+  return -1;
+#endif
+}
+
 /* Copy LEN bytes from inferior's memory starting at MEMADDR
    to debugger memory starting at MYADDR.  */
 
@@ -5755,23 +5810,18 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   PTRACE_XFER_TYPE *buffer;
   CORE_ADDR addr;
   int count;
-  char filename[64];
   int i;
   int ret;
   int fd;
+  ssize_t bytes;
 
-  /* Try using /proc.  Don't bother for one word.  */
-  if (len >= 3 * sizeof (long))
-    {
-      int bytes;
-
-      /* We could keep this file open and cache it - possibly one per
-	 thread.  That requires some juggling, but is even faster.  */
-      sprintf (filename, "/proc/%d/mem", pid);
-      fd = open (filename, O_RDONLY | O_LARGEFILE);
-      if (fd == -1)
-	goto no_proc;
+  if (len == 0)
+    return 0;
 
+  /* Try using /proc.  */
+  fd = linux_proc_mem_fd ();
+  if (fd != -1)
+    {
       /* If pread64 is available, use it.  It's faster if the kernel
 	 supports it (only one syscall), and it's 64-bit safe even on
 	 32-bit platforms (for instance, SPARC debugging a SPARC64
@@ -5784,7 +5834,6 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
 	bytes = read (fd, myaddr, len);
 #endif
 
-      close (fd);
       if (bytes == len)
 	return 0;
 
@@ -5797,7 +5846,19 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
 	}
     }
 
- no_proc:
+  /* The mem file may not be accessible (e.g., on kernels that
+     restrict it), but process_vm_readv still does a whole transfer
+     in one system call.  */
+  bytes = linux_vm_read (pid, memaddr, myaddr, len);
+  if (bytes == len)
+    return 0;
+  if (bytes > 0)
+    {
+      memaddr += bytes;
+      myaddr += bytes;
+      len -= bytes;
+    }
+
   /* Round starting address down to longword boundary.  */
   addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
   /* Round ending address up; get number of longwords that makes.  */
@@ -5833,6 +5894,64 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return ret;
 }
 
+/* Implement the read_memory_ranges target_ops method.  Reads as
+   many ranges as possible with a single process_vm_readv call, and
+   falls back to linux_read_memory from the first range that could
+   not be read in full.  */
+
+static void
+linux_read_memory_ranges (struct memory_read_range *ranges, int count)
+{
+  int done = 0;
+
+#ifdef __NR_process_vm_readv
+  int pid = lwpid_of (current_thread);
+
+  while (done < count)
+    {
+      struct iovec local[64], remote[64];
+      int n = std::min (count - done, (int) ARRAY_SIZE (local));
+      ssize_t bytes;
+      int i;
+
+      for (i = 0; i < n; i++)
+	{
+	  struct memory_read_range *r = &ranges[done + i];
+
+	  local[i].iov_base = r->buf;
+	  local[i].iov_len = r->len;
+	  remote[i].iov_base = (void *) (uintptr_t) r->addr;
+	  remote[i].iov_len = r->len;
+	  if ((uintptr_t) remote[i].iov_base != r->addr)
+	    break;
+	}
+      n = i;
+      if (n == 0)
+	break;
+
+      bytes = syscall (__NR_process_vm_readv, pid, local, n, remote, n, 0);
+      if (bytes < 0)
+	break;
+
+      /* The transfer stops at the first range that can not be read,
+	 so the ranges read in full are a prefix of the batch.  */
+      for (i = 0; i < n && bytes >= ranges[done + i].len; i++)
+	{
+	  bytes -= ranges[done + i].len;
+	  ranges[done + i].err = 0;
+	}
+      done += i;
+      if (i < n)
+	break;
+    }
+#endif
+
+  for (; done < count; done++)
+    ranges[done].err = linux_read_memory (ranges[done].addr,
+					  ranges[done].buf,
+					  ranges[done].len);
+}
+
 /* Copy LEN bytes of data from debugger memory at MYADDR to inferior's
    memory at MEMADDR.  On failure (cannot write to the inferior)
    returns the value of errno.  Always succeeds if LEN is zero.  */
@@ -6988,12 +7107,100 @@ struct link_map_offsets
     int l_prev_offset;
   };
 
-/* Construct qXfer:libraries-svr4:read reply.  */
+/* One library as reported by qXfer:libraries-svr4:read.  */
 
-static int
-linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
-			    unsigned const char *writebuf,
-			    CORE_ADDR offset, int len)
+struct svr4_library
+{
+  std::string name;
+  CORE_ADDR lm, l_addr, l_ld;
+
+  bool operator== (const svr4_library &other) const
+  {
+    return (lm == other.lm && l_addr == other.l_addr && l_ld == other.l_ld
+	    && name == other.name);
+  }
+};
+
+/* See linux-low.h.  */
+
+struct svr4_library_state
+{
+  /* The generation of LIBRARIES.  It changes whenever the list does,
+     and is unique among all the processes this server debugs.  Zero
+     if no list was reported yet.  */
+  ULONGEST generation = 0;
+
+  /* The complete library list as last reported.  */
+  std::vector<svr4_library> libraries;
+
+  /* The last document built and the annex it was built for.  GDB
+     reads the document in chunks; the later chunks must come from the
+     same document, not from a new delta against the updated state.  */
+  std::string annex;
+  std::string document;
+};
+
+/* Free STATE, which may be NULL.  */
+
+static void
+free_svr4_library_state (struct svr4_library_state *state)
+{
+  delete state;
+}
+
+/* Source of svr4_library_state generations.  */
+
+static ULONGEST svr4_library_generation;
+
+/* Append the <library> element for LIB to DOCUMENT.  */
+
+static void
+svr4_library_append_xml (std::string &document, const svr4_library &lib)
+{
+  string_appendf (document, "<library name=\"");
+  xml_escape_text_append (&document, lib.name.c_str ());
+  string_appendf (document, "\" lm=\"0x%lx\" "
+		  "l_addr=\"0x%lx\" l_ld=\"0x%lx\"/>",
+		  (unsigned long) lib.lm, (unsigned long) lib.l_addr,
+		  (unsigned long) lib.l_ld);
+}
+
+/* Build into DOCUMENT the changes that turn OLD_LIBS into NEW_LIBS:
+   the libraries removed from OLD_LIBS, and the libraries appended to
+   what remains of it.  Return false if NEW_LIBS cannot be described
+   that way, for instance because libraries were reordered.  */
+
+static bool
+svr4_library_delta_xml (std::string &document,
+			const std::vector<svr4_library> &old_libs,
+			const std::vector<svr4_library> &new_libs)
+{
+  std::string removed;
+  size_t kept = 0;
+
+  for (const svr4_library &lib : old_libs)
+    {
+      if (kept < new_libs.size () && new_libs[kept] == lib)
+	++kept;
+      else if (std::find (new_libs.begin (), new_libs.end (), lib)
+	       != new_libs.end ())
+	return false;
+      else
+	string_appendf (removed, "<removed lm=\"0x%lx\"/>",
+			(unsigned long) lib.lm);
+    }
+
+  document += removed;
+  for (size_t i = kept; i < new_libs.size (); i++)
+    svr4_library_append_xml (document, new_libs[i]);
+  return true;
+}
+
+/* Build into STATE->document the qXfer:libraries-svr4:read reply for
+   ANNEX.  Return false if the library list cannot be found.  */
+
+static bool
+linux_build_libraries_svr4 (const char *annex, svr4_library_state *state)
 {
   struct process_info_private *const priv = current_process ()->priv;
   char filename[PATH_MAX];
@@ -7023,14 +7230,11 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
   const struct link_map_offsets *lmo;
   unsigned int machine;
   int ptr_size;
-  CORE_ADDR lm_addr = 0, lm_prev = 0;
+  CORE_ADDR lm_addr = 0, lm_prev = 0, main_lm = 0;
   CORE_ADDR l_name, l_addr, l_ld, l_next, l_prev;
-  int header_done = 0;
-
-  if (writebuf != NULL)
-    return -2;
-  if (readbuf == NULL)
-    return -1;
+  CORE_ADDR gen = 0;
+  bool gen_p = false;
+  std::string &document = state->document;
 
   pid = lwpid_of (current_thread);
   xsnprintf (filename, sizeof filename, "/proc/%d/exe", pid);
@@ -7053,6 +7257,11 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
 	addrp = &lm_addr;
       else if (len == 4 && startswith (annex, "prev"))
 	addrp = &lm_prev;
+      else if (len == 3 && startswith (annex, "gen"))
+	{
+	  addrp = &gen;
+	  gen_p = true;
+	}
       else
 	{
 	  annex = strchr (sep, ';');
@@ -7065,6 +7274,9 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
       annex = decode_address_to_semicolon (addrp, sep + 1);
     }
 
+  /* Only a whole list can be compared with the one reported last.  */
+  bool whole_list = lm_addr == 0;
+
   if (lm_addr == 0)
     {
       int r_version = 0;
@@ -7076,7 +7288,7 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
 	 for this inferior - do not retry it.  Report it to GDB as
 	 E01, see for the reasons at the GDB solib-svr4.c side.  */
       if (priv->r_debug == (CORE_ADDR) -1)
-	return -1;
+	return false;
 
       if (priv->r_debug != 0)
 	{
@@ -7096,7 +7308,7 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
 	}
     }
 
-  std::string document = "<library-list-svr4 version=\"1.0\"";
+  std::vector<svr4_library> libraries;
 
   while (lm_addr
 	 && read_one_ptr (lm_addr + lmo->l_name_offset,
@@ -7126,7 +7338,7 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
 	 executable does not have PT_DYNAMIC present and this function already
 	 exited above due to failed get_r_debug.  */
       if (lm_prev == 0)
-	string_appendf (document, " main-lm=\"0x%lx\"", (unsigned long) lm_addr);
+	main_lm = lm_addr;
       else
 	{
 	  /* Not checking for error because reading may stop before
@@ -7135,35 +7347,90 @@ linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
 	  linux_read_memory (l_name, libname, sizeof (libname) - 1);
 	  libname[sizeof (libname) - 1] = '\0';
 	  if (libname[0] != '\0')
-	    {
-	      if (!header_done)
-		{
-		  /* Terminate `<library-list-svr4'.  */
-		  document += '>';
-		  header_done = 1;
-		}
-
-	      string_appendf (document, "<library name=\"");
-	      xml_escape_text_append (&document, (char *) libname);
-	      string_appendf (document, "\" lm=\"0x%lx\" "
-			      "l_addr=\"0x%lx\" l_ld=\"0x%lx\"/>",
-			      (unsigned long) lm_addr, (unsigned long) l_addr,
-			      (unsigned long) l_ld);
-	    }
+	    libraries.push_back ({ (char *) libname, lm_addr, l_addr, l_ld });
 	}
 
       lm_prev = lm_addr;
       lm_addr = l_next;
     }
 
-  if (!header_done)
+  document = "<library-list-svr4 version=\"1.0\"";
+  if (main_lm != 0)
+    string_appendf (document, " main-lm=\"0x%lx\"", (unsigned long) main_lm);
+
+  std::string body;
+  bool delta = false;
+
+  if (whole_list)
+    {
+      /* If GDB holds the list reported last, send only what changed
+	 since.  */
+      if (gen_p && gen == state->generation)
+	delta = svr4_library_delta_xml (body, state->libraries, libraries);
+
+      if (delta)
+	string_appendf (document, " base=\"0x%s\"",
+			phex_nz (state->generation, sizeof (ULONGEST)));
+
+      if (state->generation == 0 || libraries != state->libraries)
+	{
+	  state->generation = ++svr4_library_generation;
+	  state->libraries = std::move (libraries);
+	}
+
+      string_appendf (document, " generation=\"0x%s\"",
+		      phex_nz (state->generation, sizeof (ULONGEST)));
+    }
+
+  if (!delta)
+    for (const svr4_library &lib : whole_list ? state->libraries : libraries)
+      svr4_library_append_xml (body, lib);
+
+  if (body.empty ())
     {
       /* Empty list; terminate `<library-list-svr4'.  */
       document += "/>";
     }
   else
-    document += "</library-list-svr4>";
+    {
+      /* Terminate `<library-list-svr4'.  */
+      document += '>';
+      document += body;
+      document += "</library-list-svr4>";
+    }
+
+  return true;
+}
+
+/* Construct qXfer:libraries-svr4:read reply.  */
+
+static int
+linux_qxfer_libraries_svr4 (const char *annex, unsigned char *readbuf,
+			    unsigned const char *writebuf,
+			    CORE_ADDR offset, int len)
+{
+  struct process_info_private *const priv = current_process ()->priv;
+
+  if (writebuf != NULL)
+    return -2;
+  if (readbuf == NULL)
+    return -1;
+
+  if (priv->svr4_libraries == NULL)
+    priv->svr4_libraries = new svr4_library_state;
+  svr4_library_state *state = priv->svr4_libraries;
+
+  /* Build a new document for each transfer, but send the later chunks
+     of a transfer from the document built for its first.  */
+  if (offset == 0 || state->annex != annex)
+    {
+      state->annex.clear ();
+      if (!linux_build_libraries_svr4 (annex, state))
+	return -1;
+      state->annex = annex;
+    }
 
+  const std::string &document = state->document;
   int document_len = document.length ();
   if (offset < document_len)
     document_len -= offset;
@@ -7536,6 +7803,7 @@ static struct target_ops linux_target_ops = {
 #else
   NULL,
 #endif
+  linux_read_memory_ranges,
 };
 
 #ifdef HAVE_LINUX_REGSETS
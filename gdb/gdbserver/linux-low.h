@@ -121,6 +121,15 @@ struct process_info_private
 
   /* &_r_debug.  0 if not yet determined.  -1 if no PT_DYNAMIC in Phdrs.  */
   CORE_ADDR r_debug;
+
+  /* File descriptor of the process's /proc/PID/mem file, kept open
+     across memory reads.  -1 if not open yet.  */
+  int mem_fd;
+
+  /* The library list last reported by qXfer:libraries-svr4:read, so
+     that later transfers can send only what changed.  NULL if not
+     reported yet.  */
+  struct svr4_library_state *svr4_libraries;
 };
 
 struct lwp_info;
@@ -2129,6 +2129,115 @@ crc32 (CORE_ADDR base, int len, unsigned int crc)
   return (unsigned long long) crc;
 }
 
+/* Handle a "qMemReadList:ADDR,LEN;ADDR,LEN;..." packet.  The reply
+   has one entry per range, separated by ';': the range's contents in
+   hex, or "E01" if it could not be read.  */
+
+static void
+handle_qmemreadlist (char *own_buf)
+{
+  client_state &cs = get_client_state ();
+  std::vector<memory_read_range> ranges;
+  const char *p = own_buf + strlen ("qMemReadList:");
+  size_t reply_len = 0;
+  size_t data_len = 0;
+
+  while (*p != '\0')
+    {
+      memory_read_range r;
+      ULONGEST addr, len;
+
+      p = unpack_varlen_hex (p, &addr);
+      if (*p++ != ',')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      p = unpack_varlen_hex (p, &len);
+      if (*p == ';')
+	p++;
+      else if (*p != '\0')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      /* Two hex digits per byte, or an error code, plus the
+	 separator.  Refuse requests whose reply would not fit.  */
+      if (len > PBUFSIZ)
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      reply_len += std::max (2 * len, (ULONGEST) 3) + 1;
+      if (reply_len > PBUFSIZ - 1)
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      r.addr = addr;
+      r.len = len;
+      r.buf = NULL;
+      r.err = 0;
+      ranges.push_back (r);
+      data_len += len;
+    }
+
+  if (ranges.empty ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  gdb::unique_xmalloc_ptr<unsigned char> data
+    ((unsigned char *) xmalloc (data_len + 1));
+  unsigned char *buf = data.get ();
+
+  for (memory_read_range &r : ranges)
+    {
+      r.buf = buf;
+      buf += r.len;
+    }
+
+  if (cs.current_traceframe >= 0)
+    {
+      /* Trace frames are not read in batches.  */
+      for (memory_read_range &r : ranges)
+	if (gdb_read_memory (r.addr, r.buf, r.len) != r.len)
+	  r.err = EIO;
+    }
+  else if (prepare_to_access_memory () == 0)
+    {
+      if (set_desired_thread ())
+	read_inferior_memory_ranges (ranges.data (), ranges.size ());
+      else
+	for (memory_read_range &r : ranges)
+	  r.err = EIO;
+      done_accessing_memory ();
+    }
+  else
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  char *out = own_buf;
+  for (const memory_read_range &r : ranges)
+    {
+      if (out != own_buf)
+	*out++ = ';';
+      if (r.err != 0)
+	{
+	  strcpy (out, "E01");
+	  out += 3;
+	}
+      else
+	out += 2 * bin2hex (r.buf, out, r.len);
+    }
+  *out = '\0';
+}
+
 /* Add supported btrace packets to BUF.  */
 
 static void
@@ -2479,6 +2588,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      strcat (own_buf, ";qMemReadList+");
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -2639,6 +2750,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  if (startswith (own_buf, "qMemReadList:"))
+    {
+      require_running_or_return (own_buf);
+      handle_qmemreadlist (own_buf);
+      return;
+    }
+
   if (startswith (own_buf, "qCRC:"))
     {
       /* CRC check (compare-section).  */
@@ -3096,6 +3214,97 @@ handle_v_kill (char *own_buf)
     }
 }
 
+/* Handle a "vBreakpointList;REQ;REQ;..." packet, where each REQ is
+   a "Z0,ADDR,KIND" or "z0,ADDR,KIND" request, as for the Z0 and z0
+   packets.  The reply has one entry per request, separated by ';':
+   "OK", or "E01" if the request failed.  */
+
+static void
+handle_v_breakpoint_list (char *own_buf)
+{
+  struct request
+  {
+    bool insert;
+    CORE_ADDR addr;
+    int kind;
+  };
+  std::vector<request> requests;
+  const char *p = own_buf + strlen ("vBreakpointList;");
+
+  /* Check the whole list before acting on any of it.  */
+  while (*p != '\0')
+    {
+      request r;
+      ULONGEST addr;
+      char *end;
+
+      if ((p[0] != 'Z' && p[0] != 'z') || p[1] != '0' || p[2] != ',')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      r.insert = p[0] == 'Z';
+      p = unpack_varlen_hex (p + 3, &addr);
+      if (*p != ',')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      r.addr = addr;
+      r.kind = strtol (p + 1, &end, 16);
+      p = end;
+      if (*p == ';')
+	p++;
+      else if (*p != '\0')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      requests.push_back (r);
+    }
+
+  if (requests.empty ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  std::string reply;
+
+  for (const request &r : requests)
+    {
+      int res;
+
+      if (r.insert)
+	{
+	  struct gdb_breakpoint *bp
+	    = set_gdb_breakpoint (Z_PACKET_SW_BP, r.addr, r.kind, &res);
+
+	  if (bp != NULL)
+	    {
+	      res = 0;
+	      clear_breakpoint_conditions_and_commands (bp);
+	    }
+	}
+      else
+	res = delete_gdb_breakpoint (Z_PACKET_SW_BP, r.addr, r.kind);
+
+      /* Software breakpoints are not supported at all; so neither
+	 is this packet.  */
+      if (res == 1)
+	{
+	  own_buf[0] = '\0';
+	  return;
+	}
+
+      if (!reply.empty ())
+	reply += ';';
+      reply += res == 0 ? "OK" : "E01";
+    }
+
+  strcpy (own_buf, reply.c_str ());
+}
+
 /* Handle all of the extended 'v' packets.  */
 void
 handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
@@ -3146,6 +3355,12 @@ handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
       && handle_vFile (own_buf, packet_len, new_packet_len))
     return;
 
+  if (startswith (own_buf, "vBreakpointList;"))
+    {
+      handle_v_breakpoint_list (own_buf);
+      return;
+    }
+
   if (startswith (own_buf, "vAttach;"))
     {
       if ((!extended_protocol || !cs.multi_process) && target_running ())
@@ -130,6 +130,26 @@ read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return res;
 }
 
+/* See target.h.  */
+
+void
+read_inferior_memory_ranges (struct memory_read_range *ranges, int count)
+{
+  int i;
+
+  if (the_target->read_memory_ranges != NULL)
+    the_target->read_memory_ranges (ranges, count);
+  else
+    for (i = 0; i < count; i++)
+      ranges[i].err = (*the_target->read_memory) (ranges[i].addr,
+						  ranges[i].buf,
+						  ranges[i].len);
+
+  for (i = 0; i < count; i++)
+    if (ranges[i].err == 0)
+      check_mem_read (ranges[i].addr, ranges[i].buf, ranges[i].len);
+}
+
 /* See target/target.h.  */
 
 int
@@ -63,6 +63,21 @@ struct thread_resume
   CORE_ADDR step_range_end;	/* Exclusive */
 };
 
+/* One of the ranges of a multi-range memory read.  */
+
+struct memory_read_range
+{
+  /* The range to read.  */
+  CORE_ADDR addr;
+  int len;
+
+  /* Where to store the contents.  */
+  unsigned char *buf;
+
+  /* Set to 0 if the range was read, or to an errno value.  */
+  int err;
+};
+
 struct target_ops
 {
   /* Start a new process.
@@ -477,6 +492,13 @@ struct target_ops
      false for failure.  Return pointer to thread handle via HANDLE
      and the handle's length via HANDLE_LEN.  */
   bool (*thread_handle) (ptid_t ptid, gdb_byte **handle, int *handle_len);
+
+  /* Read the COUNT memory ranges in RANGES, with as few transfers as
+     possible, setting the ERR field of each.  Like `read_memory',
+     this should generally be called through
+     read_inferior_memory_ranges, which handles breakpoint shadowing.
+     If NULL, the ranges are read one at a time with `read_memory'.  */
+  void (*read_memory_ranges) (struct memory_read_range *ranges, int count);
 };
 
 extern struct target_ops *the_target;
@@ -725,6 +747,9 @@ void done_accessing_memory (void);
 
 int read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len);
 
+void read_inferior_memory_ranges (struct memory_read_range *ranges,
+				  int count);
+
 int write_inferior_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
 			   int len);
 
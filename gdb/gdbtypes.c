@@ -39,6 +39,10 @@
 #include "dwarf2loc.h"
 #include "gdbcore.h"
 #include "floatformat.h"
+#include "frame.h"
+#include "inferior.h"
+#include "observable.h"
+#include <unordered_map>
 
 /* Initialize BADNESS constants.  */
 
@@ -2300,6 +2304,74 @@ resolve_dynamic_type_internal (struct type *type,
   return resolved_type;
 }
 
+/* What a dynamic type resolves to depends on the memory at the
+   object's address, and on the selected frame, in which the
+   properties are evaluated.  */
+
+struct dynamic_type_key
+{
+  struct type *type;
+  CORE_ADDR addr;
+  struct inferior *inf;
+  enum language language;
+  bool has_frame;
+  struct frame_id frame;
+
+  bool operator== (const dynamic_type_key &other) const
+  {
+    return (type == other.type
+	    && addr == other.addr
+	    && inf == other.inf
+	    && language == other.language
+	    && has_frame == other.has_frame
+	    && (!has_frame || frame_id_eq (frame, other.frame)));
+  }
+};
+
+struct dynamic_type_key_hash
+{
+  size_t operator() (const dynamic_type_key &key) const
+  {
+    return (std::hash<struct type *> () (key.type)
+	    ^ std::hash<CORE_ADDR> () (key.addr));
+  }
+};
+
+/* Dynamic types resolved for objects in memory since the inferior
+   last stopped.  Resolving a type evaluates its properties and makes
+   a copy of it, each time a value of the type is read; printing an
+   array of such objects reads the same ones over and over.  This is
+   cleared whenever the objfiles may have changed or the inferior was
+   resumed, when dynamic_type_cache_generation no longer matches, and
+   when it grows past DYNAMIC_TYPE_CACHE_SIZE.  */
+
+static std::unordered_map<dynamic_type_key, struct type *,
+			  dynamic_type_key_hash> dynamic_type_cache;
+
+#define DYNAMIC_TYPE_CACHE_SIZE 65536
+
+/* The value of dynamic_type_state_generation when DYNAMIC_TYPE_CACHE
+   was filled.  */
+
+static unsigned int dynamic_type_cache_generation;
+
+/* Return a number that changes whenever the memory or registers of
+   the inferior may have changed while it is stopped: GDB wrote to the
+   target, or flushed the frame cache, as it does after "record goto",
+   "tfind" or switching threads.  "record goto" changes both without
+   notifying the memory_changed or register_changed observers.  */
+
+static unsigned int
+dynamic_type_state_generation (void)
+{
+  return get_frame_cache_generation () + get_target_write_generation ();
+}
+
+/* Statistics, for "maint print type-cache-statistics".  */
+
+static unsigned int dynamic_type_cache_hits;
+static unsigned int dynamic_type_cache_misses;
+
 /* See gdbtypes.h  */
 
 struct type *
@@ -2309,7 +2381,42 @@ resolve_dynamic_type (struct type *type, const gdb_byte *valaddr,
   struct property_addr_info pinfo
     = {check_typedef (type), valaddr, addr, NULL};
 
-  return resolve_dynamic_type_internal (type, &pinfo, 1);
+  /* Only an object in memory can be looked up again; VALADDR may
+     hold anything.  */
+  if (valaddr != NULL || !is_dynamic_type (type))
+    return resolve_dynamic_type_internal (type, &pinfo, 1);
+
+  dynamic_type_key key;
+  key.type = type;
+  key.addr = addr;
+  key.inf = current_inferior ();
+  key.language = current_language->la_language;
+  key.has_frame = has_stack_frames ();
+  key.frame = key.has_frame ? get_frame_id (get_selected_frame (NULL))
+			    : null_frame_id;
+
+  unsigned int generation = dynamic_type_state_generation ();
+  if (generation != dynamic_type_cache_generation)
+    {
+      dynamic_type_cache.clear ();
+      dynamic_type_cache_generation = generation;
+    }
+
+  auto found = dynamic_type_cache.find (key);
+  if (found != dynamic_type_cache.end ())
+    {
+      ++dynamic_type_cache_hits;
+      return found->second;
+    }
+
+  ++dynamic_type_cache_misses;
+
+  struct type *resolved = resolve_dynamic_type_internal (type, &pinfo, 1);
+
+  if (dynamic_type_cache.size () >= DYNAMIC_TYPE_CACHE_SIZE)
+    dynamic_type_cache.clear ();
+  dynamic_type_cache[key] = resolved;
+  return resolved;
 }
 
 /* See gdbtypes.h  */
@@ -2379,6 +2486,69 @@ remove_dyn_prop (enum dynamic_prop_node_kind prop_kind,
     }
 }
 
+/* What lookup_complete_type found for one opaque or stub type, and
+   the context it looked in.  */
+
+struct complete_type_entry
+{
+  struct program_space *pspace;
+  enum language language;
+  bool opaque;
+  struct type *complete;
+};
+
+/* The results of lookup_complete_type, by opaque or stub type.  A
+   stub whose complete type is in its own objfile is replaced by it,
+   but otherwise check_typedef looks for the complete type every time
+   it sees the stub, and for a type that is not defined anywhere, that
+   means searching every objfile.  The lookups only depend on the
+   objfiles loaded, so this is cleared whenever they change.  */
+
+static std::unordered_map<struct type *, complete_type_entry>
+  complete_type_cache;
+
+/* Statistics, for "maint print type-cache-statistics".  */
+
+static unsigned int complete_type_cache_hits;
+static unsigned int complete_type_cache_misses;
+
+/* Return the complete type for TYPE, named NAME, or NULL if there is
+   none.  If OPAQUE, TYPE is a struct, class or union without fields,
+   otherwise it is a stub.  */
+
+static struct type *
+lookup_complete_type (struct type *type, const char *name, bool opaque)
+{
+  auto found = complete_type_cache.find (type);
+  if (found != complete_type_cache.end ()
+      && found->second.pspace == current_program_space
+      && found->second.language == current_language->la_language
+      && found->second.opaque == opaque)
+    {
+      ++complete_type_cache_hits;
+      return found->second.complete;
+    }
+
+  ++complete_type_cache_misses;
+
+  struct type *complete;
+  if (opaque)
+    complete = lookup_transparent_type (name);
+  else
+    {
+      /* FIXME: shouldn't we look in STRUCT_DOMAIN and/or VAR_DOMAIN
+	 as appropriate?  */
+      struct symbol *sym = lookup_symbol (name, 0, STRUCT_DOMAIN, 0).symbol;
+
+      complete = sym != NULL ? SYMBOL_TYPE (sym) : NULL;
+    }
+
+  complete_type_cache[type] = { current_program_space,
+				current_language->la_language,
+				opaque, complete };
+  return complete;
+}
+
 /* Find the real type of TYPE.  This function returns the real type,
    after removing all layers of typedefs, and completing opaque or stub
    types.  Completion changes the TYPE argument, but stripping of
@@ -2405,7 +2575,9 @@ remove_dyn_prop (enum dynamic_prop_node_kind prop_kind,
    (but not any code) that if we don't find a full definition, we'd
    set a flag so we don't spend time in the future checking the same
    type.  That would be a mistake, though--we might load in more
-   symbols which contain a full definition for the type.  */
+   symbols which contain a full definition for the type.  Lookups are
+   only remembered until the objfiles change, see
+   complete_type_cache.  */
 
 struct type *
 check_typedef (struct type *type)
@@ -2490,7 +2662,7 @@ check_typedef (struct type *type)
 	  stub_noname_complaint ();
 	  return make_qualified_type (type, instance_flags, NULL);
 	}
-      newtype = lookup_transparent_type (name);
+      newtype = lookup_complete_type (type, name, true);
 
       if (newtype)
 	{
@@ -2517,27 +2689,25 @@ check_typedef (struct type *type)
   else if (TYPE_STUB (type) && !currently_reading_symtab)
     {
       const char *name = TYPE_NAME (type);
-      /* FIXME: shouldn't we look in STRUCT_DOMAIN and/or VAR_DOMAIN
-         as appropriate?  */
-      struct symbol *sym;
+      struct type *newtype;
 
       if (name == NULL)
 	{
 	  stub_noname_complaint ();
 	  return make_qualified_type (type, instance_flags, NULL);
 	}
-      sym = lookup_symbol (name, 0, STRUCT_DOMAIN, 0).symbol;
-      if (sym)
+      newtype = lookup_complete_type (type, name, false);
+      if (newtype)
         {
           /* Same as above for opaque types, we can replace the stub
              with the complete type only if they are in the same
              objfile.  */
-	  if (TYPE_OBJFILE (SYMBOL_TYPE(sym)) == TYPE_OBJFILE (type))
-            type = make_qualified_type (SYMBOL_TYPE (sym),
+	  if (TYPE_OBJFILE (newtype) == TYPE_OBJFILE (type))
+            type = make_qualified_type (newtype,
 					TYPE_INSTANCE_FLAGS (type),
 					type);
 	  else
-	    type = SYMBOL_TYPE (sym);
+	    type = newtype;
         }
     }
 
@@ -5542,6 +5712,96 @@ objfile_type (struct objfile *objfile)
   return objfile_type;
 }
 
+/* Forget the complete types found for opaque and stub types.  */
+
+static void
+complete_type_cache_clear (void)
+{
+  complete_type_cache.clear ();
+}
+
+/* Forget the resolved dynamic types.  */
+
+static void
+dynamic_type_cache_clear (void)
+{
+  dynamic_type_cache.clear ();
+}
+
+/* Observers clearing the type caches.  Types are freed with their
+   objfile, and a new objfile may define a type that could not be
+   found before.  */
+
+static void
+type_cache_new_objfile (struct objfile *objfile)
+{
+  complete_type_cache_clear ();
+  dynamic_type_cache_clear ();
+}
+
+static void
+type_cache_free_objfile (struct objfile *objfile)
+{
+  complete_type_cache_clear ();
+  dynamic_type_cache_clear ();
+}
+
+static void
+type_cache_target_resumed (ptid_t ptid)
+{
+  dynamic_type_cache_clear ();
+}
+
+static void
+type_cache_inferior_exit (struct inferior *inf)
+{
+  dynamic_type_cache_clear ();
+}
+
+static void
+type_cache_target_changed (struct target_ops *target)
+{
+  dynamic_type_cache_clear ();
+}
+
+/* Print the hit rate of a cache, given its HITS and MISSES.  */
+
+static void
+print_type_cache_hit_rate (unsigned int hits, unsigned int misses)
+{
+  printf_filtered (_("    hits: %u\n"), hits);
+  printf_filtered (_("    misses: %u\n"), misses);
+  if (hits + misses != 0)
+    printf_filtered (_("    hit rate: %.1f%%\n"),
+		     100.0 * hits / ((double) hits + misses));
+}
+
+/* The "maint print type-cache-statistics" command.  */
+
+static void
+maintenance_print_type_cache_statistics (const char *args, int from_tty)
+{
+  printf_filtered (_("  complete types of opaque and stub types:\n"));
+  printf_filtered (_("    entries: %s\n"),
+		   pulongest (complete_type_cache.size ()));
+  print_type_cache_hit_rate (complete_type_cache_hits,
+			     complete_type_cache_misses);
+  printf_filtered (_("  resolved dynamic types:\n"));
+  printf_filtered (_("    entries: %s\n"),
+		   pulongest (dynamic_type_cache.size ()));
+  print_type_cache_hit_rate (dynamic_type_cache_hits,
+			     dynamic_type_cache_misses);
+}
+
+/* The "maint flush-type-cache" command.  */
+
+static void
+maintenance_flush_type_cache (const char *args, int from_tty)
+{
+  complete_type_cache_clear ();
+  dynamic_type_cache_clear ();
+}
+
 void
 _initialize_gdbtypes (void)
 {
@@ -5576,4 +5836,20 @@ _initialize_gdbtypes (void)
 			   NULL, NULL,
 			   show_strict_type_checking,
 			   &setchecklist, &showchecklist);
+
+  gdb::observers::new_objfile.attach (type_cache_new_objfile);
+  gdb::observers::free_objfile.attach (type_cache_free_objfile);
+  gdb::observers::target_resumed.attach (type_cache_target_resumed);
+  gdb::observers::inferior_exit.attach (type_cache_inferior_exit);
+  gdb::observers::target_changed.attach (type_cache_target_changed);
+
+  add_cmd ("type-cache-statistics", class_maintenance,
+	   maintenance_print_type_cache_statistics,
+	   _("Print statistics about the type resolution caches."),
+	   &maintenanceprintlist);
+
+  add_cmd ("flush-type-cache", class_maintenance,
+	   maintenance_flush_type_cache,
+	   _("Flush the type resolution caches."),
+	   &maintenancelist);
 }
@@ -46,6 +46,7 @@
 #include "location.h"
 #include "common/function-view.h"
 #include "common/def-vector.h"
+#include "common/pathstuff.h"
 #include <algorithm>
 
 /* An enumeration of the various things a user might attempt to
@@ -1098,6 +1099,26 @@ maybe_add_address (htab_t set, struct program_space *pspace, CORE_ADDR addr)
   return 1;
 }
 
+/* See linespec.h.  */
+
+const std::vector<struct objfile *> *linespec_objfiles;
+
+/* Return true if symbols and source files in OBJFILE should be
+   searched, according to LINESPEC_OBJFILES.  */
+
+static bool
+linespec_objfile_p (struct objfile *objfile)
+{
+  if (linespec_objfiles == NULL)
+    return true;
+
+  if (objfile->separate_debug_objfile_backlink != NULL)
+    objfile = objfile->separate_debug_objfile_backlink;
+
+  return std::find (linespec_objfiles->begin (), linespec_objfiles->end (),
+		    objfile) != linespec_objfiles->end ();
+}
+
 /* A helper that walks over all matching symtabs in all objfiles and
    calls CALLBACK for each symbol matching NAME.  If SEARCH_PSPACE is
    not NULL, then the search is restricted to just that program
@@ -1129,6 +1150,9 @@ iterate_over_all_matching_symtabs
     {
       struct compunit_symtab *cu;
 
+      if (!linespec_objfile_p (objfile))
+	continue;
+
       if (objfile->sf)
 	objfile->sf->qf->expand_symtabs_matching (objfile,
 						  NULL,
@@ -3847,6 +3871,46 @@ symtab_collector::operator () (struct symtab *symtab)
 
 } // namespace
 
+/* Like iterate_over_symtabs, but only look in the objfiles
+   linespec_objfile_p accepts.  */
+
+static void
+iterate_over_linespec_symtabs (const char *name,
+			       gdb::function_view<bool (symtab *)> callback)
+{
+  struct objfile *objfile;
+  gdb::unique_xmalloc_ptr<char> real_path;
+
+  if (linespec_objfiles == NULL)
+    {
+      iterate_over_symtabs (name, callback);
+      return;
+    }
+
+  if (IS_ABSOLUTE_PATH (name))
+    real_path = gdb_realpath (name);
+
+  ALL_OBJFILES (objfile)
+    {
+      if (linespec_objfile_p (objfile)
+	  && iterate_over_some_symtabs (name, real_path.get (),
+					objfile->compunit_symtabs, NULL,
+					callback))
+	return;
+    }
+
+  ALL_OBJFILES (objfile)
+    {
+      if (linespec_objfile_p (objfile)
+	  && objfile->sf
+	  && objfile->sf->qf->map_symtabs_matching_filename (objfile,
+							     name,
+							     real_path.get (),
+							     callback))
+	return;
+    }
+}
+
 /* Given a file name, return a VEC of all matching symtabs.  If
    SEARCH_PSPACE is not NULL, the search is restricted to just that
    program space.  */
@@ -3868,13 +3932,13 @@ collect_symtabs_from_filename (const char *file,
 	    continue;
 
 	  set_current_program_space (pspace);
-	  iterate_over_symtabs (file, collector);
+	  iterate_over_linespec_symtabs (file, collector);
 	}
     }
   else
     {
       set_current_program_space (search_pspace);
-      iterate_over_symtabs (file, collector);
+      iterate_over_linespec_symtabs (file, collector);
     }
 
   return collector.release_symtabs ();
@@ -4417,6 +4481,9 @@ search_minsyms_for_name (struct collect_info *info,
 
 	ALL_OBJFILES (objfile)
 	{
+	  if (!linespec_objfile_p (objfile))
+	    continue;
+
 	  iterate_over_minimal_symbols (objfile, name,
 					[&] (struct minimal_symbol *msym)
 					  {
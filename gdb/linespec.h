@@ -131,6 +131,12 @@ extern void decode_line_full (const struct event_location *location, int flags,
 			      const char *select_mode,
 			      const char *filter);
 
+/* While this is not NULL, decode_line_full and decode_line_1 only
+   look for source files and symbols in the objfiles it lists, and in
+   their separate debug objfiles.  Set it with a scoped_restore.  */
+
+extern const std::vector<struct objfile *> *linespec_objfiles;
+
 /* Given a string, return the line specified by it, using the current
    source symtab and line as defaults.
    This is for commands like "list" and "breakpoint".  */
@@ -66,6 +66,10 @@
 #include "objfiles.h"
 #include "nat/linux-namespaces.h"
 #include "fileio.h"
+#include "observable.h"
+#include <sys/uio.h>
+#include <chrono>
+#include <unordered_map>
 
 #ifndef SPUFS_MAGIC
 #define SPUFS_MAGIC 0x23c9b64e
@@ -204,6 +208,29 @@ show_debug_linux_nat (struct ui_file *file, int from_tty,
 		    value);
 }
 
+/* Counters for "maint info linux-memory-statistics".  */
+
+static struct
+{
+  /* Successful memory transfers, and the bytes they moved.  */
+  ULONGEST reads, read_bytes;
+  ULONGEST writes, write_bytes;
+
+  /* Time spent in successful reads.  */
+  std::chrono::steady_clock::duration read_time;
+
+  /* Number of times a /proc/PID/mem file was opened.  */
+  ULONGEST mem_file_opens;
+
+  /* Reads done with process_vm_readv.  */
+  ULONGEST vm_reads;
+
+  /* Transfers that fell back to PTRACE_PEEKTEXT/POKETEXT.  */
+  ULONGEST ptrace_xfers;
+} linux_mem_stats;
+
+static void close_proc_mem_file (int pid);
+
 struct simple_pid_list
 {
   int pid;
@@ -506,6 +533,8 @@ linux_nat_target::follow_fork (int follow_child, int detach_fork)
 	      ptrace (PTRACE_DETACH, child_pid, 0, signo);
 	    }
 
+	  close_proc_mem_file (child_pid);
+
 	  do_cleanups (old_chain);
 	}
       else
@@ -2077,6 +2106,9 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
       ourstatus->value.execd_pathname
 	= xstrdup (linux_proc_pid_to_exec_file (pid));
 
+      /* The cached mem file refers to the old address space.  */
+      close_proc_mem_file (pid);
+
       /* The thread that execed must have been resumed, but, when a
 	 thread execs, it changes its tid to the tgid, and the old
 	 tgid thread might have not been resumed.  */
@@ -3888,6 +3920,38 @@ linux_nat_target::xfer_partial (enum target_object object,
 	offset &= ((ULONGEST) 1 << addr_bit) - 1;
     }
 
+  if (object == TARGET_OBJECT_MEMORY)
+    {
+      const auto start = std::chrono::steady_clock::now ();
+
+      xfer = linux_proc_xfer_partial (object, annex, readbuf, writebuf,
+				      offset, len, xfered_len);
+      if (xfer == TARGET_XFER_EOF)
+	{
+	  linux_mem_stats.ptrace_xfers++;
+	  xfer = inf_ptrace_target::xfer_partial (object, annex, readbuf,
+						  writebuf, offset, len,
+						  xfered_len);
+	}
+
+      if (xfer == TARGET_XFER_OK)
+	{
+	  if (readbuf != NULL)
+	    {
+	      linux_mem_stats.reads++;
+	      linux_mem_stats.read_bytes += *xfered_len;
+	      linux_mem_stats.read_time
+		+= std::chrono::steady_clock::now () - start;
+	    }
+	  else
+	    {
+	      linux_mem_stats.writes++;
+	      linux_mem_stats.write_bytes += *xfered_len;
+	    }
+	}
+      return xfer;
+    }
+
   xfer = linux_proc_xfer_partial (object, annex, readbuf, writebuf,
 				  offset, len, xfered_len);
   if (xfer != TARGET_XFER_EOF)
@@ -3960,6 +4024,89 @@ linux_nat_target::pid_to_exec_file (int pid)
   return linux_proc_pid_to_exec_file (pid);
 }
 
+/* Open /proc/PID/task/LWP/mem files, keyed by process id.  The file
+   gives access to the address space of the whole process, and opening
+   it for every transfer is expensive.  */
+
+static std::unordered_map<int, int> proc_mem_files;
+
+/* Close the mem file cached for process PID, if any.  This must be
+   done when the process execs, since the file refers to the address
+   space the process had when it was opened, and when GDB stops
+   debugging the process.  */
+
+static void
+close_proc_mem_file (int pid)
+{
+  auto it = proc_mem_files.find (pid);
+
+  if (it != proc_mem_files.end ())
+    {
+      close (it->second);
+      proc_mem_files.erase (it);
+    }
+}
+
+/* Return a file descriptor for the mem file of the process of PTID,
+   opening it through PTID's LWP if not cached yet.  Returns -1 if it
+   can not be opened.  */
+
+static int
+get_proc_mem_file (ptid_t ptid)
+{
+  auto it = proc_mem_files.find (ptid.pid ());
+  char filename[64];
+  int fd;
+
+  if (it != proc_mem_files.end ())
+    return it->second;
+
+  xsnprintf (filename, sizeof filename, "/proc/%d/task/%ld/mem",
+	     ptid.pid (), ptid.lwp_p () ? ptid.lwp () : (long) ptid.pid ());
+  fd = gdb_open_cloexec (filename, O_RDWR | O_LARGEFILE, 0);
+  if (fd == -1)
+    return -1;
+
+  linux_mem_stats.mem_file_opens++;
+  proc_mem_files[ptid.pid ()] = fd;
+  return fd;
+}
+
+/* Implement the inferior_exit observer.  */
+
+static void
+linux_nat_inferior_exit (struct inferior *inf)
+{
+  close_proc_mem_file (inf->pid);
+}
+
+/* Read LEN bytes at OFFSET from the address space of process PID with
+   process_vm_readv, for when its mem file can not be used.  Returns
+   the number of bytes read, or -1 on failure.  */
+
+static LONGEST
+linux_vm_read (int pid, gdb_byte *readbuf, ULONGEST offset, LONGEST len)
+{
+#ifdef __NR_process_vm_readv
+  struct iovec local, remote;
+
+  local.iov_base = readbuf;
+  local.iov_len = len;
+  remote.iov_base = (void *) (uintptr_t) offset;
+  remote.iov_len = len;
+
+  /* The address may not fit in the remote iovec, for instance when a
+     32-bit GDB debugs a 64-bit process.  */
+  if ((uintptr_t) remote.iov_base != offset)
+    return -1;
+
+  linux_mem_stats.vm_reads++;
+  return syscall (__NR_process_vm_readv, pid, &local, 1, &remote, 1, 0);
+#else
+  return -1;
+#endif
+}
+
 /* Implement the to_xfer_partial target method using /proc/<pid>/mem.
    Because we can use a single read/write call, this can be much more
    efficient than banging away at PTRACE_PEEKTEXT.  */
@@ -3970,40 +4117,46 @@ linux_proc_xfer_partial (enum target_object object,
 			 const gdb_byte *writebuf,
 			 ULONGEST offset, LONGEST len, ULONGEST *xfered_len)
 {
-  LONGEST ret;
+  LONGEST ret = -1;
   int fd;
-  char filename[64];
 
   if (object != TARGET_OBJECT_MEMORY)
     return TARGET_XFER_EOF;
 
-  /* Don't bother for one word.  */
-  if (len < 3 * sizeof (long))
-    return TARGET_XFER_EOF;
-
-  /* We could keep this file open and cache it - possibly one per
-     thread.  That requires some juggling, but is even faster.  */
-  xsnprintf (filename, sizeof filename, "/proc/%ld/mem",
-	     inferior_ptid.lwp ());
-  fd = gdb_open_cloexec (filename, ((readbuf ? O_RDONLY : O_WRONLY)
-				    | O_LARGEFILE), 0);
-  if (fd == -1)
-    return TARGET_XFER_EOF;
+  /* The mem file is kept open, so that even single words are cheaper
+     to transfer through it than with PTRACE_PEEKTEXT.  Try twice, in
+     case the cached file refers to an address space that is gone, for
+     instance after an exec GDB did not see.  */
+  for (int attempt = 0; attempt < 2; attempt++)
+    {
+      fd = get_proc_mem_file (inferior_ptid);
+      if (fd == -1)
+	break;
 
-  /* Use pread64/pwrite64 if available, since they save a syscall and can
-     handle 64-bit offsets even on 32-bit platforms (for instance, SPARC
-     debugging a SPARC64 application).  */
+      /* Use pread64/pwrite64 if available, since they save a syscall
+	 and can handle 64-bit offsets even on 32-bit platforms (for
+	 instance, SPARC debugging a SPARC64 application).  */
 #ifdef HAVE_PREAD64
-  ret = (readbuf ? pread64 (fd, readbuf, len, offset)
-	 : pwrite64 (fd, writebuf, len, offset));
+      ret = (readbuf ? pread64 (fd, readbuf, len, offset)
+	     : pwrite64 (fd, writebuf, len, offset));
 #else
-  ret = lseek (fd, offset, SEEK_SET);
-  if (ret != -1)
-    ret = (readbuf ? read (fd, readbuf, len)
-	   : write (fd, writebuf, len));
+      ret = lseek (fd, offset, SEEK_SET);
+      if (ret != -1)
+	ret = (readbuf ? read (fd, readbuf, len)
+	       : write (fd, writebuf, len));
 #endif
 
-  close (fd);
+      /* Zero means the address space the file was opened for does not
+	 exist anymore; an error is about this access only.  */
+      if (ret != 0)
+	break;
+      close_proc_mem_file (inferior_ptid.pid ());
+    }
+
+  /* Reads can also go through process_vm_readv.  Writes can not, as
+     they must be able to modify read-only pages, like text.  */
+  if (fd == -1 && readbuf != NULL)
+    ret = linux_vm_read (inferior_ptid.pid (), readbuf, offset, len);
 
   if (ret == -1 || ret == 0)
     return TARGET_XFER_EOF;
@@ -4014,6 +4167,33 @@ linux_proc_xfer_partial (enum target_object object,
     }
 }
 
+/* Implement "maint info linux-memory-statistics".  */
+
+static void
+maintenance_info_linux_memory_statistics (const char *args, int from_tty)
+{
+  const double seconds
+    = std::chrono::duration<double> (linux_mem_stats.read_time).count ();
+
+  printf_filtered (_("Memory reads: %s, %s bytes\n"),
+		   pulongest (linux_mem_stats.reads),
+		   pulongest (linux_mem_stats.read_bytes));
+  printf_filtered (_("Memory writes: %s, %s bytes\n"),
+		   pulongest (linux_mem_stats.writes),
+		   pulongest (linux_mem_stats.write_bytes));
+  if (seconds > 0)
+    printf_filtered (_("Read throughput: %.2f MB/s, %.0f reads/s\n"),
+		     linux_mem_stats.read_bytes / seconds / (1024 * 1024),
+		     linux_mem_stats.reads / seconds);
+  printf_filtered (_("Mem file opens: %s, cached: %s\n"),
+		   pulongest (linux_mem_stats.mem_file_opens),
+		   pulongest (proc_mem_files.size ()));
+  printf_filtered (_("process_vm_readv calls: %s\n"),
+		   pulongest (linux_mem_stats.vm_reads));
+  printf_filtered (_("ptrace transfers: %s\n"),
+		   pulongest (linux_mem_stats.ptrace_xfers));
+}
+
 
 /* Enumerate spufs IDs for process PID.  */
 static LONGEST
@@ -4707,6 +4887,13 @@ Enables printf debugging output."),
   sigemptyset (&blocked_mask);
 
   lwp_lwpid_htab_create ();
+
+  gdb::observers::inferior_exit.attach (linux_nat_inferior_exit);
+
+  add_cmd ("linux-memory-statistics", class_maintenance,
+	   maintenance_info_linux_memory_statistics, _("\
+Print statistics about memory transfers with GNU/Linux processes."),
+	   &maintenanceinfolist);
 }
 
 
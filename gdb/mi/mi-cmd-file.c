@@ -21,6 +21,7 @@
 #include "mi-cmds.h"
 #include "mi-getopt.h"
 #include "mi-interp.h"
+#include "mi-main.h"
 #include "ui-out.h"
 #include "symtab.h"
 #include "source.h"
@@ -29,6 +30,7 @@
 #include "solib.h"
 #include "solist.h"
 #include "gdb_regex.h"
+#include "common/gdb_optional.h"
 
 /* Return to the client the absolute path and line number of the 
    current file being executed.  */
@@ -62,22 +64,27 @@ mi_cmd_file_list_exec_source_file (const char *command, char **argv, int argc)
 		    COMPUNIT_MACRO_TABLE (SYMTAB_COMPUNIT (st.symtab)) != NULL);
 }
 
-/* A callback for map_partial_symbol_filenames.  */
+/* A source file name, and its full name if known.  */
 
-static void
-print_partial_file_name (const char *filename, const char *fullname,
-			 void *ignore)
+struct mi_source_file
 {
-  struct ui_out *uiout = current_uiout;
+  std::string filename;
+  gdb::optional<std::string> fullname;
+};
 
-  uiout->begin (ui_out_type_tuple, NULL);
+/* A callback for map_partial_symbol_filenames.  */
 
-  uiout->field_string ("file", filename);
+static void
+collect_partial_file_name (const char *filename, const char *fullname,
+			   void *data)
+{
+  std::vector<mi_source_file> *files = (std::vector<mi_source_file> *) data;
+  mi_source_file file;
 
+  file.filename = filename;
   if (fullname)
-    uiout->field_string ("fullname", fullname);
-
-  uiout->end (ui_out_type_tuple);
+    file.fullname.emplace (fullname);
+  files->push_back (std::move (file));
 }
 
 void
@@ -87,28 +94,38 @@ mi_cmd_file_list_exec_source_files (const char *command, char **argv, int argc)
   struct compunit_symtab *cu;
   struct symtab *s;
   struct objfile *objfile;
+  std::vector<mi_source_file> files;
 
   if (!mi_valid_noargs ("-file-list-exec-source-files", argc, argv))
     error (_("-file-list-exec-source-files: Usage: No args"));
 
-  /* Print the table header.  */
-  uiout->begin (ui_out_type_list, "files");
-
   /* Look at all of the file symtabs.  */
   ALL_FILETABS (objfile, cu, s)
   {
-    uiout->begin (ui_out_type_tuple, NULL);
-
-    uiout->field_string ("file", symtab_to_filename_for_display (s));
-    uiout->field_string ("fullname", symtab_to_fullname (s));
+    mi_source_file file;
 
-    uiout->end (ui_out_type_tuple);
+    file.filename = symtab_to_filename_for_display (s);
+    file.fullname.emplace (symtab_to_fullname (s));
+    files.push_back (std::move (file));
   }
 
-  map_symbol_filenames (print_partial_file_name, NULL,
+  map_symbol_filenames (collect_partial_file_name, &files,
 			1 /*need_fullname*/);
 
-  uiout->end (ui_out_type_list);
+  /* With many source files the list gets large; send it out while it
+     is being formatted.  Finding the files reads symbols and can fail,
+     so it must all be done first.  */
+  mi_stream_result ();
+
+  ui_out_emit_list list_emitter (uiout, "files");
+  for (const mi_source_file &file : files)
+    {
+      ui_out_emit_tuple tuple_emitter (uiout, NULL);
+
+      uiout->field_string ("file", file.filename.c_str ());
+      if (file.fullname)
+	uiout->field_string ("fullname", file.fullname->c_str ());
+    }
 }
 
 /* See mi-cmds.h.  */
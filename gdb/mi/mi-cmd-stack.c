@@ -35,6 +35,7 @@
 #include <ctype.h>
 #include "mi-parse.h"
 #include "common/gdb_optional.h"
+#include "gdbthread.h"
 
 enum what_to_list { locals, arguments, all };
 
@@ -469,6 +470,161 @@ mi_cmd_stack_list_variables (const char *command, char **argv, int argc)
      }
 }
 
+/* Parse ARG, the WHAT argument of -stack-list-threads, as a
+   non-negative number.  */
+
+static int
+parse_stack_list_threads_number (const char *arg, const char *what)
+{
+  char *end;
+  long num;
+
+  errno = 0;
+  num = strtol (arg, &end, 10);
+  if (end == arg || *end != '\0' || num < 0 || num > INT_MAX || errno != 0)
+    error (_("-stack-list-threads: Invalid %s: %s"), what, arg);
+  return num;
+}
+
+/* Print, for each stopped thread, or for the threads whose global ids
+   are given, its innermost frames followed by the arguments and locals
+   of each of them.  This is what a front end needs after a stop, and
+   it is gathered with a single unwind of each thread, instead of the
+   one per command that -thread-info, -stack-list-frames and a
+   -stack-list-variables per frame would take.  Frame filters are not
+   applied.  */
+
+void
+mi_cmd_stack_list_threads (const char *command, char **argv, int argc)
+{
+  struct ui_out *uiout = current_uiout;
+  enum print_values print_values;
+  int max_frames = -1;
+  int skip_unavailable = 0;
+  int oind = 0;
+  enum opt
+  {
+    SKIP_UNAVAILABLE,
+    MAX_FRAMES,
+  };
+  static const struct mi_opt opts[] =
+    {
+      {"-skip-unavailable", SKIP_UNAVAILABLE, 0},
+      {"-max-frames", MAX_FRAMES, 1},
+      { 0, 0, 0 }
+    };
+
+  while (1)
+    {
+      char *oarg;
+      int opt = mi_getopt_allow_unknown ("-stack-list-threads", argc, argv,
+					 opts, &oind, &oarg);
+
+      if (opt < 0)
+	break;
+      switch ((enum opt) opt)
+	{
+	case SKIP_UNAVAILABLE:
+	  skip_unavailable = 1;
+	  break;
+	case MAX_FRAMES:
+	  max_frames = parse_stack_list_threads_number (oarg, "frame count");
+	  break;
+	}
+    }
+
+  if (argc - oind < 1)
+    error (_("-stack-list-threads: Usage: [--skip-unavailable] "
+	     "[--max-frames N] PRINT_VALUES [THREAD_ID...]"));
+
+  print_values = mi_parse_print_values (argv[oind]);
+
+  update_thread_list ();
+
+  std::vector<thread_info *> threads;
+  if (argc - oind > 1)
+    for (int i = oind + 1; i < argc; i++)
+      {
+	thread_info *tp
+	  = find_thread_global_id (parse_stack_list_threads_number
+				   (argv[i], "thread id"));
+
+	if (tp == NULL || tp->state == THREAD_EXITED)
+	  error (_("-stack-list-threads: Invalid thread id: %s"), argv[i]);
+	threads.push_back (tp);
+      }
+  else
+    {
+      thread_info *tp;
+
+      ALL_NON_EXITED_THREADS (tp)
+	threads.push_back (tp);
+    }
+
+  scoped_restore_current_thread restore_thread;
+  ui_out_emit_list threads_emitter (uiout, "threads");
+
+  for (thread_info *tp : threads)
+    {
+      ui_out_emit_tuple thread_emitter (uiout, "thread");
+
+      uiout->field_int ("id", tp->global_num);
+      uiout->field_string ("target-id", target_pid_to_str (tp->ptid));
+      if (tp->state == THREAD_RUNNING)
+	{
+	  uiout->field_string ("state", "running");
+	  continue;
+	}
+      uiout->field_string ("state", "stopped");
+
+      switch_to_thread (tp);
+
+      /* A thread that cannot be unwound gets an error field after
+	 whatever could be printed, instead of failing the whole
+	 command.  */
+      TRY
+	{
+	  /* Unwind once, and list the variables of the frames found.
+	     Reading the variables may flush the frame cache, so the
+	     frames are found again by id.  */
+	  std::vector<frame_id> frame_ids;
+	  {
+	    ui_out_emit_list list_emitter (uiout, "stack");
+	    struct frame_info *fi;
+	    int i;
+
+	    for (i = 0, fi = get_current_frame ();
+		 fi != NULL && (i < max_frames || max_frames < 0);
+		 i++, fi = get_prev_frame (fi))
+	      {
+		QUIT;
+		print_frame_info (fi, 1, LOC_AND_ADDRESS, 0 /* args */, 0);
+		frame_ids.push_back (get_frame_id (fi));
+	      }
+	  }
+
+	  ui_out_emit_list list_emitter (uiout, "stack-variables");
+	  for (int i = 0; i < (int) frame_ids.size (); i++)
+	    {
+	      QUIT;
+	      struct frame_info *fi = frame_find_by_id (frame_ids[i]);
+
+	      if (fi == NULL)
+		error (_("Could not find frame %d."), i);
+
+	      ui_out_emit_tuple tuple_emitter (uiout, "frame");
+	      uiout->field_int ("level", i);
+	      list_args_or_locals (all, print_values, fi, skip_unavailable);
+	    }
+	}
+      CATCH (except, RETURN_MASK_ERROR)
+	{
+	  uiout->field_string ("error", except.message);
+	}
+      END_CATCH
+    }
+}
+
 /* Print single local or argument.  ARG must be already read in.  For
    WHAT and VALUES see list_args_or_locals.
 
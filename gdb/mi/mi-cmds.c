@@ -138,6 +138,7 @@ static struct mi_cmd mi_cmds[] =
   DEF_MI_CMD_MI ("stack-list-arguments", mi_cmd_stack_list_args),
   DEF_MI_CMD_MI ("stack-list-frames", mi_cmd_stack_list_frames),
   DEF_MI_CMD_MI ("stack-list-locals", mi_cmd_stack_list_locals),
+  DEF_MI_CMD_MI ("stack-list-threads", mi_cmd_stack_list_threads),
   DEF_MI_CMD_MI ("stack-list-variables", mi_cmd_stack_list_variables),
   DEF_MI_CMD_MI_1 ("stack-select-frame", mi_cmd_stack_select_frame,
 		   &mi_suppress_notification.user_selected_context),
@@ -1473,6 +1473,10 @@ mi_cmd_data_read_memory_bytes (const char *command, char **argv, int argc)
   if (result.size () == 0)
     error (_("Unable to read memory."));
 
+  /* Everything was read; only formatting is left, so the (possibly
+     very large) result can be sent out as it is produced.  */
+  mi_stream_result ();
+
   ui_out_emit_list list_emitter (uiout, "memory");
   for (const memory_read_result &read_result : result)
     {
@@ -1819,11 +1823,17 @@ captured_mi_execute_command (struct ui_out *uiout, struct mi_parse *context)
 	 uiout will most likely crash in the mi_out_* routines.  */
       if (!running_result_record_printed)
 	{
-	  fputs_unfiltered (context->token, mi->raw_stdout);
-	  /* There's no particularly good reason why target-connect results
-	     in not ^done.  Should kill ^connected for MI3.  */
-	  fputs_unfiltered (strcmp (context->command, "target-select") == 0
-			    ? "^connected" : "^done", mi->raw_stdout);
+	  /* If the command streamed its result, the record's header
+	     went out with the first chunk.  */
+	  if (!mi_out_streamed (uiout))
+	    {
+	      fputs_unfiltered (context->token, mi->raw_stdout);
+	      /* There's no particularly good reason why target-connect
+		 results in not ^done.  Should kill ^connected for
+		 MI3.  */
+	      fputs_unfiltered (strcmp (context->command, "target-select") == 0
+				? "^connected" : "^done", mi->raw_stdout);
+	    }
 	  mi_out_put (uiout, mi->raw_stdout);
 	  mi_out_rewind (uiout);
 	  mi_print_timing_maybe (mi->raw_stdout);
@@ -1873,6 +1883,23 @@ captured_mi_execute_command (struct ui_out *uiout, struct mi_parse *context)
     }
 }
 
+/* See mi-main.h.  */
+
+void
+mi_stream_result (void)
+{
+  struct mi_interp *mi = dynamic_cast<mi_interp *> (command_interp ());
+
+  /* Only stream results of MI commands read from the input stream,
+     and only when they are built directly in the MI's own uiout.  */
+  if (current_token == NULL || mi == NULL || current_uiout != mi->mi_uiout)
+    return;
+
+  mi_ui_out *uiout = (mi_ui_out *) current_uiout;
+
+  uiout->stream_to (mi->raw_stdout, std::string (current_token) + "^done");
+}
+
 /* Print a gdb exception to the MI output stream.  */
 
 static void
@@ -1981,8 +2008,17 @@ mi_execute_command (const char *cmd, int from_tty)
 	  current_ui->prompt_state = PROMPT_NEEDED;
 
 	  /* The command execution failed and error() was called
-	     somewhere.  */
-	  mi_print_exception (command->token, result);
+	     somewhere.  If part of its result was already streamed out,
+	     that "^done" record is the command's result: terminate it,
+	     and report the error in a log record instead of a second
+	     result record.  */
+	  if (mi_out_streamed (current_uiout))
+	    {
+	      mi_out_abort_stream (current_uiout);
+	      exception_print (gdb_stderr, result);
+	    }
+	  else
+	    mi_print_exception (command->token, result);
 	  mi_out_rewind (current_uiout);
 	}
       END_CATCH
@@ -30,6 +30,15 @@ extern void mi_load_progress (const char *section_name,
 
 extern void mi_print_timing_maybe (struct ui_file *file);
 
+/* Let the result of the MI command being executed be written out
+   while it is being built, in bounded chunks, instead of all at once
+   when the command completes.  The result record's "^done" is sent
+   with the first chunk, so a command must only call this once it can
+   no longer fail.  If it fails anyway, the partial record is
+   terminated and the error is reported in a log stream record.  */
+
+extern void mi_stream_result (void);
+
 /* Whether MI is in async mode.  */
 
 extern int mi_async_p (void);
@@ -24,6 +24,11 @@
 #include "mi-out.h"
 #include <vector>
 
+/* How much of a streamed result may accumulate in the buffer before it
+   is written out.  */
+
+static const size_t mi_stream_chunk_size = 64 * 1024;
+
 /* Mark beginning of a table.  */
 
 void
@@ -122,6 +127,7 @@ mi_ui_out::do_field_string (int fldno, int width, ui_align align,
   if (string)
     fputstr_unfiltered (string, '"', stream);
   fprintf_unfiltered (stream, "\"");
+  maybe_stream ();
 }
 
 /* This is the only field function that does not align.  */
@@ -140,6 +146,7 @@ mi_ui_out::do_field_fmt (int fldno, int width, ui_align align,
     fputs_unfiltered ("\"", stream);
   vfprintf_unfiltered (stream, format, args);
   fputs_unfiltered ("\"", stream);
+  maybe_stream ();
 }
 
 void
@@ -212,6 +219,9 @@ mi_ui_out::open (const char *name, ui_out_type type)
     default:
       internal_error (__FILE__, __LINE__, _("bad switch"));
     }
+
+  if (m_streams.size () == 1)
+    m_open.push_back (type);
 }
 
 void
@@ -234,6 +244,39 @@ mi_ui_out::close (ui_out_type type)
     }
 
   m_suppress_field_separator = false;
+
+  if (m_streams.size () == 1)
+    {
+      if (!m_open.empty ())
+	m_open.pop_back ();
+      maybe_stream ();
+    }
+}
+
+/* If the result is being streamed and the buffer has grown past
+   MI_STREAM_CHUNK_SIZE, write it out.  Writing to the destination
+   blocks while the consumer is not reading, which keeps the buffer
+   bounded.  */
+
+void
+mi_ui_out::maybe_stream ()
+{
+  if (m_stream_dest == NULL || m_streams.size () != 1)
+    return;
+
+  string_file *mi_stream = main_stream ();
+
+  if (mi_stream->size () < mi_stream_chunk_size)
+    return;
+
+  if (!m_streamed)
+    {
+      fputs_unfiltered (m_stream_header.c_str (), m_stream_dest);
+      m_streamed = true;
+    }
+  m_stream_dest->write (mi_stream->data (), mi_stream->size ());
+  gdb_flush (m_stream_dest);
+  mi_stream->clear ();
 }
 
 string_file *
@@ -250,6 +293,36 @@ void
 mi_ui_out::rewind ()
 {
   main_stream ()->clear ();
+  m_stream_dest = NULL;
+  m_stream_header.clear ();
+  m_streamed = false;
+  m_open.clear ();
+}
+
+void
+mi_ui_out::stream_to (ui_file *dest, std::string &&header)
+{
+  m_stream_dest = dest;
+  m_stream_header = std::move (header);
+}
+
+void
+mi_ui_out::abort_stream ()
+{
+  if (!m_streamed)
+    return;
+
+  ui_file *dest = m_stream_dest;
+
+  put (dest);
+  while (!m_open.empty ())
+    {
+      fputc_unfiltered (m_open.back () == ui_out_type_tuple ? '}' : ']',
+			dest);
+      m_open.pop_back ();
+    }
+  fputs_unfiltered ("\n", dest);
+  rewind ();
 }
 
 /* Dump the buffer onto the specified stream.  */
@@ -324,3 +397,15 @@ mi_out_rewind (ui_out *uiout)
 {
   return as_mi_ui_out (uiout)->rewind ();
 }
+
+bool
+mi_out_streamed (ui_out *uiout)
+{
+  return as_mi_ui_out (uiout)->streamed ();
+}
+
+void
+mi_out_abort_stream (ui_out *uiout)
+{
+  as_mi_ui_out (uiout)->abort_stream ();
+}
@@ -20,6 +20,7 @@
 #ifndef MI_OUT_H
 #define MI_OUT_H 1
 
+#include <string>
 #include <vector>
 
 struct ui_out;
@@ -37,6 +38,23 @@ public:
   void rewind ();
   void put (struct ui_file *stream);
 
+  /* Start streaming the result being built to DEST.  Once the buffer
+     grows past a bound, HEADER (the record's token and result class)
+     is written to DEST, followed by the buffered output, and the
+     buffer is emptied; from then on the buffer is drained each time
+     it fills up again.  Streaming stops at the next rewind.  */
+  void stream_to (struct ui_file *dest, std::string &&header);
+
+  /* Return true if part of the current result was already written
+     out by streaming.  */
+  bool streamed () const
+  { return m_streamed; }
+
+  /* If part of the current result was already streamed out, write
+     the rest of the buffer, close any tuples and lists that are still
+     open, and terminate the record.  */
+  void abort_stream ();
+
   /* Return the version number of the current MI.  */
   int version ();
 
@@ -77,6 +95,7 @@ private:
   void field_separator ();
   void open (const char *name, ui_out_type type);
   void close (ui_out_type type);
+  void maybe_stream ();
 
   /* Convenience method that returns the MI out's string stream cast
      to its appropriate type.  Assumes/asserts that output was not
@@ -87,11 +106,26 @@ private:
   bool m_suppress_output;
   int m_mi_version;
   std::vector<ui_file *> m_streams;
+
+  /* Where the result is streamed to, or NULL if it is only written
+     out when the command completes.  */
+  ui_file *m_stream_dest = NULL;
+
+  /* The record header written before the first streamed chunk.  */
+  std::string m_stream_header;
+
+  /* Whether anything was streamed to M_STREAM_DEST yet.  */
+  bool m_streamed = false;
+
+  /* The tuples and lists currently open in the main stream.  */
+  std::vector<ui_out_type> m_open;
 };
 
 mi_ui_out *mi_out_new (int mi_version);
 int mi_version (ui_out *uiout);
 void mi_out_put (ui_out *uiout, struct ui_file *stream);
 void mi_out_rewind (ui_out *uiout);
+bool mi_out_streamed (ui_out *uiout);
+void mi_out_abort_stream (ui_out *uiout);
 
 #endif /* MI_OUT_H */
@@ -18,6 +18,7 @@
 
 #include "defs.h"
 #include "mi-cmds.h"
+#include "mi-main.h"
 #include "symtab.h"
 #include "objfiles.h"
 #include "ui-out.h"
@@ -50,6 +51,9 @@ mi_cmd_symbol_list_lines (const char *command, char **argv, int argc)
 
   gdbarch = get_objfile_arch (SYMTAB_OBJFILE (s));
 
+  /* The line table is already read in, and formatting it cannot
+     fail.  */
+  mi_stream_result ();
   ui_out_emit_list list_emitter (uiout, "lines");
   if (SYMTAB_LINETABLE (s) != NULL && SYMTAB_LINETABLE (s)->nitems > 0)
     for (i = 0; i < SYMTAB_LINETABLE (s)->nitems; i++)
@@ -28,7 +28,7 @@
 // compatibility issues
 //
 #define PDEBUG_PROTOVER_MAJOR				0x00000000
-#define PDEBUG_PROTOVER_MINOR				0x00000007
+#define PDEBUG_PROTOVER_MINOR				0x0000000A
 
 #include <stddef.h>
 
@@ -203,7 +203,7 @@ enum
 {
   DSMSG_RUN,
   DSMSG_RUN_COUNT,
-  DSMSG_RUN_RANGE,
+  DSMSG_RUN_RANGE,		/* Step while addr[0] <= pc < addr[1] (protover 0.10+).  */
 };
 
 enum
@@ -245,6 +245,8 @@ enum
   DSMSG_BRK_WRM = 0x000c,	/* Write access if suported otherwise modified.  */
   DSMSG_BRK_RWM = 0x000e,	/* Read or write access if suported otherwise modified.  */
   DSMSG_BRK_HW = 0x0010,	/* Only use hardware debugging (i.e. no singlestep).  */
+  DSMSG_BRK_LIST = 0x0020,	/* DStMsg_brklist_t request (protover 0.8+).  */
+  DSMSG_BRK_AGENT = 0x0040,	/* DStMsg_brkagent_t request (protover 0.9+).  */
 };
 
 enum
@@ -355,6 +357,35 @@ typedef struct
   uint16_t size;
 } DStMsg_memrd_t;
 
+enum
+{
+  DSMSG_MEMRD_LIST = 0x0001,	/* DStMsg_memrdlist_t request (protover 0.11+).  */
+};
+
+/* Memory read list (protover 0.11+).  Sent with subcmd
+   DSMSG_MEMRD_LIST to read several ranges in one round trip.  The
+   entries are read in order, and the response is a DSrMsg_okdata
+   holding their contents back to back.  Reading stops at the first
+   entry that can not be read entirely; the response then holds only
+   the entries before it.  The entries must add up to no more than
+   DS_DATA_MAX_SIZE bytes.  */
+struct dsmemrdentry
+{
+  uint64_t addr;
+  uint32_t size;
+  uint32_t spare0;
+};
+
+#define DSMSG_MEMRD_LIST_MAX \
+  ((DS_DATA_MAX_SIZE - 8) / sizeof (struct dsmemrdentry))
+
+typedef struct
+{
+  struct DShdr hdr;
+  uint32_t count;
+  struct dsmemrdentry entry[DSMSG_MEMRD_LIST_MAX];
+} DStMsg_memrdlist_t;
+
 
 /* Memory write request.  */
 typedef struct
@@ -384,7 +415,14 @@ typedef struct
 } DStMsg_regwr_t;
 
 
-/* Run.  */
+/* Run.  With DSMSG_RUN_COUNT, the current thread single-steps COUNT
+   instructions.  With DSMSG_RUN_RANGE, it keeps single-stepping while
+   its pc is within [ADDR[0], ADDR[1]), and a DSMSG_NOTIFY_STEP is sent
+   once it leaves the range.  Signals are reported as usual in the
+   meantime.  So are breakpoints, except that the thread stops before
+   executing the breakpoint instruction: the DSMSG_NOTIFY_BRK ip, like
+   the thread's pc, is the breakpoint address, as GDB expects when
+   stepping.  */
 typedef struct
 {
   struct DShdr hdr;
@@ -421,6 +459,56 @@ typedef struct
   uint64_t addr;
 } DStMsg_brk_t;
 
+/* Break list (protover 0.8+).  Sent with subcmd DSMSG_BRK_LIST to set
+   or clear several breakpoints in one round trip.  Each entry is
+   handled like a DStMsg_brk with the entry's subcmd, in order, and
+   processing stops at the first entry that fails.  The response is a
+   DSrMsg_okstatus whose status is the number of entries handled
+   successfully.  Breakpoints set by an agent implementing this
+   message are not visible in DStMsg_memrd replies.  With protover
+   0.9+, an entry whose subcmd includes DSMSG_BRK_AGENT sets or updates
+   the breakpoint like a DStMsg_brkagent_t without expressions.  */
+struct dsbrkentry
+{
+  uint64_t addr;
+  int32_t size;			/* -1 clears the breakpoint.  */
+  uint32_t subcmd;		/* DSMSG_BRK_* flags.  */
+};
+
+#define DSMSG_BRK_LIST_MAX \
+  ((DS_DATA_MAX_SIZE - 8) / sizeof (struct dsbrkentry))
+
+typedef struct
+{
+  struct DShdr hdr;
+  uint32_t count;
+  struct dsbrkentry entry[DSMSG_BRK_LIST_MAX];
+} DStMsg_brklist_t;
+
+/* Break with agent expressions (protover 0.9+).  Sent with subcmd
+   DSMSG_BRK_AGENT | DSMSG_BRK_EXEC to set an execution breakpoint at
+   ADDR, or update the one already set there, and replace the agent
+   expressions attached to it.  DATA holds NCOND condition expressions
+   followed by NCMD command expressions, each a 16-bit length followed
+   by that many bytes of agent bytecode, as evaluated by gdbserver.
+   When the breakpoint is hit the agent evaluates the conditions; if
+   there are some and none is true, the thread resumes without
+   notifying the host.  Otherwise the commands, if any, are run and the
+   thread resumes; a breakpoint without commands stops and notifies the
+   host as usual.  PERSIST is non-zero if the commands
+   should keep running after the host disconnects.  Clearing the
+   breakpoint with DStMsg_brk drops its expressions.  */
+typedef struct
+{
+  struct DShdr hdr;
+  uint32_t size;
+  uint64_t addr;
+  uint16_t ncond;
+  uint16_t ncmd;
+  uint32_t persist;
+  uint8_t data[DS_DATA_MAX_SIZE - 24];
+} DStMsg_brkagent_t;
+
 /* Open a file on the target.  */
 typedef struct
 {
@@ -736,6 +824,7 @@ typedef union
   DStMsg_kill_t kill;
   DStMsg_stop_t stop;
   DStMsg_memrd_t memrd;
+  DStMsg_memrdlist_t memrdlist;
   DStMsg_memwr_t memwr;
   DStMsg_regrd_t regrd;
   DStMsg_regwr_t regwr;
@@ -743,6 +832,8 @@ typedef union
   DStMsg_run_t run;
   DStMsg32_brk_t brk32;
   DStMsg_brk_t brk;
+  DStMsg_brklist_t brklist;
+  DStMsg_brkagent_t brkagent;
   DStMsg_fileopen_t fileopen;
   DStMsg_filerd_t filerd;
   DStMsg_filewr_t filewr;
@@ -37,6 +37,7 @@
 #include "gdbcmd.h"
 #include <algorithm>
 #include <set>
+#include <unordered_set>
 
 struct psymbol_bcache
 {
@@ -1385,6 +1386,223 @@ recursively_search_psymtabs
   return result == PST_SEARCHED_AND_FOUND;
 }
 
+/* One entry of a psymtab_name_index: a point in the search name of
+   a partial symbol at which a match can start.  */
+
+struct psymtab_name_component
+{
+  /* The rest of the name, from the component on.  */
+  const char *name;
+
+  /* The psymtab the symbol belongs to.  */
+  struct partial_symtab *psymtab;
+
+  bool operator< (const psymtab_name_component &other) const
+  {
+    return strcmp (name, other.name) < 0;
+  }
+};
+
+/* A sorted index of the names of an objfile's partial symbols, used
+   to find the psymtabs that may hold completions for a name without
+   matching every partial symbol against it.  Each name is entered
+   once as a whole, and once for each "::"-separated component after
+   the first, since C++ wild matching can match there.  */
+
+struct psymtab_name_index
+{
+  /* The number of partial symbols the index was built from; the index
+     is rebuilt if more are read.  */
+  size_t n_psymbols = 0;
+
+  /* Whether any partial symbol is of a language whose name matching
+     this index cannot narrow down, e.g. one that ignores case.  */
+  bool usable = true;
+
+  /* The components, sorted by name.  */
+  std::vector<psymtab_name_component> components;
+};
+
+/* The key for the psymtab_name_index of an objfile.  */
+
+static const struct objfile_data *psymtab_name_index_key;
+
+/* The objfile_data cleanup for psymtab_name_index_key.  */
+
+static void
+psymtab_name_index_free (struct objfile *objfile, void *arg)
+{
+  delete (struct psymtab_name_index *) arg;
+}
+
+/* Return whether names in LANGUAGE only match lookup names made of
+   identifier characters where the index has an entry: at the start
+   of the name or of a "::"-separated component, comparing case.  */
+
+static bool
+psymtab_name_index_language_p (enum language language)
+{
+  switch (language)
+    {
+    case language_c:
+    case language_cplus:
+    case language_objc:
+    case language_opencl:
+    case language_d:
+    case language_go:
+    case language_rust:
+    case language_asm:
+    case language_minimal:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* Add the search names of the COUNT partial symbols at PSYMS, which
+   belong to PS, to INDEX.  */
+
+static void
+psymtab_name_index_add (struct psymtab_name_index *index,
+			struct partial_symtab *ps,
+			partial_symbol **psyms, int count)
+{
+  for (int i = 0; i < count; ++i)
+    {
+      partial_symbol *psym = psyms[i];
+
+      if (!psymtab_name_index_language_p (SYMBOL_LANGUAGE (psym)))
+	{
+	  index->usable = false;
+	  return;
+	}
+
+      const char *name = SYMBOL_SEARCH_NAME (psym);
+
+      while (1)
+	{
+	  name = skip_spaces (name);
+	  index->components.push_back ({name, ps});
+
+	  name = strstr (name, "::");
+	  if (name == NULL)
+	    break;
+	  name += 2;
+	}
+    }
+}
+
+/* Return the name index of OBJFILE, building it if needed.  */
+
+static struct psymtab_name_index *
+get_psymtab_name_index (struct objfile *objfile)
+{
+  struct psymtab_name_index *index
+    = (struct psymtab_name_index *) objfile_data (objfile,
+						  psymtab_name_index_key);
+  size_t n_psymbols = (objfile->global_psymbols.size ()
+		       + objfile->static_psymbols.size ());
+
+  if (index != NULL && index->n_psymbols == n_psymbols)
+    return index;
+
+  if (index == NULL)
+    {
+      index = new psymtab_name_index;
+      set_objfile_data (objfile, psymtab_name_index_key, index);
+    }
+
+  struct partial_symtab *ps;
+
+  index->n_psymbols = n_psymbols;
+  index->usable = true;
+  index->components.clear ();
+  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+    {
+      psymtab_name_index_add (index, ps,
+			      (objfile->global_psymbols.data ()
+			       + ps->globals_offset),
+			      ps->n_global_syms);
+      if (index->usable)
+	psymtab_name_index_add (index, ps,
+				(objfile->static_psymbols.data ()
+				 + ps->statics_offset),
+				ps->n_static_syms);
+      if (!index->usable)
+	break;
+    }
+
+  if (index->usable)
+    std::sort (index->components.begin (), index->components.end ());
+  else
+    index->components.clear ();
+  index->components.shrink_to_fit ();
+
+  return index;
+}
+
+/* If the psymtabs of OBJFILE that may have symbols matching
+   LOOKUP_NAME can be found with its name index, store them in
+   CANDIDATES and return true.  Otherwise return false; every psymtab
+   must then be searched.
+
+   This is only done when completing, where the lookup name is a
+   prefix that is typically short and matches few of the names.  A
+   name only made of identifier characters can only match, with case
+   compared, at a point the index has an entry for.  */
+
+static bool
+psymtab_name_index_candidates
+  (struct objfile *objfile, const lookup_name_info &lookup_name,
+   std::unordered_set<struct partial_symtab *> *candidates)
+{
+  const std::string &name = lookup_name.name ();
+
+  if (!lookup_name.completion_mode ()
+      || lookup_name.match_type () == symbol_name_match_type::SEARCH_NAME
+      || name.empty ()
+      || case_sensitivity != case_sensitive_on)
+    return false;
+
+  for (char c : name)
+    if (!isalnum ((unsigned char) c) && c != '_')
+      return false;
+
+  struct psymtab_name_index *index = get_psymtab_name_index (objfile);
+  if (!index->usable)
+    return false;
+
+  psymtab_name_component key = {name.c_str (), NULL};
+  auto iter = std::lower_bound (index->components.begin (),
+				index->components.end (), key);
+  for (; (iter != index->components.end ()
+	  && strncmp (iter->name, name.c_str (), name.size ()) == 0);
+       ++iter)
+    candidates->insert (iter->psymtab);
+
+  return true;
+}
+
+/* Return whether PS, or one of the shared psymtabs it includes, is in
+   CANDIDATES.  This follows the dependencies the same way
+   recursively_search_psymtabs does.  */
+
+static bool
+psymtab_is_candidate
+  (struct partial_symtab *ps,
+   const std::unordered_set<struct partial_symtab *> &candidates)
+{
+  if (candidates.find (ps) != candidates.end ())
+    return true;
+
+  for (int i = 0; i < ps->number_of_dependencies; ++i)
+    if (ps->dependencies[i]->user != NULL
+	&& psymtab_is_candidate (ps->dependencies[i], candidates))
+      return true;
+
+  return false;
+}
+
 /* Psymtab version of expand_symtabs_matching.  See its definition in
    the definition of quick_symbol_functions in symfile.h.  */
 
@@ -1407,6 +1625,10 @@ psym_expand_symtabs_matching
       ps->searched_flag = PST_NOT_SEARCHED;
     }
 
+  std::unordered_set<struct partial_symtab *> candidates;
+  bool use_candidates = psymtab_name_index_candidates (objfile, lookup_name,
+						       &candidates);
+
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
     {
       QUIT;
@@ -1419,6 +1641,9 @@ psym_expand_symtabs_matching
       if (ps->user != NULL)
 	continue;
 
+      if (use_candidates && !psymtab_is_candidate (ps, candidates))
+	continue;
+
       if (file_matcher)
 	{
 	  bool match;
@@ -2304,6 +2529,9 @@ maintenance_check_psymtabs (const char *ignore, int from_tty)
 void
 _initialize_psymtab (void)
 {
+  psymtab_name_index_key
+    = register_objfile_data_with_cleanup (NULL, psymtab_name_index_free);
+
   add_cmd ("psymbols", class_maintenance, maintenance_print_psymbols, _("\
 Print dump of current partial symbol definitions.\n\
 Usage: mt print psymbols [-objfile objfile] [-pc address] [--] [outfile]\n\
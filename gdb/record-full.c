@@ -40,6 +40,10 @@
 #include "common/byte-vector.h"
 
 #include <signal.h>
+#include <deque>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 /* This module implements "target record-full", also known as "process
    record and replay".  This target sits on top of a "normal" target
@@ -66,7 +70,12 @@
 #define RECORD_FULL_IS_REPLAY \
   (record_full_list->next || ::execution_direction == EXEC_REVERSE)
 
-#define RECORD_FULL_FILE_MAGIC	netorder32(0x20091016)
+#define RECORD_FULL_FILE_MAGIC	0x20181016
+#define RECORD_FULL_FILE_MAGIC_V2	0x20091016
+
+/* Record types of delta entries in a version 3 log file.  */
+#define RECORD_FULL_FILE_REG_DELTA	3
+#define RECORD_FULL_FILE_MEM_DELTA	4
 
 /* These are the core structs of the process record functionality.
 
@@ -85,23 +94,25 @@ struct record_full_mem_entry
   int len;
   /* Set this flag if target memory for this entry
      can no longer be accessed.  */
-  int mem_entry_not_accessible;
-  union
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[sizeof (gdb_byte *)];
-  } u;
+  unsigned char mem_entry_not_accessible;
+  /* Set if the entry holds a delta; see record_full_encode_last_insn.  */
+  unsigned char delta;
 };
 
+/* Deltas of up to this many bytes are kept in the reg entry itself.  */
+#define RECORD_FULL_REG_DELTA_INLINE 8
+
 struct record_full_reg_entry
 {
   unsigned short num;
   unsigned short len;
-  union 
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[2 * sizeof (gdb_byte *)];
-  } u;
+  /* Set if the entry holds a delta; see record_full_encode_last_insn.
+     The delta then covers DELTA_LEN bytes of the register from
+     DELTA_OFFSET on.  */
+  unsigned char delta;
+  unsigned char delta_offset;
+  unsigned char delta_len;
+  gdb_byte delta_inline[RECORD_FULL_REG_DELTA_INLINE];
 };
 
 struct record_full_end_entry
@@ -139,7 +150,13 @@ enum record_full_type
    executing the instruction (including the PC in every case).  It 
    will also have one "mem" entry for each memory change.  Finally,
    each instruction will have an "end" entry that separates it from
-   the changes associated with the next instruction.  */
+   the changes associated with the next instruction.
+
+   The saved contents of a "reg" or "mem" entry immediately follow the
+   entry itself; see record_full_get_loc.  Once an instruction has been
+   executed, its entries hold the XOR of the values before and after it
+   instead, and only for the bytes that changed; see
+   record_full_encode_last_insn.  */
 
 struct record_full_entry
 {
@@ -379,6 +396,275 @@ static struct cmd_list_element *record_full_cmdlist;
 static void record_full_goto_insn (struct record_full_entry *entry,
 				   enum exec_direction_kind dir);
 
+/* The execution log is carved out of large chunks of memory instead
+   of being allocated one entry at a time: allocating an entry, along
+   with the register or memory contents that follow it, is a pointer
+   bump.
+
+   Entries are released either from the front of the log (when it is
+   full) or from its end (when it is truncated, or when an instruction
+   fails to record), so a chunk only has to count its live entries,
+   and is given back as soon as that count drops to zero.  Once the
+   log has grown past "record full spill-threshold", new chunks are
+   mapped from an unlinked temporary file so that the kernel can page
+   an old recording out instead of keeping it all in anonymous
+   memory.  */
+
+#define RECORD_FULL_CHUNK_SIZE (256 * 1024)
+
+struct record_full_chunk
+{
+  /* Start of the chunk's memory.  */
+  gdb_byte *data;
+
+  /* Number of bytes at DATA.  */
+  size_t size;
+
+  /* Number of bytes handed out so far.  */
+  size_t used;
+
+  /* Number of entries in this chunk that have not been released.  */
+  size_t live;
+
+  /* Offset of the chunk in the spill file, or -1 if it was allocated
+     from the heap.  */
+  off_t spill_offset;
+};
+
+static std::deque<record_full_chunk> record_full_chunks;
+
+/* Total size of the chunks in record_full_chunks.  */
+static ULONGEST record_full_arena_size;
+
+/* Size, in megabytes, past which new chunks are mapped from the spill
+   file.  UINT_MAX means never.  */
+static unsigned int record_full_spill_threshold = UINT_MAX;
+
+/* The spill file, its size, its unused chunk-sized slots, and the
+   number of chunks currently mapped from it.  */
+static int record_full_spill_fd = -1;
+static off_t record_full_spill_size;
+static std::vector<off_t> record_full_spill_slots;
+static unsigned int record_full_spill_chunks;
+
+#ifdef HAVE_SYS_MMAN_H
+
+/* Map a RECORD_FULL_CHUNK_SIZE chunk from the spill file, creating it
+   if needed.  Store the chunk's offset in *OFFSET.  Return NULL, after
+   warning, if that cannot be done.  */
+
+static gdb_byte *
+record_full_spill_map (off_t *offset)
+{
+  if (record_full_spill_fd < 0)
+    {
+      const char *tmpdir = getenv ("TMPDIR");
+      std::string name = string_printf ("%s/gdb-record-XXXXXX",
+					tmpdir != NULL ? tmpdir : "/tmp");
+
+      record_full_spill_fd = mkstemp (&name[0]);
+      if (record_full_spill_fd < 0)
+	{
+	  warning (_("Process record: cannot create spill file %s: %s"),
+		   name.c_str (), safe_strerror (errno));
+	  return NULL;
+	}
+      unlink (name.c_str ());
+      record_full_spill_size = 0;
+      record_full_spill_slots.clear ();
+    }
+
+  if (!record_full_spill_slots.empty ())
+    {
+      *offset = record_full_spill_slots.back ();
+      record_full_spill_slots.pop_back ();
+    }
+  else
+    {
+      if (ftruncate (record_full_spill_fd,
+		     record_full_spill_size + RECORD_FULL_CHUNK_SIZE) != 0)
+	{
+	  warning (_("Process record: cannot grow spill file: %s"),
+		   safe_strerror (errno));
+	  return NULL;
+	}
+      *offset = record_full_spill_size;
+      record_full_spill_size += RECORD_FULL_CHUNK_SIZE;
+    }
+
+  void *data = mmap (NULL, RECORD_FULL_CHUNK_SIZE, PROT_READ | PROT_WRITE,
+		     MAP_SHARED, record_full_spill_fd, *offset);
+  if (data == MAP_FAILED)
+    {
+      warning (_("Process record: cannot map spill file: %s"),
+	       safe_strerror (errno));
+      record_full_spill_slots.push_back (*offset);
+      return NULL;
+    }
+
+  record_full_spill_chunks++;
+  return (gdb_byte *) data;
+}
+
+#endif /* HAVE_SYS_MMAN_H */
+
+/* Return a new, empty chunk of at least SIZE bytes.  */
+
+static record_full_chunk
+record_full_chunk_new (size_t size)
+{
+  record_full_chunk chunk;
+
+  chunk.size = std::max (size, (size_t) RECORD_FULL_CHUNK_SIZE);
+  chunk.used = 0;
+  chunk.live = 0;
+  chunk.spill_offset = -1;
+  chunk.data = NULL;
+
+#ifdef HAVE_SYS_MMAN_H
+  if (chunk.size == RECORD_FULL_CHUNK_SIZE
+      && record_full_spill_threshold != UINT_MAX
+      && (record_full_arena_size
+	  >= (ULONGEST) record_full_spill_threshold << 20))
+    chunk.data = record_full_spill_map (&chunk.spill_offset);
+#endif
+
+  if (chunk.data == NULL)
+    chunk.data = (gdb_byte *) xmalloc (chunk.size);
+
+  record_full_arena_size += chunk.size;
+  return chunk;
+}
+
+/* Give the memory of CHUNK back.  */
+
+static void
+record_full_chunk_free (const record_full_chunk &chunk)
+{
+  record_full_arena_size -= chunk.size;
+
+#ifdef HAVE_SYS_MMAN_H
+  if (chunk.spill_offset >= 0)
+    {
+      munmap (chunk.data, chunk.size);
+      record_full_spill_slots.push_back (chunk.spill_offset);
+
+      /* Drop the file altogether once nothing lives in it.  */
+      if (--record_full_spill_chunks == 0)
+	{
+	  close (record_full_spill_fd);
+	  record_full_spill_fd = -1;
+	}
+      return;
+    }
+#endif
+
+  xfree (chunk.data);
+}
+
+/* Return the number of bytes of contents following REC.  */
+
+static inline size_t
+record_full_contents_len (const struct record_full_entry *rec)
+{
+  if (rec->type == record_full_reg)
+    {
+      if (!rec->u.reg.delta)
+	return rec->u.reg.len;
+      if (rec->u.reg.delta_len > RECORD_FULL_REG_DELTA_INLINE)
+	return rec->u.reg.delta_len;
+    }
+  else if (rec->type == record_full_mem)
+    return rec->u.mem.len;
+
+  return 0;
+}
+
+/* Return the number of arena bytes taken by REC and its contents.  */
+
+static inline size_t
+record_full_entry_size (const struct record_full_entry *rec)
+{
+  return align_up (sizeof (struct record_full_entry)
+		   + record_full_contents_len (rec),
+		   alignof (struct record_full_entry));
+}
+
+/* Allocate a cleared record entry of type TYPE, followed by LEN bytes
+   for its contents.  */
+
+static struct record_full_entry *
+record_full_entry_alloc (enum record_full_type type, size_t len)
+{
+  size_t size = align_up (sizeof (struct record_full_entry) + len,
+			  alignof (struct record_full_entry));
+
+  /* An emptied chunk that is too small for this entry is of no use.  */
+  if (!record_full_chunks.empty ()
+      && record_full_chunks.back ().live == 0
+      && record_full_chunks.back ().size < size)
+    {
+      record_full_chunk_free (record_full_chunks.back ());
+      record_full_chunks.pop_back ();
+    }
+
+  if (record_full_chunks.empty ()
+      || (record_full_chunks.back ().size - record_full_chunks.back ().used
+	  < size))
+    record_full_chunks.push_back (record_full_chunk_new (size));
+
+  record_full_chunk &chunk = record_full_chunks.back ();
+  struct record_full_entry *rec
+    = (struct record_full_entry *) (chunk.data + chunk.used);
+
+  chunk.used += size;
+  chunk.live++;
+
+  memset (rec, 0, sizeof (*rec));
+  rec->type = type;
+  return rec;
+}
+
+/* Release REC back to the arena.  */
+
+static void
+record_full_entry_free (struct record_full_entry *rec)
+{
+  gdb_byte *p = (gdb_byte *) rec;
+  size_t size = record_full_entry_size (rec);
+  auto contains = [=] (const record_full_chunk &chunk)
+    {
+      return p >= chunk.data && p < chunk.data + chunk.used;
+    };
+
+  /* REC almost always comes from the newest or the oldest chunk.  */
+  auto it = record_full_chunks.end () - 1;
+  if (!contains (*it))
+    {
+      it = record_full_chunks.begin ();
+      while (!contains (*it))
+	{
+	  ++it;
+	  gdb_assert (it != record_full_chunks.end ());
+	}
+    }
+
+  /* Rewinding the end of the log gives the space back right away.  */
+  if (p + size == it->data + it->used)
+    it->used -= size;
+
+  if (--it->live == 0)
+    {
+      if (record_full_chunks.size () == 1)
+	it->used = 0;
+      else
+	{
+	  record_full_chunk_free (*it);
+	  record_full_chunks.erase (it);
+	}
+    }
+}
+
 /* Alloc and free functions for record_full_reg, record_full_mem, and
    record_full_end entries.  */
 
@@ -389,13 +675,31 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
 {
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = regcache->arch ();
+  int len = register_size (gdbarch, regnum);
+
+  rec = record_full_entry_alloc (record_full_reg, len);
+  rec->u.reg.num = regnum;
+  rec->u.reg.len = len;
+
+  return rec;
+}
+
+/* Alloc a record_full_reg record entry holding a delta of LEN bytes,
+   from OFFSET on in register REGNUM of REG_LEN bytes.  */
+
+static inline struct record_full_entry *
+record_full_reg_delta_alloc (int regnum, int reg_len, int offset, int len)
+{
+  struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_reg;
+  rec = record_full_entry_alloc (record_full_reg,
+				 (len > RECORD_FULL_REG_DELTA_INLINE
+				  ? len : 0));
   rec->u.reg.num = regnum;
-  rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+  rec->u.reg.len = reg_len;
+  rec->u.reg.delta = 1;
+  rec->u.reg.delta_offset = offset;
+  rec->u.reg.delta_len = len;
 
   return rec;
 }
@@ -406,9 +710,7 @@ static inline void
 record_full_reg_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -418,12 +720,9 @@ record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_mem;
+  rec = record_full_entry_alloc (record_full_mem, len);
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
 
   return rec;
 }
@@ -434,9 +733,7 @@ static inline void
 record_full_mem_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -444,12 +741,7 @@ record_full_mem_release (struct record_full_entry *rec)
 static inline struct record_full_entry *
 record_full_end_alloc (void)
 {
-  struct record_full_entry *rec;
-
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_end;
-
-  return rec;
+  return record_full_entry_alloc (record_full_end, 0);
 }
 
 /* Free a record_full_end record entry.  */
@@ -457,7 +749,7 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Free one record entry, any type.
@@ -589,16 +881,13 @@ static inline gdb_byte *
 record_full_get_loc (struct record_full_entry *rec)
 {
   switch (rec->type) {
-  case record_full_mem:
-    if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-      return rec->u.mem.u.ptr;
-    else
-      return rec->u.mem.u.buf;
   case record_full_reg:
-    if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-      return rec->u.reg.u.ptr;
-    else
-      return rec->u.reg.u.buf;
+    if (rec->u.reg.delta
+	&& rec->u.reg.delta_len <= RECORD_FULL_REG_DELTA_INLINE)
+      return rec->u.reg.delta_inline;
+    /* Fall through.  */
+  case record_full_mem:
+    return (gdb_byte *) (rec + 1);
   case record_full_end:
   default:
     gdb_assert_not_reached ("unexpected record_full_entry type");
@@ -680,6 +969,156 @@ record_full_arch_list_add_end (void)
   return 0;
 }
 
+/* The thread that ran the last instruction in the log, while the
+   registers and memory it changed are still as it left them.  */
+static ptid_t record_full_last_insn_ptid = ptid_t::make_null ();
+
+/* Scratch space for record_full_encode_last_insn.  */
+static gdb::byte_vector record_full_encode_buf;
+
+/* Append to record_full_encode_buf at *USED a copy of the entry HDR.
+   Its contents are the bytes at DATA if that is not NULL, and those
+   following HDR otherwise.  */
+
+static void
+record_full_encode_add (size_t *used, const struct record_full_entry *hdr,
+			const gdb_byte *data)
+{
+  size_t size = record_full_entry_size (hdr);
+
+  record_full_encode_buf.resize (*used + size);
+  struct record_full_entry *rec
+    = (struct record_full_entry *) (record_full_encode_buf.data () + *used);
+  if (data == NULL)
+    memcpy (rec, hdr, size);
+  else
+    {
+      memcpy (rec, hdr, sizeof (*rec));
+      memcpy (record_full_get_loc (rec), data,
+	      (rec->type == record_full_reg
+	       ? rec->u.reg.delta_len : rec->u.mem.len));
+    }
+  *used += size;
+}
+
+/* Delta-encode the entries of the last instruction in the log, which
+   REGCACHE's thread is about to run past.
+
+   Until then, a "reg" or "mem" entry holds the whole value that
+   replaying it swaps with the live one.  Once the instruction has run,
+   the live values are those it left behind, and the entry can hold the
+   XOR of the values before and after it instead: replaying the entry
+   XORs it into the live value, whatever the direction.  That only
+   needs the bytes that changed, and nothing at all for the registers
+   the instruction was recorded as changing but left alone, such as
+   flags that happened to keep their value.  */
+
+static void
+record_full_encode_last_insn (struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = regcache->arch ();
+  struct record_full_entry *first, *rec, *prev;
+  bool raw = false;
+
+  if (record_full_list == &record_full_first
+      || record_full_last_insn_ptid != regcache->ptid ())
+    return;
+  record_full_last_insn_ptid = ptid_t::make_null ();
+  gdb_assert (record_full_list->type == record_full_end);
+
+  for (first = record_full_list;
+       first->prev != &record_full_first
+	 && first->prev->type != record_full_end;
+       first = first->prev)
+    if ((first->prev->type == record_full_reg && !first->prev->u.reg.delta)
+	|| (first->prev->type == record_full_mem && !first->prev->u.mem.delta
+	    && !first->prev->u.mem.mem_entry_not_accessible))
+      raw = true;
+  if (!raw)
+    return;
+
+  /* Lay out the new entries in the scratch buffer first, so that the
+     old ones can go back to the end of the arena before the new ones
+     are allocated there.  */
+  size_t used = 0;
+  gdb::byte_vector live;
+  for (rec = first; rec != record_full_list; rec = rec->next)
+    {
+      struct record_full_entry hdr = *rec;
+      bool read = false;
+      size_t lo, hi;
+
+      if (rec->type == record_full_reg && !rec->u.reg.delta
+	  && rec->u.reg.len <= UCHAR_MAX)
+	{
+	  live.resize (rec->u.reg.len);
+	  read = (regcache->raw_read (rec->u.reg.num, live.data ())
+		  == REG_VALID);
+	}
+      else if (rec->type == record_full_mem && !rec->u.mem.delta
+	       && !rec->u.mem.mem_entry_not_accessible)
+	{
+	  live.resize (rec->u.mem.len);
+	  read = !record_read_memory (gdbarch, rec->u.mem.addr, live.data (),
+				      rec->u.mem.len);
+	}
+      if (!read)
+	{
+	  record_full_encode_add (&used, rec, NULL);
+	  continue;
+	}
+
+      /* Keep the bytes that changed, if any.  */
+      for (size_t i = 0; i < live.size (); i++)
+	live[i] ^= record_full_get_loc (rec)[i];
+      for (lo = 0; lo < live.size () && live[lo] == 0; lo++)
+	;
+      if (lo == live.size ())
+	continue;
+      for (hi = live.size (); live[hi - 1] == 0; hi--)
+	;
+
+      if (rec->type == record_full_reg)
+	{
+	  hdr.u.reg.delta = 1;
+	  hdr.u.reg.delta_offset = lo;
+	  hdr.u.reg.delta_len = hi - lo;
+	}
+      else
+	{
+	  hdr.u.mem.delta = 1;
+	  hdr.u.mem.addr += lo;
+	  hdr.u.mem.len = hi - lo;
+	}
+      record_full_encode_add (&used, &hdr, live.data () + lo);
+    }
+  record_full_encode_add (&used, record_full_list, NULL);
+
+  /* Replace the entries.  */
+  prev = first->prev;
+  for (rec = record_full_list; rec != prev; rec = first)
+    {
+      first = rec->prev;
+      record_full_entry_release (rec);
+    }
+  for (size_t offset = 0; offset < used; )
+    {
+      const struct record_full_entry *hdr
+	= ((const struct record_full_entry *)
+	   (record_full_encode_buf.data () + offset));
+      size_t size = record_full_entry_size (hdr);
+
+      rec = record_full_entry_alloc (hdr->type, record_full_contents_len (hdr));
+      memcpy (rec, hdr, size);
+      rec->prev = prev;
+      rec->next = NULL;
+      prev->next = rec;
+      prev = rec;
+      offset += size;
+    }
+  record_full_list = prev;
+}
+
 static void
 record_full_check_insn_num (void)
 {
@@ -711,6 +1150,8 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
 
   TRY
     {
+      record_full_encode_last_insn (regcache);
+
       record_full_arch_list_head = NULL;
       record_full_arch_list_tail = NULL;
 
@@ -772,6 +1213,7 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
   record_full_list->next = record_full_arch_list_head;
   record_full_arch_list_head->prev = record_full_list;
   record_full_list = record_full_arch_list_tail;
+  record_full_last_insn_ptid = regcache->ptid ();
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -835,6 +1277,17 @@ record_full_exec_insn (struct regcache *regcache,
                               entry->u.reg.num);
 
         regcache->cooked_read (entry->u.reg.num, reg.data ());
+
+	/* A delta is XORed into the register, and stays as it is.  */
+	if (entry->u.reg.delta)
+	  {
+	    const gdb_byte *delta = record_full_get_loc (entry);
+
+	    for (int i = 0; i < entry->u.reg.delta_len; i++)
+	      reg[entry->u.reg.delta_offset + i] ^= delta[i];
+	    regcache->cooked_write (entry->u.reg.num, reg.data ());
+	    break;
+	  }
         regcache->cooked_write (entry->u.reg.num, record_full_get_loc (entry));
         memcpy (record_full_get_loc (entry), reg.data (), entry->u.reg.len);
       }
@@ -861,8 +1314,16 @@ record_full_exec_insn (struct regcache *regcache,
 	      entry->u.mem.mem_entry_not_accessible = 1;
             else
               {
-                if (target_write_memory (entry->u.mem.addr, 
-					 record_full_get_loc (entry),
+		/* Likewise for a delta of memory.  */
+		const gdb_byte *val = record_full_get_loc (entry);
+		if (entry->u.mem.delta)
+		  {
+		    for (int i = 0; i < entry->u.mem.len; i++)
+		      mem[i] ^= val[i];
+		    val = mem.data ();
+		  }
+
+                if (target_write_memory (entry->u.mem.addr, val,
 					 entry->u.mem.len))
                   {
                     entry->u.mem.mem_entry_not_accessible = 1;
@@ -874,8 +1335,9 @@ record_full_exec_insn (struct regcache *regcache,
                   }
                 else
 		  {
-		    memcpy (record_full_get_loc (entry), mem.data (),
-			    entry->u.mem.len);
+		    if (!entry->u.mem.delta)
+		      memcpy (record_full_get_loc (entry), mem.data (),
+			      entry->u.mem.len);
 
 		    /* We've changed memory --- check if a hardware
 		       watchpoint should trap.  Note that this
@@ -979,6 +1441,7 @@ record_full_open (const char *name, int from_tty)
   record_full_insn_count = 0;
   record_full_list = &record_full_first;
   record_full_list->next = NULL;
+  record_full_last_insn_ptid = ptid_t::make_null ();
 
   if (core_bfd)
     record_full_core_open_1 (name, from_tty);
@@ -1572,6 +2035,7 @@ record_full_registers_change (struct regcache *regcache, int regnum)
   record_full_list->next = record_full_arch_list_head;
   record_full_arch_list_head->prev = record_full_list;
   record_full_list = record_full_arch_list_tail;
+  record_full_last_insn_ptid = regcache->ptid ();
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -1951,6 +2415,14 @@ record_full_base_target::info_record ()
   /* Display max log size.  */
   printf_filtered (_("Max logged instructions is %u.\n"),
 		   record_full_insn_max_num);
+
+  /* Display the memory taken by the log.  */
+  if (record_full_arena_size != 0)
+    printf_filtered (_("Log occupies %s bytes, %s of them in the "
+		       "spill file.\n"),
+		     pulongest (record_full_arena_size),
+		     pulongest ((ULONGEST) record_full_spill_chunks
+				* RECORD_FULL_CHUNK_SIZE));
 }
 
 bool
@@ -2294,42 +2766,72 @@ record_full_core_target::has_execution (ptid_t the_ptid)
        8 bytes: memory address (network byte order).
        n bytes: memory value (n == memory length).
 
-*/
+   Version 3
+     4 bytes: magic number netorder32(0x20181016).
+       NOTE: be sure to change whenever this file format changes!
+     8 bytes: index of the record that was current when the log was
+              saved, counting from 1; 0 if the log was at its beginning
+              (network byte order).
 
-/* bfdcore_read -- read bytes from a core file section.  */
+   Records:
+     As in version 2, except that record_full_end has 8 bytes of
+     instruction count, and with two more types for entries holding a
+     delta (see record_full_encode_last_insn):
+     reg delta:
+       1 byte:  record type (RECORD_FULL_FILE_REG_DELTA).
+       4 bytes: register id (network byte order).
+       1 byte:  offset of the delta in the register.
+       1 byte:  delta length.
+       n bytes: delta (n == delta length).
+     mem delta:
+       1 byte:  record type (RECORD_FULL_FILE_MEM_DELTA).
+       4 bytes: memory length (network byte order).
+       8 bytes: memory address (network byte order).
+       n bytes: delta (n == memory length).
 
-static inline void
-bfdcore_read (bfd *obfd, asection *osec, void *buf, int len, int *offset)
-{
-  int ret = bfd_get_section_contents (obfd, osec, buf, *offset, len);
+   A version 2 log is saved after rewinding the program to the beginning
+   of the log, so that the core file holds the state at that point and
+   all records hold the values they will swap in when replaying forward.
+   A version 3 log is saved as it stands, along with the current
+   position: the core file holds the state at that position, records
+   before it hold values for replaying backward and the others values
+   for replaying forward.  This saves replaying the whole log twice
+   against the live program, and lets the section be written in one
+   go.  */
 
-  if (ret)
-    *offset += len;
-  else
-    error (_("Failed to read %d bytes from core file %s ('%s')."),
-	   len, bfd_get_filename (obfd),
-	   bfd_errmsg (bfd_get_error ()));
-}
+/* A cursor over the contents of the execution log section of a core
+   file.  */
 
-static inline uint64_t
-netorder64 (uint64_t input)
+struct record_full_reader
 {
-  uint64_t ret;
+  record_full_reader (const gdb_byte *start, bfd_size_type size)
+    : ptr (start), end (start + size)
+  {}
 
-  store_unsigned_integer ((gdb_byte *) &ret, sizeof (ret), 
-			  BFD_ENDIAN_BIG, input);
-  return ret;
-}
+  /* Return a pointer to the next LEN bytes, and skip them.  */
 
-static inline uint32_t
-netorder32 (uint32_t input)
-{
-  uint32_t ret;
+  const gdb_byte *read (size_t len)
+  {
+    const gdb_byte *result = ptr;
 
-  store_unsigned_integer ((gdb_byte *) &ret, sizeof (ret), 
-			  BFD_ENDIAN_BIG, input);
-  return ret;
-}
+    if (end - ptr < len)
+      error (_("Failed to read %s bytes from core file %s."),
+	     pulongest (len), bfd_get_filename (core_bfd));
+    ptr += len;
+    return result;
+  }
+
+  /* Read a LEN-byte integer in network byte order.  */
+
+  ULONGEST read_uint (size_t len)
+  {
+    return extract_unsigned_integer (read (len), len, BFD_ENDIAN_BIG);
+  }
+
+  /* The next byte to read, and the end of the section.  */
+  const gdb_byte *ptr;
+  const gdb_byte *end;
+};
 
 /* Restore the execution log from a core_bfd file.  */
 static void
@@ -2338,9 +2840,10 @@ record_full_restore (void)
   uint32_t magic;
   struct record_full_entry *rec;
   asection *osec;
-  uint32_t osec_size;
-  int bfd_offset = 0;
+  bfd_size_type osec_size;
   struct regcache *regcache;
+  ULONGEST position = 0, index = 0;
+  struct record_full_entry *current = &record_full_first;
 
   /* We restore the execution log from the open core bfd,
      if there is one.  */
@@ -2360,20 +2863,29 @@ record_full_restore (void)
 			osec ? "succeeded" : "failed");
   if (osec == NULL)
     return;
-  osec_size = bfd_section_size (core_bfd, osec);
   if (record_debug)
     fprintf_unfiltered (gdb_stdlog, "%s", bfd_section_name (core_bfd, osec));
 
+  /* Map the whole section rather than reading it piecemeal; for a
+     large log this is an mmap of the file.  */
+  const gdb_byte *contents = gdb_bfd_map_section (osec, &osec_size);
+  if (contents == NULL)
+    error (_("Failed to read execution log from core file %s ('%s')."),
+	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
+  record_full_reader reader (contents, osec_size);
+
   /* Check the magic code.  */
-  bfdcore_read (core_bfd, osec, &magic, sizeof (magic), &bfd_offset);
-  if (magic != RECORD_FULL_FILE_MAGIC)
+  magic = reader.read_uint (4);
+  if (magic == RECORD_FULL_FILE_MAGIC)
+    position = reader.read_uint (8);
+  else if (magic != RECORD_FULL_FILE_MAGIC_V2)
     error (_("Version mis-match or file format error in core file %s."),
 	   bfd_get_filename (core_bfd));
   if (record_debug)
     fprintf_unfiltered (gdb_stdlog,
-			"  Reading 4-byte magic cookie "
-			"RECORD_FULL_FILE_MAGIC (0x%s)\n",
-			phex_nz (netorder32 (magic), 4));
+			"  Reading 4-byte magic cookie (0x%s), "
+			"position %s\n",
+			phex_nz (magic, 4), pulongest (position));
 
   /* Restore the entries in recfd into record_full_arch_list_head and
      record_full_arch_list_tail.  */
@@ -2385,32 +2897,32 @@ record_full_restore (void)
     {
       regcache = get_current_regcache ();
 
-      while (1)
+      /* We are finished when we reach the end of the section.  */
+      while (reader.ptr < reader.end)
 	{
 	  uint8_t rectype;
-	  uint32_t regnum, len, signal, count;
+	  uint32_t regnum, len;
 	  uint64_t addr;
+	  const gdb_byte *val;
 
-	  /* We are finished when offset reaches osec_size.  */
-	  if (bfd_offset >= osec_size)
-	    break;
-	  bfdcore_read (core_bfd, osec, &rectype, sizeof (rectype), &bfd_offset);
+	  rectype = reader.read_uint (1);
 
 	  switch (rectype)
 	    {
 	    case record_full_reg: /* reg */
 	      /* Get register number to regnum.  */
-	      bfdcore_read (core_bfd, osec, &regnum,
-			    sizeof (regnum), &bfd_offset);
-	      regnum = netorder32 (regnum);
-
-	      rec = record_full_reg_alloc (regcache, regnum);
+	      regnum = reader.read_uint (4);
+	      if (regnum >= gdbarch_num_regs (regcache->arch ()))
+		error (_("Bad register number %u in core file %s."),
+		       regnum, bfd_get_filename (core_bfd));
 
 	      /* Get val.  */
-	      bfdcore_read (core_bfd, osec, record_full_get_loc (rec),
-			    rec->u.reg.len, &bfd_offset);
+	      val = reader.read (register_size (regcache->arch (), regnum));
 
-	      if (record_debug)
+	      rec = record_full_reg_alloc (regcache, regnum);
+	      memcpy (record_full_get_loc (rec), val, rec->u.reg.len);
+
+	      if (record_debug > 1)
 		fprintf_unfiltered (gdb_stdlog,
 				    "  Reading register %d (1 "
 				    "plus %lu plus %d bytes)\n",
@@ -2421,22 +2933,18 @@ record_full_restore (void)
 
 	    case record_full_mem: /* mem */
 	      /* Get len.  */
-	      bfdcore_read (core_bfd, osec, &len,
-			    sizeof (len), &bfd_offset);
-	      len = netorder32 (len);
+	      len = reader.read_uint (4);
 
 	      /* Get addr.  */
-	      bfdcore_read (core_bfd, osec, &addr,
-			    sizeof (addr), &bfd_offset);
-	      addr = netorder64 (addr);
-
-	      rec = record_full_mem_alloc (addr, len);
+	      addr = reader.read_uint (8);
 
 	      /* Get val.  */
-	      bfdcore_read (core_bfd, osec, record_full_get_loc (rec),
-			    rec->u.mem.len, &bfd_offset);
+	      val = reader.read (len);
 
-	      if (record_debug)
+	      rec = record_full_mem_alloc (addr, len);
+	      memcpy (record_full_get_loc (rec), val, len);
+
+	      if (record_debug > 1)
 		fprintf_unfiltered (gdb_stdlog,
 				    "  Reading memory %s (1 plus "
 				    "%lu plus %lu plus %d bytes)\n",
@@ -2447,30 +2955,59 @@ record_full_restore (void)
 				    rec->u.mem.len);
 	      break;
 
+	    case RECORD_FULL_FILE_REG_DELTA:
+	      {
+		if (magic != RECORD_FULL_FILE_MAGIC)
+		  error (_("Bad entry type in core file %s."),
+			 bfd_get_filename (core_bfd));
+
+		regnum = reader.read_uint (4);
+		if (regnum >= gdbarch_num_regs (regcache->arch ()))
+		  error (_("Bad register number %u in core file %s."),
+			 regnum, bfd_get_filename (core_bfd));
+		int reg_len = register_size (regcache->arch (), regnum);
+		int offset = reader.read_uint (1);
+		int delta_len = reader.read_uint (1);
+		if (delta_len == 0 || offset + delta_len > reg_len)
+		  error (_("Bad register delta in core file %s."),
+			 bfd_get_filename (core_bfd));
+		val = reader.read (delta_len);
+
+		rec = record_full_reg_delta_alloc (regnum, reg_len, offset,
+						   delta_len);
+		memcpy (record_full_get_loc (rec), val, delta_len);
+	      }
+	      break;
+
+	    case RECORD_FULL_FILE_MEM_DELTA:
+	      if (magic != RECORD_FULL_FILE_MAGIC)
+		error (_("Bad entry type in core file %s."),
+		       bfd_get_filename (core_bfd));
+
+	      len = reader.read_uint (4);
+	      addr = reader.read_uint (8);
+	      val = reader.read (len);
+
+	      rec = record_full_mem_alloc (addr, len);
+	      rec->u.mem.delta = 1;
+	      memcpy (record_full_get_loc (rec), val, len);
+	      break;
+
 	    case record_full_end: /* end */
 	      rec = record_full_end_alloc ();
 	      record_full_insn_num ++;
 
 	      /* Get signal value.  */
-	      bfdcore_read (core_bfd, osec, &signal,
-			    sizeof (signal), &bfd_offset);
-	      signal = netorder32 (signal);
-	      rec->u.end.sigval = (enum gdb_signal) signal;
+	      rec->u.end.sigval = (enum gdb_signal) reader.read_uint (4);
 
 	      /* Get insn count.  */
-	      bfdcore_read (core_bfd, osec, &count,
-			    sizeof (count), &bfd_offset);
-	      count = netorder32 (count);
-	      rec->u.end.insn_num = count;
-	      record_full_insn_count = count + 1;
-	      if (record_debug)
+	      rec->u.end.insn_num
+		= reader.read_uint (magic == RECORD_FULL_FILE_MAGIC ? 8 : 4);
+	      record_full_insn_count = rec->u.end.insn_num + 1;
+	      if (record_debug > 1)
 		fprintf_unfiltered (gdb_stdlog,
-				    "  Reading record_full_end (1 + "
-				    "%lu + %lu bytes), offset == %s\n",
-				    (unsigned long) sizeof (signal),
-				    (unsigned long) sizeof (count),
-				    paddress (get_current_arch (),
-					      bfd_offset));
+				    "  Reading record_full_end, offset == %s\n",
+				    pulongest (reader.ptr - contents));
 	      break;
 
 	    default:
@@ -2481,6 +3018,8 @@ record_full_restore (void)
 
 	  /* Add rec to record arch list.  */
 	  record_full_arch_list_add (rec);
+	  if (++index == position)
+	    current = rec;
 	}
     }
   CATCH (ex, RETURN_MASK_ALL)
@@ -2490,11 +3029,35 @@ record_full_restore (void)
     }
   END_CATCH
 
+  if (position > index)
+    {
+      record_full_list_release (record_full_arch_list_tail);
+      error (_("Bad log position in core file %s."),
+	     bfd_get_filename (core_bfd));
+    }
+
   /* Add record_full_arch_list_head to the end of record list.  */
   record_full_first.next = record_full_arch_list_head;
   record_full_arch_list_head->prev = &record_full_first;
   record_full_arch_list_tail->next = NULL;
-  record_full_list = &record_full_first;
+
+  /* The core file holds the state at CURRENT; rewind to the beginning
+     of the log, which is where replay starts.  This only touches the
+     record-core target's copies of registers and memory.  */
+  record_full_list = current;
+  if (record_full_list != &record_full_first)
+    {
+      scoped_restore restore_operation_disable
+	= record_full_gdb_operation_disable_set ();
+      struct gdbarch *gdbarch = regcache->arch ();
+
+      while (record_full_list != &record_full_first)
+	{
+	  record_full_exec_insn (regcache, gdbarch, record_full_list);
+	  record_full_list = record_full_list->prev;
+	}
+      registers_changed ();
+    }
 
   /* Update record_full_insn_max_num.  */
   if (record_full_insn_num > record_full_insn_max_num)
@@ -2511,21 +3074,6 @@ record_full_restore (void)
   print_stack_frame (get_selected_frame (NULL), 1, SRC_AND_LOC, 1);
 }
 
-/* bfdcore_write -- write bytes into a core file section.  */
-
-static inline void
-bfdcore_write (bfd *obfd, asection *osec, void *buf, int len, int *offset)
-{
-  int ret = bfd_set_section_contents (obfd, osec, buf, *offset, len);
-
-  if (ret)
-    *offset += len;
-  else
-    error (_("Failed to write %d bytes to core file %s ('%s')."),
-	   len, bfd_get_filename (obfd),
-	   bfd_errmsg (bfd_get_error ()));
-}
-
 /* Restore the execution log from a file.  We use a modified elf
    corefile format, with an extra section for our data.  */
 
@@ -2542,13 +3090,10 @@ cmd_record_full_restore (const char *args, int from_tty)
 void
 record_full_base_target::save_record (const char *recfilename)
 {
-  struct record_full_entry *cur_record_full_list;
-  uint32_t magic;
-  struct regcache *regcache;
-  struct gdbarch *gdbarch;
-  int save_size = 0;
+  struct record_full_entry *rec;
+  bfd_size_type save_size;
   asection *osec = NULL;
-  int bfd_offset = 0;
+  ULONGEST position = 0, index = 0;
 
   /* Open the save file.  */
   if (record_debug)
@@ -2561,47 +3106,32 @@ record_full_base_target::save_record (const char *recfilename)
   /* Arrange to remove the output file on failure.  */
   gdb::unlinker unlink_file (recfilename);
 
-  /* Save the current record entry to "cur_record_full_list".  */
-  cur_record_full_list = record_full_list;
-
-  /* Get the values of regcache and gdbarch.  */
-  regcache = get_current_regcache ();
-  gdbarch = regcache->arch ();
-
-  /* Disable the GDB operation record.  */
-  scoped_restore restore_operation_disable
-    = record_full_gdb_operation_disable_set ();
-
-  /* Reverse execute to the begin of record list.  */
-  while (1)
+  /* Compute the size needed for the extra bfd section, and the
+     position of the current entry.  */
+  save_size = 4 + 8;	/* magic cookie, position */
+  for (rec = record_full_first.next; rec != NULL; rec = rec->next)
     {
-      /* Check for beginning and end of log.  */
-      if (record_full_list == &record_full_first)
-        break;
+      ++index;
+      if (rec == record_full_list)
+	position = index;
 
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
-
-      if (record_full_list->prev)
-        record_full_list = record_full_list->prev;
+      switch (rec->type)
+	{
+	case record_full_end:
+	  save_size += 1 + 4 + 8;
+	  break;
+	case record_full_reg:
+	  if (rec->u.reg.delta)
+	    save_size += 1 + 4 + 1 + 1 + rec->u.reg.delta_len;
+	  else
+	    save_size += 1 + 4 + rec->u.reg.len;
+	  break;
+	case record_full_mem:
+	  save_size += 1 + 4 + 8 + rec->u.mem.len;
+	  break;
+	}
     }
 
-  /* Compute the size needed for the extra bfd section.  */
-  save_size = 4;	/* magic cookie */
-  for (record_full_list = record_full_first.next; record_full_list;
-       record_full_list = record_full_list->next)
-    switch (record_full_list->type)
-      {
-      case record_full_end:
-	save_size += 1 + 4 + 4;
-	break;
-      case record_full_reg:
-	save_size += 1 + 4 + record_full_list->u.reg.len;
-	break;
-      case record_full_mem:
-	save_size += 1 + 4 + 8 + record_full_list->u.mem.len;
-	break;
-      }
-
   /* Make the new bfd section.  */
   osec = bfd_make_section_anyway_with_flags (obfd.get (), "precord",
                                              SEC_HAS_CONTENTS
@@ -2615,124 +3145,68 @@ record_full_base_target::save_record (const char *recfilename)
   bfd_set_section_alignment (obfd.get (), osec, 0);
   bfd_section_lma (obfd.get (), osec) = 0;
 
-  /* Save corefile state.  */
+  /* Save corefile state, as of the current position in the log.  */
   write_gcore_file (obfd.get ());
 
-  /* Write out the record log.  */
-  /* Write the magic code.  */
-  magic = RECORD_FULL_FILE_MAGIC;
-  if (record_debug)
-    fprintf_unfiltered (gdb_stdlog,
-			"  Writing 4-byte magic cookie "
-			"RECORD_FULL_FILE_MAGIC (0x%s)\n",
-		      phex_nz (magic, 4));
-  bfdcore_write (obfd.get (), osec, &magic, sizeof (magic), &bfd_offset);
-
-  /* Save the entries to recfd and forward execute to the end of
-     record list.  */
-  record_full_list = &record_full_first;
-  while (1)
+  /* Lay out the record log in memory.  */
+  gdb::byte_vector contents (save_size);
+  gdb_byte *ptr = contents.data ();
+  auto put = [&] (ULONGEST val, int len)
     {
-      /* Save entry.  */
-      if (record_full_list != &record_full_first)
-        {
-	  uint8_t type;
-	  uint32_t regnum, len, signal, count;
-          uint64_t addr;
-
-	  type = record_full_list->type;
-          bfdcore_write (obfd.get (), osec, &type, sizeof (type), &bfd_offset);
-
-          switch (record_full_list->type)
-            {
-            case record_full_reg: /* reg */
-	      if (record_debug)
-		fprintf_unfiltered (gdb_stdlog,
-				    "  Writing register %d (1 "
-				    "plus %lu plus %d bytes)\n",
-				    record_full_list->u.reg.num,
-				    (unsigned long) sizeof (regnum),
-				    record_full_list->u.reg.len);
-
-              /* Write regnum.  */
-              regnum = netorder32 (record_full_list->u.reg.num);
-              bfdcore_write (obfd.get (), osec, &regnum,
-			     sizeof (regnum), &bfd_offset);
+      store_unsigned_integer (ptr, len, BFD_ENDIAN_BIG, val);
+      ptr += len;
+    };
 
-              /* Write regval.  */
-              bfdcore_write (obfd.get (), osec,
-			     record_full_get_loc (record_full_list),
-			     record_full_list->u.reg.len, &bfd_offset);
-              break;
-
-            case record_full_mem: /* mem */
-	      if (record_debug)
-		fprintf_unfiltered (gdb_stdlog,
-				    "  Writing memory %s (1 plus "
-				    "%lu plus %lu plus %d bytes)\n",
-				    paddress (gdbarch,
-					      record_full_list->u.mem.addr),
-				    (unsigned long) sizeof (addr),
-				    (unsigned long) sizeof (len),
-				    record_full_list->u.mem.len);
-
-	      /* Write memlen.  */
-	      len = netorder32 (record_full_list->u.mem.len);
-	      bfdcore_write (obfd.get (), osec, &len, sizeof (len),
-			     &bfd_offset);
-
-	      /* Write memaddr.  */
-	      addr = netorder64 (record_full_list->u.mem.addr);
-	      bfdcore_write (obfd.get (), osec, &addr, 
-			     sizeof (addr), &bfd_offset);
-
-	      /* Write memval.  */
-	      bfdcore_write (obfd.get (), osec,
-			     record_full_get_loc (record_full_list),
-			     record_full_list->u.mem.len, &bfd_offset);
-              break;
-
-              case record_full_end:
-		if (record_debug)
-		  fprintf_unfiltered (gdb_stdlog,
-				      "  Writing record_full_end (1 + "
-				      "%lu + %lu bytes)\n", 
-				      (unsigned long) sizeof (signal),
-				      (unsigned long) sizeof (count));
-		/* Write signal value.  */
-		signal = netorder32 (record_full_list->u.end.sigval);
-		bfdcore_write (obfd.get (), osec, &signal,
-			       sizeof (signal), &bfd_offset);
-
-		/* Write insn count.  */
-		count = netorder32 (record_full_list->u.end.insn_num);
-		bfdcore_write (obfd.get (), osec, &count,
-			       sizeof (count), &bfd_offset);
-                break;
-            }
-        }
-
-      /* Execute entry.  */
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
-
-      if (record_full_list->next)
-        record_full_list = record_full_list->next;
-      else
-        break;
-    }
-
-  /* Reverse execute to cur_record_full_list.  */
-  while (1)
+  put (RECORD_FULL_FILE_MAGIC, 4);
+  put (position, 8);
+  for (rec = record_full_first.next; rec != NULL; rec = rec->next)
     {
-      /* Check for beginning and end of log.  */
-      if (record_full_list == cur_record_full_list)
-        break;
-
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
-
-      if (record_full_list->prev)
-        record_full_list = record_full_list->prev;
+      switch (rec->type)
+	{
+	case record_full_reg: /* reg */
+	  if (rec->u.reg.delta)
+	    {
+	      put (RECORD_FULL_FILE_REG_DELTA, 1);
+	      put (rec->u.reg.num, 4);
+	      put (rec->u.reg.delta_offset, 1);
+	      put (rec->u.reg.delta_len, 1);
+	      memcpy (ptr, record_full_get_loc (rec), rec->u.reg.delta_len);
+	      ptr += rec->u.reg.delta_len;
+	      break;
+	    }
+	  put (rec->type, 1);
+	  put (rec->u.reg.num, 4);
+	  memcpy (ptr, record_full_get_loc (rec), rec->u.reg.len);
+	  ptr += rec->u.reg.len;
+	  break;
+
+	case record_full_mem: /* mem */
+	  put (rec->u.mem.delta ? RECORD_FULL_FILE_MEM_DELTA : rec->type, 1);
+	  put (rec->u.mem.len, 4);
+	  put (rec->u.mem.addr, 8);
+	  memcpy (ptr, record_full_get_loc (rec), rec->u.mem.len);
+	  ptr += rec->u.mem.len;
+	  break;
+
+	case record_full_end:
+	  put (rec->type, 1);
+	  put (rec->u.end.sigval, 4);
+	  put (rec->u.end.insn_num, 8);
+	  break;
+	}
     }
+  gdb_assert (ptr == contents.data () + save_size);
+
+  /* Write out the record log.  */
+  if (record_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"  Writing %s bytes of execution log, position %s\n",
+			pulongest (save_size), pulongest (position));
+  if (!bfd_set_section_contents (obfd.get (), osec, contents.data (), 0,
+				 save_size))
+    error (_("Failed to write %s bytes to core file %s ('%s')."),
+	   pulongest (save_size), bfd_get_filename (obfd.get ()),
+	   bfd_errmsg (bfd_get_error ()));
 
   unlink_file.keep ();
 
@@ -2889,6 +3363,20 @@ limit.  Default is 200000."),
 		     &show_record_cmdlist);
   deprecate_cmd (c, "show record full insn-number-max");
 
+  add_setshow_uinteger_cmd ("spill-threshold", no_class,
+			    &record_full_spill_threshold,
+			    _("Set the size past which the record/replay "
+			      "buffer spills to a file."),
+			    _("Show the size past which the record/replay "
+			      "buffer spills to a file."), _("\
+Set the size, in megabytes, that the record/replay buffer may take in\n\
+memory.  Past it, the buffer continues in a temporary file mapped into\n\
+memory, which the system can page out.  The file is created in $TMPDIR,\n\
+or /tmp.  A value of either \"unlimited\" or zero means the buffer\n\
+never spills.  Default is unlimited."),
+			    NULL, NULL, &set_record_full_cmdlist,
+			    &show_record_full_cmdlist);
+
   add_setshow_boolean_cmd ("memory-query", no_class,
 			   &record_full_memory_query, _("\
 Set whether query if PREC cannot record memory change of next instruction."),
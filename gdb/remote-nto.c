@@ -69,6 +69,7 @@
 
 #include "nto-share/dsmsgs.h"
 #include "nto-tdep.h"
+#include "ax.h"
 
 #ifndef __MINGW32__
 #include <termios.h>
@@ -201,6 +202,11 @@ public:
   void files_info () override;
   int insert_breakpoint (struct gdbarch *, struct bp_target_info *) override;
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *, enum remove_bp_reason) override;
+  void begin_breakpoint_batch () override;
+  void end_breakpoint_batch (std::vector<bp_target_info *> *) override;
+  bool keep_breakpoints_inserted () override;
+  bool supports_evaluation_of_breakpoint_conditions () override;
+  bool can_run_breakpoint_commands () override;
   int can_use_hw_breakpoint (enum bptype, int, int) override;
   int insert_hw_breakpoint (struct gdbarch *, struct bp_target_info *) override;
   int remove_hw_breakpoint (struct gdbarch *, struct bp_target_info *) override;
@@ -264,12 +270,41 @@ public:
     return true;
   }
   int verify_memory (const gdb_byte *data, CORE_ADDR memaddr, ULONGEST size) override;
+  void read_memory_list (std::vector<memory_read_request> *requests) override;
   enum target_xfer_status xfer_partial (enum target_object object,
                 const char *annex,
                 gdb_byte *readbuf,
                 const gdb_byte *writebuf,
                 ULONGEST offset, ULONGEST len,
                 ULONGEST *xfered_len) override;
+
+private:
+  /* A breakpoint insertion or removal queued while a breakpoint batch
+     is open.  */
+  struct queued_brk
+  {
+    bp_target_info *bp_tgt;
+    ptid_t ptid;
+    CORE_ADDR addr;
+    /* Breakpoint size, or -1 to remove the breakpoint.  */
+    int size;
+  };
+
+  void flush_breakpoint_queue ();
+  int read_breakpoint_shadow (struct gdbarch *, bp_target_info *);
+
+  /* Nesting depth of begin_breakpoint_batch calls.  */
+  int m_brk_batch_depth = 0;
+
+  /* Requests queued by insert_breakpoint and remove_breakpoint.  */
+  std::vector<queued_brk> m_brk_queue;
+
+  /* Queued requests that failed when the queue was flushed.  */
+  std::vector<bp_target_info *> m_brk_failed;
+
+  /* The process selected by read_breakpoint_shadow during the current
+     batch, or zero.  */
+  int m_brk_shadow_pid = 0;
 };
 
 struct nto_remote_inferior_data
@@ -334,6 +369,25 @@ struct pdebug_session
   int target_proto_major;
   int target_proto_minor;
 
+  /* Set if pdebug rejected a DSMSG_BRK_LIST request despite its
+     protocol version.  */
+  int brklist_rejected;
+
+  /* Set once pdebug has handled a DSMSG_BRK_LIST request.  */
+  int brklist_accepted;
+
+  /* Set if pdebug rejected a DSMSG_BRK_AGENT request despite its
+     protocol version; conditions and commands are then left to GDB.  */
+  int brk_agent_rejected;
+
+  /* Set if pdebug rejected a DSMSG_MEMRD_LIST request despite its
+     protocol version.  */
+  int memrdlist_rejected;
+
+  /* Set once breakpoint commands did not fit in a DSMSG_BRK_AGENT
+     request; GDB runs all breakpoint commands from then on.  */
+  int brk_commands_rejected;
+
   /* Communication buffer used by to_resume and to_wait. Nothing else
    * should be using it, all other operations should use their own
    * buffers allocated on the stack or heap.  */
@@ -353,6 +407,11 @@ struct pdebug_session only_session = {
   SET_CHANNEL_DEBUG,
   0, /* target_proto_major */
   0, /* target_proto_minor */
+  0, /* brklist_rejected */
+  0, /* brklist_accepted */
+  0, /* brk_agent_rejected */
+  0, /* brk_commands_rejected */
+  0, /* memrdlist_rejected */
 };
 
 /* Remote session (connection) to a QNX target. */
@@ -363,9 +422,17 @@ static int upload_sets_exec = 1;
 
 /* These define the version of the protocol implemented here.  */
 #define HOST_QNX_PROTOVER_MAJOR  0
-#define HOST_QNX_PROTOVER_MINOR  7
+#define HOST_QNX_PROTOVER_MINOR  11
 
-/* HOST_QNX_PROTOVER 0.8 - 64 bit capable structures.  */
+/* HOST_QNX_PROTOVER 0.8 - 64 bit capable structures.
+			  DSMSG_BRK_LIST breakpoint lists.
+   HOST_QNX_PROTOVER 0.9 - DSMSG_BRK_AGENT breakpoint conditions and
+			   commands.
+   HOST_QNX_PROTOVER 0.10 - DSMSG_RUN_RANGE range stepping.
+   HOST_QNX_PROTOVER 0.11 - DSMSG_MEMRD_LIST memory read lists.  */
+
+/* Whether to step through whole source lines with DSMSG_RUN_RANGE.  */
+static int nto_range_stepping = 1;
 
 /* Stuff for dealing with the packets which are part of this protocol.  */
 
@@ -465,6 +532,45 @@ supports64bit(void)
     || current_session->target_proto_minor >= 7);
 }
 
+/* Whether pdebug can set and clear breakpoints in batches, through
+   DSMSG_BRK_LIST requests.  */
+static int
+supports_brklist (void)
+{
+  return ((current_session->target_proto_major > 0
+	   || current_session->target_proto_minor >= 8)
+	  && !current_session->brklist_rejected);
+}
+
+/* Whether pdebug evaluates agent expressions attached to breakpoints
+   through DSMSG_BRK_AGENT requests.  */
+static int
+supports_brk_agent (void)
+{
+  return ((current_session->target_proto_major > 0
+	   || current_session->target_proto_minor >= 9)
+	  && !current_session->brk_agent_rejected);
+}
+
+/* Whether pdebug can keep stepping a thread while its pc is within a
+   range, through DSMSG_RUN_RANGE requests.  */
+static int
+supports_range_step (void)
+{
+  return (current_session->target_proto_major > 0
+	  || current_session->target_proto_minor >= 10);
+}
+
+/* Whether pdebug can read several memory ranges at once, through
+   DSMSG_MEMRD_LIST requests.  */
+static int
+supports_memrdlist (void)
+{
+  return ((current_session->target_proto_major > 0
+	   || current_session->target_proto_minor >= 11)
+	  && !current_session->memrdlist_rejected);
+}
+
 /* Send a packet to the remote machine.  Also sets channelwr and informs
    target if channelwr has changed.  */
 static int
@@ -1396,6 +1502,12 @@ nto_start_remote ( )
        (long) EXTRACT_SIGNED_INTEGER (&recv.pkt.err.err, 4, byte_order));
     }
 
+  current_session->brklist_rejected = 0;
+  current_session->brklist_accepted = 0;
+  current_session->brk_agent_rejected = 0;
+  current_session->brk_commands_rejected = 0;
+  current_session->memrdlist_rejected = 0;
+
   nto_trace (0) ("Pdebug protover %d.%d, GDB protover %d.%d\n",
        current_session->target_proto_major,
        current_session->target_proto_minor,
@@ -1763,6 +1875,7 @@ pdebug_target::resume (ptid_t ptid, int step,
   int signo;
   const int runone = ptid.lwp() > 0;
   unsigned sizeof_pkt;
+  struct thread_info *range_tp = NULL;
 
   nto_trace (0) ("pdebug_resume(pid %d, tid %ld, step %d, sig %d)\n",
      ptid.pid(), ptid.lwp(),
@@ -1818,6 +1931,45 @@ pdebug_target::resume (ptid_t ptid, int step,
   nto_send_recv (&tran, recv, sizeof (tran.pkt.kill), 1);
       }
 
+  /* When stepping through a line, let pdebug keep stepping while the
+     pc is in the line's range instead of reporting each instruction.  */
+  if (step && sig == GDB_SIGNAL_0 && nto_range_stepping
+      && supports_range_step ())
+    {
+      range_tp = find_thread_ptid (runone ? ptid : inferior_ptid);
+      if (range_tp != NULL && !range_tp->control.may_range_step)
+	range_tp = NULL;
+    }
+
+  if (range_tp != NULL)
+    {
+      nto_trace (0) ("  range step [%s, %s)\n",
+		     paddress (target_gdbarch (),
+			       range_tp->control.step_range_start),
+		     paddress (target_gdbarch (),
+			       range_tp->control.step_range_end));
+
+      nto_send_init (&tran, DStMsg_run, DSMSG_RUN_RANGE, SET_CHANNEL_DEBUG);
+      if (supports64bit())
+	{
+	  tran.pkt.run.step.addr[0] = EXTRACT_UNSIGNED_INTEGER
+	    (&range_tp->control.step_range_start, 8, byte_order);
+	  tran.pkt.run.step.addr[1] = EXTRACT_UNSIGNED_INTEGER
+	    (&range_tp->control.step_range_end, 8, byte_order);
+	  sizeof_pkt = sizeof (tran.pkt.run);
+	}
+      else
+	{
+	  tran.pkt.run32.step.addr[0] = EXTRACT_UNSIGNED_INTEGER
+	    (&range_tp->control.step_range_start, 4, byte_order);
+	  tran.pkt.run32.step.addr[1] = EXTRACT_UNSIGNED_INTEGER
+	    (&range_tp->control.step_range_end, 4, byte_order);
+	  sizeof_pkt = sizeof (tran.pkt.run32);
+	}
+      nto_send_recv (&tran, recv, sizeof_pkt, 1);
+      return;
+    }
+
 #if 0
   // aarch has single step but also does hardwar stepping.
   if (gdbarch_software_single_step_p (target_gdbarch ()))
@@ -2663,6 +2815,104 @@ nto_read_bytes (CORE_ADDR memaddr, gdb_byte *myaddr, int len,
   return (tot_len? TARGET_XFER_OK : TARGET_XFER_EOF);
 }
 
+/* Implementation of the read_memory_list target method.  Sends the
+   requests in as few DSMSG_MEMRD_LIST messages as possible.  Requests
+   too large to share a message, the entries after one pdebug could
+   not read, and all requests if pdebug rejects the list, are read one
+   at a time.  */
+
+void
+pdebug_target::read_memory_list (std::vector<memory_read_request> *requests)
+{
+  const enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  size_t next = 0;
+
+  auto read_one = [] (memory_read_request *r)
+    {
+      r->ok = target_read_raw_memory (r->addr, r->buf, r->len) == 0;
+    };
+
+  while (next < requests->size () && supports_memrdlist ())
+    {
+      std::vector<memory_read_request *> batch;
+      DScomm_t tran, recv;
+      ULONGEST total = 0;
+      uint32_t count;
+      int rcv_len;
+      size_t done;
+
+      for (; (next < requests->size ()
+	      && batch.size () < DSMSG_MEMRD_LIST_MAX);
+	   next++)
+	{
+	  memory_read_request *r = &(*requests)[next];
+
+	  if (r->len > DS_DATA_MAX_SIZE)
+	    {
+	      read_one (r);
+	      continue;
+	    }
+	  if (total + r->len > DS_DATA_MAX_SIZE)
+	    break;
+	  total += r->len;
+	  batch.push_back (r);
+	}
+
+      if (batch.empty ())
+	continue;
+
+      nto_send_init (&tran, DStMsg_memrd, DSMSG_MEMRD_LIST,
+		     SET_CHANNEL_DEBUG);
+      for (count = 0; count < batch.size (); count++)
+	{
+	  struct dsmemrdentry *const entry = &tran.pkt.memrdlist.entry[count];
+	  const uint64_t addr = batch[count]->addr;
+	  const uint32_t size = batch[count]->len;
+
+	  entry->addr = EXTRACT_UNSIGNED_INTEGER (&addr, 8, byte_order);
+	  entry->size = EXTRACT_UNSIGNED_INTEGER (&size, 4, byte_order);
+	  entry->spare0 = 0;
+	}
+      tran.pkt.memrdlist.count = EXTRACT_UNSIGNED_INTEGER (&count, 4,
+							    byte_order);
+      rcv_len = nto_send_recv (&tran, &recv,
+			       offsetof (DStMsg_memrdlist_t, entry)
+			       + count * sizeof (struct dsmemrdentry), 0)
+		- sizeof (recv.pkt.hdr);
+
+      if (recv.pkt.hdr.cmd != DSrMsg_okdata)
+	{
+	  /* Pdebug does not understand memory read lists after all;
+	     read this batch and all further requests one at a time.  */
+	  nto_trace (0) ("  DSMSG_MEMRD_LIST rejected\n");
+	  current_session->memrdlist_rejected = 1;
+	  for (memory_read_request *r : batch)
+	    read_one (r);
+	  continue;
+	}
+
+      /* The reply holds the entries pdebug could read, back to back;
+	 read the others on their own, for as much of them as can be
+	 read.  */
+      total = 0;
+      for (done = 0; done < batch.size (); done++)
+	{
+	  memory_read_request *r = batch[done];
+
+	  if (rcv_len < 0 || total + r->len > (ULONGEST) rcv_len)
+	    break;
+	  memcpy (r->buf, recv.pkt.okdata.data + total, r->len);
+	  r->ok = true;
+	  total += r->len;
+	}
+      for (; done < batch.size (); done++)
+	read_one (batch[done]);
+    }
+
+  for (; next < requests->size (); next++)
+    read_one (&(*requests)[next]);
+}
+
 enum target_xfer_status
 pdebug_target::xfer_partial (enum target_object object,
       const char *annex, gdb_byte *readbuf,
@@ -3190,6 +3440,112 @@ nto_insert_breakpoint (CORE_ADDR addr, gdb_byte *contents_cache)
   return recv.pkt.hdr.cmd == DSrMsg_err;
 }
 
+/* Append the agent expression AEXPR to the DSMSG_BRK_AGENT request
+   TRAN, whose data already holds *LEN bytes.  Returns zero if it does
+   not fit.  */
+
+static int
+nto_append_agent_expr (DScomm_t *const tran, size_t *const len,
+		       const struct agent_expr *const aexpr)
+{
+  const enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  uint8_t *const data = tran->pkt.brkagent.data;
+  uint16_t exprlen;
+
+  if (aexpr->len > 0xffff
+      || *len + sizeof (exprlen) + aexpr->len
+	 > sizeof (tran->pkt.brkagent.data))
+    return 0;
+
+  exprlen = aexpr->len;
+  exprlen = EXTRACT_UNSIGNED_INTEGER (&exprlen, sizeof (exprlen), byte_order);
+  memcpy (data + *len, &exprlen, sizeof (exprlen));
+  memcpy (data + *len + sizeof (exprlen), aexpr->buf, aexpr->len);
+  *len += sizeof (exprlen) + aexpr->len;
+  return 1;
+}
+
+/* Set a breakpoint at BP_TG_INF's placed address, or update the one
+   already there, with the conditions and commands GDB compiled for it
+   attached, so that pdebug evaluates them without stopping.  If the
+   conditions do not fit in the request they are all left for GDB to
+   evaluate; if the commands do not fit, GDB runs the commands of all
+   breakpoints from then on.  If pdebug rejects the request, a plain
+   breakpoint is set instead and GDB evaluates everything.  */
+
+static int
+nto_insert_breakpoint_agent (struct bp_target_info *const bp_tg_inf)
+{
+  const enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  const CORE_ADDR addr = bp_tg_inf->placed_address;
+  const uint32_t size = nto_breakpoint_size (addr);
+  const uint32_t persist = bp_tg_inf->persist;
+  uint16_t ncond = 0, ncmd = 0;
+  size_t len = 0;
+  DScomm_t tran, recv;
+
+  nto_trace (0) ("%s(addr %s, %zu conditions, %zu commands) pid:%d\n",
+		 __func__, paddress (target_gdbarch (), addr),
+		 bp_tg_inf->conditions.size (), bp_tg_inf->tcommands.size (),
+		 inferior_ptid.pid ());
+
+  nto_send_init (&tran, DStMsg_brk, DSMSG_BRK_AGENT | DSMSG_BRK_EXEC,
+		 SET_CHANNEL_DEBUG);
+
+  for (agent_expr *aexpr : bp_tg_inf->conditions)
+    {
+      if (!nto_append_agent_expr (&tran, &len, aexpr))
+	{
+	  nto_trace (0) ("  conditions too large, evaluating on host\n");
+	  ncond = 0;
+	  len = 0;
+	  break;
+	}
+      ncond++;
+    }
+
+  const size_t cond_len = len;
+  for (agent_expr *aexpr : bp_tg_inf->tcommands)
+    {
+      if (!nto_append_agent_expr (&tran, &len, aexpr))
+	{
+	  /* Let GDB run the commands instead.  The breakpoint then has
+	     to be reported, so this applies to all breakpoints.  */
+	  nto_trace (0) ("  commands too large, running them on host\n");
+	  current_session->brk_commands_rejected = 1;
+	  update_dprintf_breakpoints ();
+	  ncmd = 0;
+	  len = cond_len;
+	  break;
+	}
+      ncmd++;
+    }
+
+  tran.pkt.brkagent.size = EXTRACT_UNSIGNED_INTEGER (&size, 4, byte_order);
+  tran.pkt.brkagent.addr = EXTRACT_UNSIGNED_INTEGER (&addr, 8, byte_order);
+  tran.pkt.brkagent.ncond = EXTRACT_UNSIGNED_INTEGER (&ncond, 2, byte_order);
+  tran.pkt.brkagent.ncmd = EXTRACT_UNSIGNED_INTEGER (&ncmd, 2, byte_order);
+  tran.pkt.brkagent.persist = EXTRACT_UNSIGNED_INTEGER (&persist, 4,
+							byte_order);
+  nto_send_recv (&tran, &recv, offsetof (DStMsg_brkagent_t, data) + len, 0);
+  if (recv.pkt.hdr.cmd != DSrMsg_err)
+    return 0;
+
+  /* An agent that does not handle DSMSG_BRK_AGENT after all rejects
+     it.  If a plain breakpoint can be set there, leave conditions and
+     commands to GDB from now on.  */
+  if (nto_insert_breakpoint (addr, bp_tg_inf->shadow_contents))
+    {
+      nto_trace (0) ("  could not set breakpoint\n");
+      return 1;
+    }
+
+  nto_trace (0) ("  DSMSG_BRK_AGENT rejected\n");
+  current_session->brk_agent_rejected = 1;
+  update_dprintf_breakpoints ();
+  return 0;
+}
+
 /* To be called from breakpoint.c through
   current_target.to_insert_breakpoint.  */
 int
@@ -3201,13 +3557,36 @@ pdebug_target::insert_breakpoint (struct gdbarch *gdbarch,
       internal_error(__FILE__, __LINE__, _("Target info invalid."));
     }
 
+  bp_tg_inf->placed_address = bp_tg_inf->reqstd_address;
+
+  /* Queue the request if part of a batch; the thread is selected when
+     the queue is flushed.  Breakpoints with agent expressions are sent
+     on their own.  */
+  if (m_brk_batch_depth > 0 && supports_brklist ()
+      && bp_tg_inf->conditions.empty () && bp_tg_inf->tcommands.empty ())
+    {
+      if (read_breakpoint_shadow (gdbarch, bp_tg_inf) != 0)
+	return 1;
+      m_brk_queue.push_back ({bp_tg_inf, inferior_ptid,
+			      bp_tg_inf->placed_address,
+			      nto_breakpoint_size (bp_tg_inf->placed_address)});
+      return 0;
+    }
+
   /* Must select appropriate inferior. */
   if (!nto_set_thread_alive (inferior_ptid))
     {
       return 1;
     }
 
-  bp_tg_inf->placed_address = bp_tg_inf->reqstd_address;
+  if (keep_breakpoints_inserted ()
+      && read_breakpoint_shadow (gdbarch, bp_tg_inf) != 0)
+    return 1;
+
+  /* With agent support, this also clears any conditions left over
+     from a previous insertion of the same breakpoint.  */
+  if (supports_brk_agent ())
+    return nto_insert_breakpoint_agent (bp_tg_inf);
 
   return nto_insert_breakpoint ( bp_tg_inf->placed_address,
                 bp_tg_inf->shadow_contents);
@@ -3263,10 +3642,197 @@ pdebug_target::remove_breakpoint (struct gdbarch *gdbarch,
       internal_error (__FILE__, __LINE__, _("Target info invalid."));
     }
 
+  if (m_brk_batch_depth > 0 && supports_brklist ())
+    {
+      m_brk_queue.push_back ({bp_tg_inf, inferior_ptid,
+			      bp_tg_inf->placed_address, -1});
+      return 0;
+    }
+
   return nto_remove_breakpoint ( bp_tg_inf->placed_address,
         bp_tg_inf->shadow_contents);
 }
 
+/* Save the memory under the breakpoint BP_TG_INF in its shadow.
+   While breakpoints stay inserted across stops, GDB uses the shadow
+   to hide them from memory reads, rather than relying on the agent to
+   do so.  Returns non-zero if the memory cannot be read.  */
+
+int
+pdebug_target::read_breakpoint_shadow (struct gdbarch *gdbarch,
+				       bp_target_info *bp_tg_inf)
+{
+  const CORE_ADDR addr = bp_tg_inf->placed_address;
+  int len;
+
+  gdbarch_sw_breakpoint_from_kind (gdbarch, bp_tg_inf->kind, &len);
+
+  /* Queued requests do not select their process until the queue is
+     flushed; select it here, but only once per process and batch.  */
+  if (m_brk_batch_depth == 0 || m_brk_shadow_pid != inferior_ptid.pid ())
+    {
+      if (!nto_set_thread_alive (inferior_ptid))
+	return 1;
+      if (m_brk_batch_depth > 0)
+	m_brk_shadow_pid = inferior_ptid.pid ();
+    }
+
+  /* As in default_memory_insert_breakpoint, read into a separate
+     buffer; the breakpoint may be inserted already, and then its
+     shadow is used to mask the read.  */
+  gdb_byte *readbuf = (gdb_byte *) alloca (len);
+  if (target_read_memory (addr, readbuf, len) != 0)
+    return 1;
+  bp_tg_inf->shadow_len = len;
+  memcpy (bp_tg_inf->shadow_contents, readbuf, len);
+  return 0;
+}
+
+void
+pdebug_target::begin_breakpoint_batch ()
+{
+  if (m_brk_batch_depth++ == 0)
+    m_brk_shadow_pid = 0;
+}
+
+void
+pdebug_target::end_breakpoint_batch (std::vector<bp_target_info *> *failed)
+{
+  gdb_assert (m_brk_batch_depth > 0);
+
+  if (--m_brk_batch_depth > 0)
+    return;
+
+  flush_breakpoint_queue ();
+  failed->insert (failed->end (), m_brk_failed.begin (), m_brk_failed.end ());
+  m_brk_failed.clear ();
+}
+
+/* Send the queued breakpoint requests to pdebug, as few DSMSG_BRK_LIST
+   messages as possible, and record the ones that failed in
+   M_BRK_FAILED.  Falls back to one DStMsg_brk per request if pdebug
+   rejects the list.  */
+
+void
+pdebug_target::flush_breakpoint_queue ()
+{
+  const enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  DScomm_t tran, recv;
+  size_t i = 0;
+
+  nto_trace (0) ("%s (%zu requests)\n", __func__, m_brk_queue.size ());
+
+  while (i < m_brk_queue.size ())
+    {
+      const ptid_t ptid = m_brk_queue[i].ptid;
+      uint32_t count, done;
+
+      /* Requests are sent for one process at a time.  */
+      if (!nto_set_thread_alive (ptid))
+	{
+	  for (; i < m_brk_queue.size () && m_brk_queue[i].ptid == ptid; i++)
+	    m_brk_failed.push_back (m_brk_queue[i].bp_tgt);
+	  continue;
+	}
+
+      if (!supports_brklist ())
+	{
+	  const queued_brk &q = m_brk_queue[i++];
+
+	  if ((q.size == -1
+	       ? nto_remove_breakpoint (q.addr, q.bp_tgt->shadow_contents)
+	       : nto_insert_breakpoint (q.addr, q.bp_tgt->shadow_contents)))
+	    m_brk_failed.push_back (q.bp_tgt);
+	  continue;
+	}
+
+      nto_send_init (&tran, DStMsg_brk, DSMSG_BRK_LIST, SET_CHANNEL_DEBUG);
+      for (count = 0;
+	   (count < DSMSG_BRK_LIST_MAX
+	    && i + count < m_brk_queue.size ()
+	    && m_brk_queue[i + count].ptid == ptid);
+	   count++)
+	{
+	  const queued_brk &q = m_brk_queue[i + count];
+	  struct dsbrkentry *const entry = &tran.pkt.brklist.entry[count];
+	  const uint32_t subcmd = (q.size != -1 && supports_brk_agent ()
+				   ? DSMSG_BRK_AGENT | DSMSG_BRK_EXEC
+				   : DSMSG_BRK_EXEC);
+
+	  entry->addr = EXTRACT_UNSIGNED_INTEGER (&q.addr, 8, byte_order);
+	  entry->size = EXTRACT_SIGNED_INTEGER (&q.size, 4, byte_order);
+	  entry->subcmd = EXTRACT_UNSIGNED_INTEGER (&subcmd, 4, byte_order);
+	}
+      tran.pkt.brklist.count = EXTRACT_UNSIGNED_INTEGER (&count, 4, byte_order);
+      nto_send_recv (&tran, &recv,
+		     offsetof (DStMsg_brklist_t, entry)
+		     + count * sizeof (struct dsbrkentry), 0);
+
+      if (recv.pkt.hdr.cmd != DSrMsg_okstatus)
+	{
+	  /* Pdebug does not understand breakpoint lists after all;
+	     send this and all further requests one at a time.  */
+	  nto_trace (0) ("  DSMSG_BRK_LIST rejected\n");
+	  current_session->brklist_rejected = 1;
+	  continue;
+	}
+      current_session->brklist_accepted = 1;
+
+      done = EXTRACT_UNSIGNED_INTEGER (&recv.pkt.okstatus.status, 4,
+				       byte_order);
+      if (done > count)
+	done = count;
+      i += done;
+
+      /* Pdebug stops at the first failing entry; skip it, and send
+	 the rest of the list again.  An insertion is retried on its
+	 own first, in case the agent only rejected DSMSG_BRK_AGENT.  */
+      if (done < count)
+	{
+	  const queued_brk &q = m_brk_queue[i++];
+
+	  if (q.size == -1
+	      || !supports_brk_agent ()
+	      || nto_insert_breakpoint_agent (q.bp_tgt) != 0)
+	    {
+	      nto_trace (0) ("  could not %s breakpoint at %s\n",
+			     q.size == -1 ? "remove" : "set",
+			     paddress (target_gdbarch (), q.addr));
+	      m_brk_failed.push_back (q.bp_tgt);
+	    }
+	}
+    }
+
+  m_brk_queue.clear ();
+}
+
+/* Pdebug agents that handle DSMSG_BRK_LIST keep inserted breakpoints
+   out of memory reads, so there is no need to remove and reinsert
+   every breakpoint around each stop.  Only rely on that once the
+   agent has actually accepted a breakpoint list.  */
+
+bool
+pdebug_target::keep_breakpoints_inserted ()
+{
+  return supports_brklist () && current_session->brklist_accepted;
+}
+
+/* Pdebug evaluates breakpoint conditions and runs dprintf commands
+   compiled to agent expressions, without notifying GDB for the hits
+   it filters out.  */
+
+bool
+pdebug_target::supports_evaluation_of_breakpoint_conditions ()
+{
+  return supports_brk_agent ();
+}
+
+bool
+pdebug_target::can_run_breakpoint_commands ()
+{
+  return supports_brk_agent () && !current_session->brk_commands_rejected;
+}
+
 int
 pdebug_target::remove_hw_breakpoint (struct gdbarch *gdbarch,
         struct bp_target_info *bp_tg_inf)
@@ -4443,6 +5009,15 @@ If set, upload will set nto-executable. Otherwise, nto-executable \
 will not change."),
          NULL, NULL, &setlist, &showlist);
 
+  add_setshow_boolean_cmd ("nto-range-stepping", class_run,
+			   &nto_range_stepping, _("\
+Set whether to use range stepping on QNX Neutrino targets."), _("\
+Show whether to use range stepping on QNX Neutrino targets."), _("\
+If on, and pdebug supports it, GDB asks pdebug to keep stepping a\n\
+thread while it is within the source line being stepped, instead of\n\
+stopping after every instruction."),
+			   NULL, NULL, &setlist, &showlist);
+
   add_info ("pidlist", nto_pidlist, _("List processes on the target.  Optional argument will filter out process names not containing (case insensitive) argument string."));
   add_info ("meminfo", nto_meminfo, "memory information");
 }
@@ -226,6 +226,23 @@ struct remote_arch_state
   long remote_packet_size;
 };
 
+/* A software breakpoint insertion or removal queued while a
+   breakpoint batch is open, to be sent in a vBreakpointList
+   packet.  */
+
+struct remote_queued_breakpoint
+{
+  /* The breakpoint the request is for.  */
+  struct bp_target_info *bp_tgt;
+
+  /* The thread selected when the request was made; the request
+     applies to its process.  */
+  ptid_t ptid;
+
+  /* The request, as a "Z0" or "z0" packet.  */
+  std::string packet;
+};
+
 /* Description of the remote protocol state for the currently
    connected target.  This is per-target state, and independent of the
    selected architecture.  */
@@ -360,6 +377,15 @@ public: /* data */
      has yet been sent.  */
   int fs_pid = -1;
 
+  /* Nesting depth of begin_breakpoint_batch calls.  */
+  int brk_batch_depth = 0;
+
+  /* Software breakpoint requests queued in the current batch.  */
+  std::vector<remote_queued_breakpoint> brk_queue;
+
+  /* Queued requests that failed when the queue was flushed.  */
+  std::vector<bp_target_info *> brk_failed;
+
   /* A readahead cache for vFile:pread.  Often, reading a binary
      involves a sequence of small reads.  E.g., when parsing an ELF
      file.  A readahead cache helps mostly the case of remote
@@ -442,6 +468,9 @@ public:
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
 			 enum remove_bp_reason) override;
 
+  void begin_breakpoint_batch () override;
+  void end_breakpoint_batch (std::vector<bp_target_info *> *) override;
+  bool keep_breakpoints_inserted () override;
 
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
@@ -514,6 +543,8 @@ public:
 
   ULONGEST get_memory_xfer_limit () override;
 
+  void read_memory_list (std::vector<memory_read_request> *requests) override;
+
   void rcmd (const char *command, struct ui_file *output) override;
 
   char *pid_to_exec_file (int pid) override;
@@ -942,6 +973,9 @@ public: /* Remote specific methods.  */
 
   void packet_command (const char *args, int from_tty);
 
+  bool queue_breakpoint_request (struct bp_target_info *bp_tgt);
+  void flush_breakpoint_queue ();
+
 private: /* data fields */
 
   /* The remote state.  Don't reference this directly.  Use the
@@ -2077,6 +2111,13 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for reading several memory ranges in one packet.  */
+  PACKET_qMemReadList,
+
+  /* Support for inserting and removing several breakpoints in one
+     packet.  */
+  PACKET_vBreakpointList,
+
   PACKET_MAX
 };
 
@@ -5174,6 +5215,8 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
   { "QThreadEvents", PACKET_DISABLE, remote_supported_packet, PACKET_QThreadEvents },
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
+  { "qMemReadList", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qMemReadList },
 };
 
 static char *remote_support_xml;
@@ -10243,6 +10286,12 @@ remote_target::insert_breakpoint (struct gdbarch *gdbarch,
       if (can_run_breakpoint_commands ())
 	remote_add_target_side_commands (gdbarch, bp_tgt, p);
 
+      /* Breakpoints with target-side conditions or commands are
+	 sent on their own.  */
+      if (bp_tgt->conditions.empty () && bp_tgt->tcommands.empty ()
+	  && queue_breakpoint_request (bp_tgt))
+	return 0;
+
       putpkt (rs->buf);
       getpkt (&rs->buf, &rs->buf_size, 0);
 
@@ -10292,6 +10341,9 @@ remote_target::remove_breakpoint (struct gdbarch *gdbarch,
       p += hexnumstr (p, addr);
       xsnprintf (p, endbuf - p, ",%d", bp_tgt->kind);
 
+      if (queue_breakpoint_request (bp_tgt))
+	return 0;
+
       putpkt (rs->buf);
       getpkt (&rs->buf, &rs->buf_size, 0);
 
@@ -10301,6 +10353,147 @@ remote_target::remove_breakpoint (struct gdbarch *gdbarch,
   return memory_remove_breakpoint (this, gdbarch, bp_tgt, reason);
 }
 
+/* If a breakpoint batch is open, queue the "Z0" or "z0" request for
+   BP_TGT that is in the packet buffer, and return true.  Requests
+   are only queued once the stub is known to handle Z0 packets, and
+   while it may handle vBreakpointList packets.  */
+
+bool
+remote_target::queue_breakpoint_request (struct bp_target_info *bp_tgt)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (rs->brk_batch_depth == 0
+      || packet_support (PACKET_Z0) != PACKET_ENABLE
+      || packet_support (PACKET_vBreakpointList) == PACKET_DISABLE)
+    return false;
+
+  rs->brk_queue.push_back ({bp_tgt, inferior_ptid, rs->buf});
+  return true;
+}
+
+void
+remote_target::begin_breakpoint_batch ()
+{
+  get_remote_state ()->brk_batch_depth++;
+}
+
+void
+remote_target::end_breakpoint_batch (std::vector<bp_target_info *> *failed)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  gdb_assert (rs->brk_batch_depth > 0);
+
+  if (--rs->brk_batch_depth > 0)
+    return;
+
+  flush_breakpoint_queue ();
+  failed->insert (failed->end (), rs->brk_failed.begin (),
+		  rs->brk_failed.end ());
+  rs->brk_failed.clear ();
+}
+
+/* Send the queued breakpoint requests in as few vBreakpointList
+   packets as the packet size allows, one process at a time, and
+   record the ones that failed.  If the stub does not support the
+   packet, send the requests one at a time instead.  */
+
+void
+remote_target::flush_breakpoint_queue ()
+{
+  struct remote_state *rs = get_remote_state ();
+  std::vector<remote_queued_breakpoint> queue = std::move (rs->brk_queue);
+  long packet_size = get_remote_packet_size ();
+  size_t next = 0;
+
+  rs->brk_queue.clear ();
+
+  scoped_restore save_ptid = make_scoped_restore (&inferior_ptid);
+
+  while (next < queue.size ())
+    {
+      size_t first = next;
+      long len = strlen ("vBreakpointList");
+
+      inferior_ptid = queue[first].ptid;
+      if (!gdbarch_has_global_breakpoints (target_gdbarch ()))
+	set_general_process ();
+
+      /* Collect the requests for this process that fit in a
+	 packet.  */
+      for (; (next < queue.size ()
+	      && queue[next].ptid.pid () == queue[first].ptid.pid ()
+	      && len + 1 + (long) queue[next].packet.size () < packet_size);
+	   next++)
+	len += 1 + queue[next].packet.size ();
+      if (next == first)
+	next++;
+
+      /* A single request goes in its own packet.  That keeps its
+	 error reply apart from the one for a malformed list.  */
+      if (next - first > 1
+	  && packet_support (PACKET_vBreakpointList) != PACKET_DISABLE)
+	{
+	  std::string packet = "vBreakpointList";
+
+	  for (size_t i = first; i < next; i++)
+	    {
+	      packet += ';';
+	      packet += queue[i].packet;
+	    }
+
+	  putpkt (packet.c_str ());
+	  getpkt (&rs->buf, &rs->buf_size, 0);
+
+	  if (packet_ok (rs->buf,
+			 &remote_protocol_packets[PACKET_vBreakpointList])
+	      == PACKET_OK)
+	    {
+	      /* The reply has one entry per request, separated by ';':
+		 "OK", or an error code.  */
+	      const char *p = rs->buf;
+
+	      for (size_t i = first; i < next; i++)
+		{
+		  if (!startswith (p, "OK"))
+		    rs->brk_failed.push_back (queue[i].bp_tgt);
+		  p = strchr (p, ';');
+		  if (p == NULL)
+		    p = "";
+		  else
+		    p++;
+		}
+	      continue;
+	    }
+	}
+
+      /* Send the requests one at a time.  */
+      for (size_t i = first; i < next; i++)
+	{
+	  putpkt (queue[i].packet.c_str ());
+	  getpkt (&rs->buf, &rs->buf_size, 0);
+
+	  if (queue[i].packet[0] == 'Z'
+	      ? (packet_ok (rs->buf, &remote_protocol_packets[PACKET_Z0])
+		 != PACKET_OK)
+	      : rs->buf[0] == 'E')
+	    rs->brk_failed.push_back (queue[i].bp_tgt);
+	}
+    }
+}
+
+/* Stubs that handle vBreakpointList packets keep inserted breakpoints
+   out of memory reads, as gdbserver does, so there is no need to
+   remove and reinsert every breakpoint around each stop.  Only rely
+   on that once the stub has actually accepted a breakpoint list.  */
+
+bool
+remote_target::keep_breakpoints_inserted ()
+{
+  return packet_support (PACKET_vBreakpointList) == PACKET_ENABLE;
+}
+
 static enum Z_packet_type
 watchpoint_to_Z_packet (int type)
 {
@@ -11088,6 +11281,107 @@ remote_target::get_memory_xfer_limit ()
   return get_memory_write_packet_size ();
 }
 
+/* Implementation of the read_memory_list target method.  Sends the
+   requests in as few qMemReadList packets as the packet size allows.
+   Requests too large to share a packet, and all requests if the stub
+   does not support the packet, are read one at a time.  */
+
+void
+remote_target::read_memory_list (std::vector<memory_read_request> *requests)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST reply_size = get_memory_read_packet_size ();
+  long packet_size = get_remote_packet_size ();
+  size_t next = 0;
+
+  auto read_one = [] (memory_read_request *r)
+    {
+      r->ok = target_read_raw_memory (r->addr, r->buf, r->len) == 0;
+    };
+
+  /* Reads from a trace frame need the availability checks done by
+     remote_read_bytes.  */
+  if (get_traceframe_number () != -1)
+    {
+      for (memory_read_request &r : *requests)
+	read_one (&r);
+      return;
+    }
+
+  while (next < requests->size ()
+	 && packet_support (PACKET_qMemReadList) != PACKET_DISABLE)
+    {
+      std::vector<memory_read_request *> batch;
+      ULONGEST reply_len = 0;
+      char *p;
+
+      /* Construct "qMemReadList:"<addr>","<len>[";"<addr>","<len>]...  */
+      strcpy (rs->buf, "qMemReadList:");
+      p = rs->buf + strlen (rs->buf);
+      for (; next < requests->size (); next++)
+	{
+	  memory_read_request *r = &(*requests)[next];
+	  /* The reply holds two hex digits per byte, or an error code,
+	     and a separator.  */
+	  ULONGEST cost = std::max (2 * r->len, (ULONGEST) 3) + 1;
+	  char range[2 * sizeof (ULONGEST) * 2 + 2];
+	  int n;
+
+	  if (cost > reply_size)
+	    {
+	      read_one (r);
+	      continue;
+	    }
+
+	  n = hexnumstr (range, (ULONGEST) remote_address_masked (r->addr));
+	  range[n++] = ',';
+	  n += hexnumstr (range + n, r->len);
+	  if (reply_len + cost > reply_size
+	      || (p - rs->buf) + n + 1 >= packet_size)
+	    break;
+
+	  if (!batch.empty ())
+	    *p++ = ';';
+	  memcpy (p, range, n);
+	  p += n;
+	  reply_len += cost;
+	  batch.push_back (r);
+	}
+      *p = '\0';
+
+      if (batch.empty ())
+	continue;
+
+      putpkt (rs->buf);
+      getpkt (&rs->buf, &rs->buf_size, 0);
+      if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_qMemReadList])
+	  != PACKET_OK)
+	{
+	  for (memory_read_request *r : batch)
+	    read_one (r);
+	  continue;
+	}
+
+      /* The reply has one entry per range, separated by ';': either
+	 the contents in hex, or an error code.  */
+      p = rs->buf;
+      for (memory_read_request *r : batch)
+	{
+	  char *sep = strchr (p, ';');
+	  size_t n = sep != NULL ? sep - p : strlen (p);
+
+	  r->ok = (n == 2 * r->len
+		   && hex2bin (p, r->buf, r->len) == r->len);
+	  p += n;
+	  if (*p == ';')
+	    p++;
+	}
+    }
+
+  for (; next < requests->size (); next++)
+    read_one (&(*requests)[next]);
+}
+
 int
 remote_target::search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
 			      const gdb_byte *pattern, ULONGEST pattern_len,
@@ -14649,6 +14943,12 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_no_resumed],
 			 "N stop reply", "no-resumed-stop-reply", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qMemReadList],
+			 "qMemReadList", "memory-read-list", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_vBreakpointList],
+			 "vBreakpointList", "breakpoint-list", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
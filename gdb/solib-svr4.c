@@ -45,6 +45,7 @@
 #include "auxv.h"
 #include "gdb_bfd.h"
 #include "probe.h"
+#include <unordered_set>
 
 #if defined(__QNXTARGET__)
 #include "solib-nto.h"
@@ -370,6 +371,20 @@ struct svr4_info
   /* List of objects loaded into the inferior, used by the probes-
      based interface.  */
   struct so_list *solib_list;
+
+  /* The complete list last received via qXfer:libraries-svr4:read,
+     and the generation the target gave it, valid if XFER_LIST_P.
+     Later transfers need only send what changed since.  */
+  struct so_list *xfer_list;
+  ULONGEST xfer_generation;
+  int xfer_list_p;
+
+  /* The list of objects last read from the inferior's link map while
+     r_debug's r_state was consistent, and the r_map it was read from.
+     It is used instead of the link map while the dynamic linker is
+     changing it, and to avoid reading the names of objects again.  */
+  struct so_list *lm_list;
+  CORE_ADDR lm_list_r_map;
 };
 
 /* Per-program-space data key.  */
@@ -396,6 +411,26 @@ free_solib_list (struct svr4_info *info)
   info->solib_list = NULL;
 }
 
+/* Forget the list last read from the link map.  */
+
+static void
+free_lm_list (struct svr4_info *info)
+{
+  svr4_free_library_list (&info->lm_list);
+  info->lm_list = NULL;
+  info->lm_list_r_map = 0;
+}
+
+/* Forget the list last received from the target.  */
+
+static void
+free_xfer_list (struct svr4_info *info)
+{
+  svr4_free_library_list (&info->xfer_list);
+  info->xfer_list = NULL;
+  info->xfer_list_p = 0;
+}
+
 static void
 svr4_pspace_data_cleanup (struct program_space *pspace, void *arg)
 {
@@ -403,6 +438,8 @@ svr4_pspace_data_cleanup (struct program_space *pspace, void *arg)
 
   free_probes_table (info);
   free_solib_list (info);
+  free_xfer_list (info);
+  free_lm_list (info);
 
   xfree (info);
 }
@@ -892,8 +929,7 @@ locate_base (struct svr4_info *info)
    could not be determined.
 
    FIXME: Perhaps we should validate the info somehow, perhaps by
-   checking r_version for a known version number, or r_state for
-   RT_CONSISTENT.  */
+   checking r_version for a known version number.  */
 
 static CORE_ADDR
 solib_svr4_r_map (struct svr4_info *info)
@@ -916,6 +952,31 @@ solib_svr4_r_map (struct svr4_info *info)
   return addr;
 }
 
+/* The value of r_debug.r_state when the link map is consistent.
+   Any other value means that the dynamic linker is adding or removing
+   objects.  */
+
+#define SVR4_RT_CONSISTENT 0
+
+/* Find r_state from the inferior's debug base.  Return
+   SVR4_RT_CONSISTENT if r_debug has no r_state, or it can not be
+   read.  */
+
+static ULONGEST
+solib_svr4_r_state (struct svr4_info *info)
+{
+  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  gdb_byte buf[8];
+
+  if (lmo->r_state_size <= 0 || lmo->r_state_size > sizeof (buf)
+      || target_read_memory (info->debug_base + lmo->r_state_offset,
+			     buf, lmo->r_state_size) != 0)
+    return SVR4_RT_CONSISTENT;
+
+  return extract_unsigned_integer (buf, lmo->r_state_size, byte_order);
+}
+
 /* Find r_brk from the inferior's debug base.  */
 
 static CORE_ADDR
@@ -1058,6 +1119,17 @@ struct svr4_library_list
   /* Inferior address of struct link_map used for the main executable.  It is
      NULL if not known.  */
   CORE_ADDR main_lm;
+
+  /* The generation of the target's list, if GENERATION_P.  */
+  ULONGEST generation;
+  int generation_p;
+
+  /* If BASE_P, this describes only the changes to the list of
+     generation BASE: the link maps in REMOVED are gone, and the
+     libraries in HEAD follow what remains.  */
+  ULONGEST base;
+  int base_p;
+  std::vector<CORE_ADDR> removed;
 };
 
 /* Implementation for target_so_ops.free_so.  */
@@ -1184,6 +1256,36 @@ svr4_library_list_start_list (struct gdb_xml_parser *parser,
 
   if (main_lm)
     list->main_lm = *(ULONGEST *) main_lm->value.get ();
+
+  struct gdb_xml_value *generation
+    = xml_find_attribute (attributes, "generation");
+  if (generation != NULL)
+    {
+      list->generation = *(ULONGEST *) generation->value.get ();
+      list->generation_p = 1;
+    }
+
+  struct gdb_xml_value *base = xml_find_attribute (attributes, "base");
+  if (base != NULL)
+    {
+      list->base = *(ULONGEST *) base->value.get ();
+      list->base_p = 1;
+    }
+}
+
+/* Handle a <removed> element.  */
+
+static void
+library_list_start_removed (struct gdb_xml_parser *parser,
+			    const struct gdb_xml_element *element,
+			    void *user_data,
+			    std::vector<gdb_xml_value> &attributes)
+{
+  struct svr4_library_list *list = (struct svr4_library_list *) user_data;
+  ULONGEST *lmp
+    = (ULONGEST *) xml_find_attribute (attributes, "lm")->value.get ();
+
+  list->removed.push_back (*lmp);
 }
 
 /* The allowed elements and attributes for an XML library list.
@@ -1198,8 +1300,19 @@ static const struct gdb_xml_attribute svr4_library_attributes[] =
   { NULL, GDB_XML_AF_NONE, NULL, NULL }
 };
 
+static const struct gdb_xml_attribute svr4_removed_attributes[] =
+{
+  { "lm", GDB_XML_AF_NONE, gdb_xml_parse_attr_ulongest, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
 static const struct gdb_xml_element svr4_library_list_children[] =
 {
+  {
+    "removed", svr4_removed_attributes, NULL,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
+    library_list_start_removed, NULL
+  },
   {
     "library", svr4_library_attributes, NULL,
     GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
@@ -1212,6 +1325,8 @@ static const struct gdb_xml_attribute svr4_library_list_attributes[] =
 {
   { "version", GDB_XML_AF_NONE, NULL, NULL },
   { "main-lm", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { "generation", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { "base", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
   { NULL, GDB_XML_AF_NONE, NULL, NULL }
 };
 
@@ -1234,8 +1349,12 @@ svr4_parse_libraries (const char *document, struct svr4_library_list *list)
   struct cleanup *back_to = make_cleanup (svr4_free_library_list,
 					  &list->head);
 
-  memset (list, 0, sizeof (*list));
+  list->head = NULL;
   list->tailp = &list->head;
+  list->main_lm = 0;
+  list->generation_p = 0;
+  list->base_p = 0;
+  list->removed.clear ();
   if (gdb_xml_parse_quick (_("target library list"), "library-list-svr4.dtd",
 			   svr4_library_list_elements, document, list) == 0)
     {
@@ -1285,6 +1404,82 @@ svr4_current_sos_via_xfer_libraries (struct svr4_library_list *list,
 
 #endif
 
+/* Like svr4_current_sos_via_xfer_libraries, but fetch the whole list.
+   If INFO holds the list of an earlier transfer, ask the target to
+   send only what changed since, and apply that to it.  Targets that
+   do not understand the request send the whole list instead.  */
+
+static int
+svr4_current_sos_via_xfer_delta (struct svr4_info *info,
+				 struct svr4_library_list *list)
+{
+  int ok;
+
+  if (info->xfer_list_p && target_augmented_libraries_svr4_read ())
+    {
+      char annex[64];
+
+      xsnprintf (annex, sizeof (annex), "gen=%s",
+		 phex_nz (info->xfer_generation, sizeof (ULONGEST)));
+      ok = svr4_current_sos_via_xfer_libraries (list, annex);
+    }
+  else
+    ok = svr4_current_sos_via_xfer_libraries (list, NULL);
+
+  if (ok && list->base_p
+      && (!info->xfer_list_p || list->base != info->xfer_generation))
+    {
+      /* Not a change to the list we have; start over.  */
+      free_xfer_list (info);
+      svr4_free_library_list (&list->head);
+      ok = (svr4_current_sos_via_xfer_libraries (list, NULL)
+	    && !list->base_p);
+    }
+
+  if (!ok)
+    {
+      free_xfer_list (info);
+      return 0;
+    }
+
+  if (list->base_p)
+    {
+      struct so_list *head = svr4_copy_library_list (info->xfer_list);
+      struct so_list **link = &head;
+      std::unordered_set<CORE_ADDR> removed (list->removed.begin (),
+					     list->removed.end ());
+
+      while (*link != NULL)
+	{
+	  struct so_list *so = *link;
+	  lm_info_svr4 *li = (lm_info_svr4 *) so->lm_info;
+
+	  if (removed.find (li->lm_addr) != removed.end ())
+	    {
+	      *link = so->next;
+	      free_so (so);
+	    }
+	  else
+	    link = &so->next;
+	}
+
+      /* The new libraries follow the ones that stay.  */
+      *link = list->head;
+      list->head = head;
+    }
+
+  /* Remember the result for the next transfer.  */
+  free_xfer_list (info);
+  if (list->generation_p)
+    {
+      info->xfer_list = svr4_copy_library_list (list->head);
+      info->xfer_generation = list->generation;
+      info->xfer_list_p = 1;
+    }
+
+  return 1;
+}
+
 /* If no shared library information is available from the dynamic
    linker, build a fallback list from other sources.  */
 
@@ -1312,17 +1507,120 @@ svr4_default_sos (void)
   return newobj;
 }
 
+/* Hash and equality functions for svr4_index_so_list's table of
+   so_list entries.  Entries are looked up by their link map address.  */
+
+static hashval_t
+hash_so_list_lm_addr (const void *p)
+{
+  const struct so_list *so = (const struct so_list *) p;
+  const lm_info_svr4 *li = (const lm_info_svr4 *) so->lm_info;
+
+  return (hashval_t) li->lm_addr;
+}
+
+static int
+equal_so_list_lm_addr (const void *p1, const void *p2)
+{
+  const struct so_list *so = (const struct so_list *) p1;
+  const lm_info_svr4 *li = (const lm_info_svr4 *) so->lm_info;
+
+  return li->lm_addr == *(const CORE_ADDR *) p2;
+}
+
+/* Return a table of the entries of LIST, a list of shared objects read
+   earlier from the same inferior, by link map address.  Return NULL if
+   LIST is empty.  */
+
+static htab_up
+svr4_index_so_list (struct so_list *list)
+{
+  htab_up index;
+
+  for (; list != NULL; list = list->next)
+    {
+      const lm_info_svr4 *li = (const lm_info_svr4 *) list->lm_info;
+      void **slot;
+
+      if (li->lm_addr == 0 || li->name.empty ())
+	continue;
+
+      if (index == NULL)
+	index.reset (htab_create_alloc (1, hash_so_list_lm_addr,
+					equal_so_list_lm_addr, NULL,
+					xcalloc, xfree));
+
+      slot = htab_find_slot_with_hash (index.get (), &li->lm_addr,
+				       (hashval_t) li->lm_addr, INSERT);
+      *slot = list;
+    }
+
+  return index;
+}
+
+/* Read the name of the link map entry LI into *BUFFER, returning an
+   errno value as target_read_string does.  KNOWN, if not NULL, is a
+   table from svr4_index_so_list.  If LI is still the entry that was
+   read into it, only check that the name has not changed, which takes
+   one memory read rather than one per word of the name.  */
+
+static int
+svr4_read_lm_name (const lm_info_svr4 *li, htab_t known,
+		   gdb::unique_xmalloc_ptr<char> *buffer)
+{
+  int errcode;
+
+  if (known != NULL)
+    {
+      const struct so_list *so
+	= (const struct so_list *) htab_find_with_hash (known, &li->lm_addr,
+							 (hashval_t) li->lm_addr);
+      const lm_info_svr4 *known_li
+	= so != NULL ? (const lm_info_svr4 *) so->lm_info : NULL;
+
+      /* The link map may have been freed and reused for another
+	 object, so the name is always read back.  */
+      if (known_li != NULL
+	  && known_li->l_name == li->l_name
+	  && known_li->l_addr_inferior == li->l_addr_inferior
+	  && known_li->l_ld == li->l_ld)
+	{
+	  size_t len = known_li->name.size ();
+
+	  if (len > 0 && len < SO_NAME_MAX_PATH_SIZE - 1)
+	    {
+	      gdb::byte_vector name (len + 1);
+
+	      if (target_read_memory (li->l_name, name.data (), len + 1) == 0
+		  && name[len] == '\0'
+		  && memcmp (name.data (), known_li->name.data (), len) == 0)
+		{
+		  buffer->reset (xstrdup (known_li->name.c_str ()));
+		  return 0;
+		}
+	    }
+	}
+    }
+
+  target_read_string (li->l_name, buffer, SO_NAME_MAX_PATH_SIZE - 1,
+		      &errcode);
+  return errcode;
+}
+
 /* Read the whole inferior libraries chain starting at address LM.
    Expect the first entry in the chain's previous entry to be PREV_LM.
    Add the entries to the tail referenced by LINK_PTR_PTR.  Ignore the
    first entry if IGNORE_FIRST and set global MAIN_LM_ADDR according
-   to it.  Returns nonzero upon success.  If zero is returned the
-   entries stored to LINK_PTR_PTR are still valid although they may
-   represent only part of the inferior library list.  */
+   to it.  KNOWN, if not NULL, is a table from svr4_index_so_list used
+   to avoid reading again the names of entries that did not change.
+   Returns nonzero upon success.  If zero is returned the entries
+   stored to LINK_PTR_PTR are still valid although they may represent
+   only part of the inferior library list.  */
 
 static int
 svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
-		   struct so_list ***link_ptr_ptr, int ignore_first)
+		   struct so_list ***link_ptr_ptr, int ignore_first,
+		   htab_t known)
 {
   CORE_ADDR first_l_name = 0;
   CORE_ADDR next_lm;
@@ -1364,8 +1662,7 @@ svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
 	}
 
       /* Extract this shared object's name.  */
-      target_read_string (li->l_name, &buffer, SO_NAME_MAX_PATH_SIZE - 1,
-			  &errcode);
+      errcode = svr4_read_lm_name (li, known, &buffer);
 
 #ifdef __QNX_LEGACY__
       /* This only makes sense on versions < 7.1.0 */
@@ -1406,6 +1703,7 @@ svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
 	  continue;
 	}
 
+      li->name = buffer.get ();
       strncpy (newobj->so_name, buffer.get (), SO_NAME_MAX_PATH_SIZE - 1);
       newobj->so_name[SO_NAME_MAX_PATH_SIZE - 1] = '\0';
 #ifndef __QNXTARGET__
@@ -1435,11 +1733,13 @@ svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
 static struct so_list *
 svr4_current_sos_direct (struct svr4_info *info)
 {
-  CORE_ADDR lm;
+  CORE_ADDR lm, r_map;
   struct so_list *head = NULL;
   struct so_list **link_ptr = &head;
   struct cleanup *back_to;
   int ignore_first;
+  int complete;
+  ULONGEST r_state;
   struct svr4_library_list library_list;
 
   /* Fall back to manual examination of the target if the packet is not
@@ -1450,8 +1750,7 @@ svr4_current_sos_direct (struct svr4_info *info)
      Unfortunately statically linked inferiors will also fall back through this
      suboptimal code path.  */
 
-  info->using_xfer = svr4_current_sos_via_xfer_libraries (&library_list,
-							  NULL);
+  info->using_xfer = svr4_current_sos_via_xfer_delta (info, &library_list);
   if (info->using_xfer)
     {
       if (library_list.main_lm)
@@ -1484,13 +1783,36 @@ svr4_current_sos_direct (struct svr4_info *info)
 #endif
     ignore_first = 1;
 
+  /* The dynamic linker stops in r_brk both before and after it
+     changes the link map.  The first time, r_state is not consistent
+     and the objects are still the ones found at the last consistent
+     stop, so there is no need to walk the link map again.  There is
+     no generation count in r_debug, so an object removed from the
+     middle of the list can only be found by walking the whole list
+     at the consistent stop.  */
+  r_state = solib_svr4_r_state (info);
+  r_map = solib_svr4_r_map (info);
+  if (r_state != SVR4_RT_CONSISTENT
+      && info->lm_list != NULL && info->lm_list_r_map == r_map)
+    return svr4_copy_library_list (info->lm_list);
+
   back_to = make_cleanup (svr4_free_library_list, &head);
 
+  /* Most of the objects are usually the ones found last time; index
+     those so that their names need not be read again.  The probes
+     interface keeps its own list.  */
+  htab_up known
+    = svr4_index_so_list (info->solib_list != NULL
+			  ? info->solib_list
+			  : info->lm_list);
+
   /* Walk the inferior's link map list, and build our list of
      `struct so_list' nodes.  */
-  lm = solib_svr4_r_map (info);
+  complete = 1;
+  lm = r_map;
   if (lm)
-    svr4_read_so_list (lm, 0, &link_ptr, ignore_first);
+    complete = svr4_read_so_list (lm, 0, &link_ptr, ignore_first,
+				  known.get ());
 
   /* todo bweb does this break anything though? */
 #ifndef __QNXTARGET__
@@ -1500,10 +1822,20 @@ svr4_current_sos_direct (struct svr4_info *info)
      for skipping dynamic linker resolver code.  */
   lm = solib_svr4_r_ldsomap (info);
   if (lm)
-    svr4_read_so_list (lm, 0, &link_ptr, 0);
+    complete &= svr4_read_so_list (lm, 0, &link_ptr, 0, known.get ());
 #endif
 
   discard_cleanups (back_to);
+  known.reset ();
+
+  /* Remember a complete list read while the link map was consistent
+     for the next time.  */
+  free_lm_list (info);
+  if (complete && r_state == SVR4_RT_CONSISTENT && head != NULL)
+    {
+      info->lm_list = svr4_copy_library_list (head);
+      info->lm_list_r_map = r_map;
+    }
 
   if (head == NULL)
     return svr4_default_sos ();
@@ -1831,8 +2163,12 @@ solib_event_probe_action (struct probe_and_action *pa)
 static int
 solist_update_full (struct svr4_info *info)
 {
+  /* Keep the old list until the new one is read;
+     svr4_current_sos_direct reuses what did not change.  */
+  struct so_list *solib_list = svr4_current_sos_direct (info);
+
   free_solib_list (info);
-  info->solib_list = svr4_current_sos_direct (info);
+  info->solib_list = solib_list;
 
   return 1;
 }
@@ -1889,7 +2225,7 @@ solist_update_incremental (struct svr4_info *info, CORE_ADDR lm)
 	 above check and deferral to solist_update_full ensures
 	 that this call to svr4_read_so_list will never see the
 	 first element.  */
-      if (!svr4_read_so_list (lm, prev_lm, &link, 0))
+      if (!svr4_read_so_list (lm, prev_lm, &link, 0, NULL))
 	return 0;
     }
 
@@ -3151,6 +3487,8 @@ svr4_solib_create_inferior_hook (int from_tty)
   /* Clear the probes-based interface's state.  */
   free_probes_table (info);
   free_solib_list (info);
+  free_xfer_list (info);
+  free_lm_list (info);
 
   /* Relocate the main executable if necessary.  */
   svr4_relocate_main_executable ();
@@ -3178,6 +3516,8 @@ svr4_clear_solib (void)
   info->debug_loader_offset = 0;
   xfree (info->debug_loader_name);
   info->debug_loader_name = NULL;
+  free_xfer_list (info);
+  free_lm_list (info);
 }
 
 /* Clear any bits of ADDR that wouldn't fit in a target-format
@@ -3302,6 +3642,8 @@ svr4_ilp32_fetch_link_map_offsets (void)
       lmo.r_version_size = 4;
       lmo.r_map_offset = 4;
       lmo.r_brk_offset = 8;
+      lmo.r_state_offset = 12;
+      lmo.r_state_size = 4;
       lmo.r_ldsomap_offset = 20;
 
       /* Everything we need is in the first 20 bytes.  */
@@ -3333,6 +3675,8 @@ svr4_lp64_fetch_link_map_offsets (void)
       lmo.r_version_size = 4;
       lmo.r_map_offset = 8;
       lmo.r_brk_offset = 16;
+      lmo.r_state_offset = 24;
+      lmo.r_state_size = 4;
       lmo.r_ldsomap_offset = 40;
 
       /* Everything we need is in the first 40 bytes.  */
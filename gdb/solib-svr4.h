@@ -46,6 +46,9 @@ struct lm_info_svr4 : public lm_info_base
 
   /* Values read in from inferior's fields of the same name.  */
   CORE_ADDR l_ld = 0, l_next = 0, l_prev = 0, l_name = 0;
+
+  /* The string L_NAME pointed to when it was read, if it was.  */
+  std::string name;
 #ifdef __QNXTARGET__
   /* todo: bweb: it would probably make more sense to have an lm_info_nto */
     CORE_ADDR l_path;
@@ -61,10 +64,9 @@ struct link_map_offsets
     /* Offset and size of r_debug.r_version.  */
     int r_version_offset, r_version_size;
 
-#ifdef __QNXTARGET__
-    /* Offset and size of r_debug.r_state.  */
+    /* Offset and size of r_debug.r_state, or zero size if the
+       target's r_debug has no such member.  */
     int r_state_offset, r_state_size;
-#endif
 
     /* Offset of r_debug.r_map.  */
     int r_map_offset;
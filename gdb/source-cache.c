@@ -0,0 +1,322 @@
+/* Cache of source file contents for GDB.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "source-cache.h"
+#include "source.h"
+#include "symtab.h"
+#include "objfiles.h"
+#include "gdbcore.h"
+#include "gdbcmd.h"
+#include "common/scoped_fd.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <list>
+#include <unordered_map>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+/* Files at least this large are mapped rather than read.  Reading a
+   small file is cheaper than setting up and tearing down a mapping.  */
+
+#define SOURCE_CACHE_MMAP_THRESHOLD (64 * 1024)
+
+/* The cached files, most recently used first.  */
+
+static std::list<source_text_ref> source_cache;
+
+/* Index of SOURCE_CACHE by full name.  */
+
+static std::unordered_map<std::string, std::list<source_text_ref>::iterator>
+  source_cache_index;
+
+/* The maximum amount of memory, in kilobytes, the cached files may
+   take up.  The most recently used file is kept even if it alone is
+   larger.  */
+
+static unsigned int source_cache_size = 16 * 1024;
+
+/* Statistics, for "maint print source-cache-statistics".  */
+
+static unsigned int source_cache_hits;
+static unsigned int source_cache_misses;
+static unsigned int source_cache_evictions;
+
+source_text::source_text (std::string &&fullname, time_t mtime, int fd,
+			  size_t size)
+  : m_fullname (std::move (fullname)),
+    m_mtime (mtime),
+    m_size (size)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (size >= SOURCE_CACHE_MMAP_THRESHOLD)
+    {
+      void *mem = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (mem != MAP_FAILED)
+	{
+	  m_data = (const char *) mem;
+	  m_mapped = true;
+	  return;
+	}
+    }
+#endif
+
+  /* Use the heap, not the stack, because this may be pretty large,
+     and we may run into various kinds of limits on stack size.  */
+  gdb::unique_xmalloc_ptr<char> data ((char *) xmalloc (size + 1));
+
+  /* Reassign the size to result of read for systems where \r\n ->
+     \n.  */
+  int nread = myread (fd, data.get (), size);
+  if (nread < 0)
+    perror_with_name (m_fullname.c_str ());
+
+  m_size = nread;
+  m_data = data.release ();
+}
+
+source_text::~source_text ()
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (m_mapped)
+    {
+      munmap ((void *) m_data, m_size);
+      return;
+    }
+#endif
+
+  xfree ((void *) m_data);
+}
+
+/* See source-cache.h.  */
+
+const std::vector<off_t> &
+source_text::line_charpos ()
+{
+  if (m_line_charpos.empty ())
+    {
+      const char *p = m_data;
+      const char *end = m_data + m_size;
+
+      m_line_charpos.push_back (0);
+
+      /* memchr is typically vectorized, and much faster than looking
+	 at one character at a time.  */
+      while (p != end
+	     && (p = (const char *) memchr (p, '\n', end - p)) != NULL)
+	{
+	  ++p;
+	  /* A newline at the end does not start a new line.  */
+	  if (p != end)
+	    m_line_charpos.push_back (p - m_data);
+	}
+      m_line_charpos.shrink_to_fit ();
+    }
+
+  return m_line_charpos;
+}
+
+/* See source-cache.h.  */
+
+off_t
+source_text::line_end (int line)
+{
+  const std::vector<off_t> &offsets = line_charpos ();
+
+  gdb_assert (line >= 1 && line <= (int) offsets.size ());
+
+  if (line < (int) offsets.size ())
+    return offsets[line];
+  return m_size;
+}
+
+/* See source-cache.h.  */
+
+size_t
+source_text::footprint () const
+{
+  return (m_size + m_fullname.size ()
+	  + m_line_charpos.capacity () * sizeof (off_t));
+}
+
+/* Remove the cached file at ITER from the cache.  */
+
+static void
+source_cache_drop (std::list<source_text_ref>::iterator iter)
+{
+  source_cache_index.erase ((*iter)->fullname ());
+  source_cache.erase (iter);
+}
+
+/* Drop the least recently used files until the cache fits in
+   SOURCE_CACHE_SIZE again.  Line tables are built lazily, so the
+   footprint of a file grows after it was added; add it all up each
+   time.  */
+
+static void
+source_cache_trim (void)
+{
+  size_t limit = (size_t) source_cache_size * 1024;
+  size_t total = 0;
+
+  for (const source_text_ref &text : source_cache)
+    total += text->footprint ();
+
+  while (total > limit && source_cache.size () > 1)
+    {
+      auto last = std::prev (source_cache.end ());
+
+      total -= (*last)->footprint ();
+      source_cache_drop (last);
+      ++source_cache_evictions;
+    }
+}
+
+/* See source-cache.h.  */
+
+source_text_ref
+source_cache_get (struct symtab *s)
+{
+  const char *fullname = symtab_to_fullname (s);
+  struct stat st;
+
+  auto found = source_cache_index.find (fullname);
+  if (found != source_cache_index.end ())
+    {
+      std::list<source_text_ref>::iterator iter = found->second;
+      const source_text_ref &text = *iter;
+
+      if (stat (fullname, &st) == 0
+	  && st.st_mtime == text->mtime ()
+	  && (size_t) st.st_size == text->size ())
+	{
+	  ++source_cache_hits;
+	  source_cache.splice (source_cache.begin (), source_cache, iter);
+	  return text;
+	}
+
+      /* The file was changed or removed since it was read.  */
+      source_cache_drop (iter);
+    }
+
+  ++source_cache_misses;
+
+  /* This searches the source path again, in case the file moved.  */
+  scoped_fd desc (open_source_file (s));
+  if (desc.get () < 0)
+    return NULL;
+
+  if (fstat (desc.get (), &st) < 0)
+    perror_with_name (symtab_to_filename_for_display (s));
+
+  long mtime = 0;
+  if (SYMTAB_OBJFILE (s) != NULL && SYMTAB_OBJFILE (s)->obfd != NULL)
+    mtime = SYMTAB_OBJFILE (s)->mtime;
+  else if (exec_bfd)
+    mtime = exec_bfd_mtime;
+
+  if (mtime && mtime < st.st_mtime)
+    warning (_("Source file is more recent than executable."));
+
+  /* OPEN_SOURCE_FILE may have found the file under another name.  If
+     that one is cached already, replace it.  */
+  found = source_cache_index.find (s->fullname);
+  if (found != source_cache_index.end ())
+    source_cache_drop (found->second);
+
+  source_text_ref text
+    = std::make_shared<source_text> (std::string (s->fullname),
+				     st.st_mtime, desc.get (), st.st_size);
+
+  source_cache.push_front (text);
+  source_cache_index[text->fullname ()] = source_cache.begin ();
+  source_cache_trim ();
+
+  return text;
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache_clear (void)
+{
+  source_cache_index.clear ();
+  source_cache.clear ();
+}
+
+/* The "maint set source-cache-size" command.  */
+
+static void
+set_source_cache_size (const char *args, int from_tty,
+		       struct cmd_list_element *c)
+{
+  source_cache_trim ();
+}
+
+/* The "maint print source-cache-statistics" command.  */
+
+static void
+maintenance_print_source_cache_statistics (const char *args, int from_tty)
+{
+  size_t total = 0;
+
+  for (const source_text_ref &text : source_cache)
+    total += text->footprint ();
+
+  printf_filtered (_("  files cached: %s\n"),
+		   pulongest (source_cache.size ()));
+  printf_filtered (_("  bytes used: %s\n"), pulongest (total));
+  printf_filtered (_("  hits: %u\n"), source_cache_hits);
+  printf_filtered (_("  misses: %u\n"), source_cache_misses);
+  printf_filtered (_("  evictions: %u\n"), source_cache_evictions);
+}
+
+/* The "maint flush-source-cache" command.  */
+
+static void
+maintenance_flush_source_cache (const char *args, int from_tty)
+{
+  source_cache_clear ();
+}
+
+void
+_initialize_source_cache (void)
+{
+  add_setshow_zuinteger_cmd ("source-cache-size", no_class,
+			     &source_cache_size,
+			     _("Set the size of the source cache."),
+			     _("Show the size of the source cache."), _("\
+The maximum amount of memory, in kilobytes, used to cache the contents\n\
+of source files.  The most recently used file is always kept."),
+			     set_source_cache_size, NULL,
+			     &maintenance_set_cmdlist,
+			     &maintenance_show_cmdlist);
+
+  add_cmd ("source-cache-statistics", class_maintenance,
+	   maintenance_print_source_cache_statistics,
+	   _("Print source cache statistics."),
+	   &maintenanceprintlist);
+
+  add_cmd ("flush-source-cache", class_maintenance,
+	   maintenance_flush_source_cache,
+	   _("Flush the source cache."),
+	   &maintenancelist);
+}
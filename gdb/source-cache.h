@@ -0,0 +1,101 @@
+/* Cache of source file contents for GDB.
+
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SOURCE_CACHE_H
+#define SOURCE_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+struct symtab;
+
+/* The contents of a source file, as held by the source cache.  One
+   object is shared by all the symtabs whose full name is that file,
+   whatever objfile they come from.  */
+
+class source_text
+{
+public:
+
+  source_text (std::string &&fullname, time_t mtime, int fd, size_t size);
+  ~source_text ();
+
+  DISABLE_COPY_AND_ASSIGN (source_text);
+
+  /* The file's full name, as found by searching the source path.  */
+  const std::string &fullname () const
+  { return m_fullname; }
+
+  /* The modification time the file had when it was read.  */
+  time_t mtime () const
+  { return m_mtime; }
+
+  /* The file's contents.  These are not NUL-terminated.  */
+  const char *data () const
+  { return m_data; }
+
+  size_t size () const
+  { return m_size; }
+
+  /* The number of lines in the file.  A file always has at least one
+     line, even when empty.  */
+  int nlines ()
+  { return line_charpos ().size (); }
+
+  /* The offsets within data () at which each line starts; the first
+     line starts at offset zero.  Built the first time it is needed.  */
+  const std::vector<off_t> &line_charpos ();
+
+  /* Return the offset one past the end of LINE (1-based), including
+     its newline.  */
+  off_t line_end (int line);
+
+  /* The memory this object accounts for in the cache.  */
+  size_t footprint () const;
+
+private:
+
+  std::string m_fullname;
+  time_t m_mtime;
+
+  const char *m_data = NULL;
+  size_t m_size;
+
+  /* Whether M_DATA is mapped from the file rather than allocated.  */
+  bool m_mapped = false;
+
+  std::vector<off_t> m_line_charpos;
+};
+
+typedef std::shared_ptr<source_text> source_text_ref;
+
+/* Return the contents of the source file of symtab S, reading it into
+   the source cache if it is not there, or if it changed on disk since
+   it was read.  Return NULL, with errno set, if the file cannot be
+   opened or read.  The returned reference stays valid even if the
+   cache drops the file in the meantime.  */
+
+extern source_text_ref source_cache_get (struct symtab *s);
+
+/* Forget all the cached source files.  */
+
+extern void source_cache_clear (void);
+
+#endif /* SOURCE_CACHE_H */
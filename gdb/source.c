@@ -23,6 +23,7 @@
 #include "language.h"
 #include "command.h"
 #include "source.h"
+#include "source-cache.h"
 #include "gdbcmd.h"
 #include "frame.h"
 #include "value.h"
@@ -47,11 +48,6 @@
 #include "common/pathstuff.h"
 
 #define OPEN_MODE (O_RDONLY | O_BINARY)
-#define FDOPEN_MODE FOPEN_RB
-
-/* Prototypes for local functions.  */
-
-static int get_filename_and_charpos (struct symtab *, char **);
 
 /* Path of directories to search for source files.
    Same format as the PATH environment variable's value.  */
@@ -365,11 +361,6 @@ forget_cached_source_info_for_objfile (struct objfile *objfile)
 
   ALL_OBJFILE_FILETABS (objfile, cu, s)
     {
-      if (s->line_charpos != NULL)
-	{
-	  xfree (s->line_charpos);
-	  s->line_charpos = NULL;
-	}
       if (s->fullname != NULL)
 	{
 	  xfree (s->fullname);
@@ -381,7 +372,7 @@ forget_cached_source_info_for_objfile (struct objfile *objfile)
     objfile->sf->qf->forget_cached_source_info (objfile);
 }
 
-/* Forget what we learned about line positions in source files, and
+/* Forget what we learned about the contents of source files, and
    which directories contain them; must check again now since files
    may be found in a different directory now.  */
 
@@ -397,6 +388,7 @@ forget_cached_source_info (void)
       forget_cached_source_info_for_objfile (objfile);
     }
 
+  source_cache_clear ();
   last_source_visited = NULL;
 }
 
@@ -653,9 +645,14 @@ info_source_command (const char *ignore, int from_tty)
     printf_filtered (_("Compilation directory is %s\n"), SYMTAB_DIRNAME (s));
   if (s->fullname)
     printf_filtered (_("Located in %s\n"), s->fullname);
-  if (s->nlines)
-    printf_filtered (_("Contains %d line%s.\n"), s->nlines,
-		     s->nlines == 1 ? "" : "s");
+  source_text_ref text = source_cache_get (s);
+  if (text != NULL)
+    {
+      int nlines = text->nlines ();
+
+      printf_filtered (_("Contains %d line%s.\n"), nlines,
+		       nlines == 1 ? "" : "s");
+    }
 
   printf_filtered (_("Source language is %s.\n"), language_str (s->language));
   printf_filtered (_("Producer is %s.\n"),
@@ -1136,104 +1133,6 @@ symtab_to_filename_for_display (struct symtab *symtab)
     internal_error (__FILE__, __LINE__, _("invalid filename_display_string"));
 }
 
-/* Create and initialize the table S->line_charpos that records
-   the positions of the lines in the source file, which is assumed
-   to be open on descriptor DESC.
-   All set S->nlines to the number of such lines.  */
-
-void
-find_source_lines (struct symtab *s, int desc)
-{
-  struct stat st;
-  char *p, *end;
-  int nlines = 0;
-  int lines_allocated = 1000;
-  int *line_charpos;
-  long mtime = 0;
-  int size;
-
-  gdb_assert (s);
-  line_charpos = XNEWVEC (int, lines_allocated);
-  if (fstat (desc, &st) < 0)
-    perror_with_name (symtab_to_filename_for_display (s));
-
-  if (SYMTAB_OBJFILE (s) != NULL && SYMTAB_OBJFILE (s)->obfd != NULL)
-    mtime = SYMTAB_OBJFILE (s)->mtime;
-  else if (exec_bfd)
-    mtime = exec_bfd_mtime;
-
-  if (mtime && mtime < st.st_mtime)
-    warning (_("Source file is more recent than executable."));
-
-  {
-    /* st_size might be a large type, but we only support source files whose 
-       size fits in an int.  */
-    size = (int) st.st_size;
-
-    /* Use the heap, not the stack, because this may be pretty large,
-       and we may run into various kinds of limits on stack size.  */
-    gdb::def_vector<char> data (size);
-
-    /* Reassign `size' to result of read for systems where \r\n -> \n.  */
-    size = myread (desc, data.data (), size);
-    if (size < 0)
-      perror_with_name (symtab_to_filename_for_display (s));
-    end = data.data () + size;
-    p = &data[0];
-    line_charpos[0] = 0;
-    nlines = 1;
-    while (p != end)
-      {
-	if (*p++ == '\n'
-	/* A newline at the end does not start a new line.  */
-	    && p != end)
-	  {
-	    if (nlines == lines_allocated)
-	      {
-		lines_allocated *= 2;
-		line_charpos =
-		  (int *) xrealloc ((char *) line_charpos,
-				    sizeof (int) * lines_allocated);
-	      }
-	    line_charpos[nlines++] = p - data.data ();
-	  }
-      }
-  }
-
-  s->nlines = nlines;
-  s->line_charpos =
-    (int *) xrealloc ((char *) line_charpos, nlines * sizeof (int));
-
-}
-
-
-
-/* Get full pathname and line number positions for a symtab.
-   Return nonzero if line numbers may have changed.
-   Set *FULLNAME to actual name of the file as found by `openp',
-   or to 0 if the file is not found.  */
-
-static int
-get_filename_and_charpos (struct symtab *s, char **fullname)
-{
-  int linenums_changed = 0;
-
-  scoped_fd desc (open_source_file (s));
-  if (desc.get () < 0)
-    {
-      if (fullname)
-	*fullname = NULL;
-      return 0;
-    }
-  if (fullname)
-    *fullname = s->fullname;
-  if (s->line_charpos == 0)
-    linenums_changed = 1;
-  if (linenums_changed)
-    find_source_lines (s, desc.get ());
-  return linenums_changed;
-}
-
 /* Print text describing the full name of the source file S
    and the line number LINE and its corresponding character position.
    The text starts with two Ctrl-z so that the Emacs-GDB interface
@@ -1247,14 +1146,13 @@ int
 identify_source_line (struct symtab *s, int line, int mid_statement,
 		      CORE_ADDR pc)
 {
-  if (s->line_charpos == 0)
-    get_filename_and_charpos (s, (char **) NULL);
-  if (s->fullname == 0)
+  source_text_ref text = source_cache_get (s);
+  if (text == NULL)
     return 0;
-  if (line > s->nlines)
+  if (line > text->nlines ())
     /* Don't index off the end of the line_charpos array.  */
     return 0;
-  annotate_source (s->fullname, line, s->line_charpos[line - 1],
+  annotate_source (s->fullname, line, text->line_charpos ()[line - 1],
 		   mid_statement, get_objfile_arch (SYMTAB_OBJFILE (s)), pc);
 
   current_source_line = line;
@@ -1276,6 +1174,7 @@ print_source_lines_base (struct symtab *s, int line, int stopline,
   int noprint = 0;
   int nlines = stopline - line;
   struct ui_out *uiout = current_uiout;
+  source_text_ref text;
 
   /* Regardless of whether we can open the file, set current_source_symtab.  */
   current_source_symtab = s;
@@ -1290,7 +1189,8 @@ print_source_lines_base (struct symtab *s, int line, int stopline,
       if ((s != last_source_visited) || (!last_source_error))
 	{
 	  last_source_visited = s;
-	  desc = open_source_file (s);
+	  text = source_cache_get (s);
+	  desc = text != NULL ? 0 : -1;
 	}
       else
 	{
@@ -1351,32 +1251,20 @@ print_source_lines_base (struct symtab *s, int line, int stopline,
 
   last_source_error = 0;
 
-  if (s->line_charpos == 0)
-    find_source_lines (s, desc);
-
-  if (line < 1 || line > s->nlines)
-    {
-      close (desc);
-      error (_("Line number %d out of range; %s has %d lines."),
-	     line, symtab_to_filename_for_display (s), s->nlines);
-    }
+  if (line < 1 || line > text->nlines ())
+    error (_("Line number %d out of range; %s has %d lines."),
+	   line, symtab_to_filename_for_display (s), text->nlines ());
 
-  if (lseek (desc, s->line_charpos[line - 1], 0) < 0)
-    {
-      close (desc);
-      perror_with_name (symtab_to_filename_for_display (s));
-    }
-
-  gdb_file_up stream (fdopen (desc, FDOPEN_MODE));
-  clearerr (stream.get ());
+  const char *p = text->data () + text->line_charpos ()[line - 1];
+  const char *end = text->data () + text->size ();
 
   while (nlines-- > 0)
     {
       char buf[20];
 
-      c = fgetc (stream.get ());
-      if (c == EOF)
+      if (p == end)
 	break;
+      c = (unsigned char) *p++;
       last_line_listed = current_source_line;
       if (flags & PRINT_SOURCE_LINES_FILENAME)
         {
@@ -1385,7 +1273,7 @@ print_source_lines_base (struct symtab *s, int line, int stopline,
         }
       xsnprintf (buf, sizeof (buf), "%d\t", current_source_line++);
       uiout->text (buf);
-      do
+      while (1)
 	{
 	  if (c < 040 && c != '\t' && c != '\n' && c != '\r')
 	    {
@@ -1397,23 +1285,22 @@ print_source_lines_base (struct symtab *s, int line, int stopline,
 	  else if (c == '\r')
 	    {
 	      /* Skip a \r character, but only before a \n.  */
-	      int c1 = fgetc (stream.get ());
-
-	      if (c1 != '\n')
+	      if (p == end || *p != '\n')
 		printf_filtered ("^%c", c + 0100);
-	      if (c1 != EOF)
-		ungetc (c1, stream.get ());
 	    }
 	  else
 	    {
 	      xsnprintf (buf, sizeof (buf), "%c", c);
 	      uiout->text (buf);
 	    }
+
+	  if (c == '\n' || p == end)
+	    break;
+	  c = (unsigned char) *p++;
 	}
-      while (c != '\n' && (c = fgetc (stream.get ())) >= 0);
     }
 }
-
+
 /* Show source lines from the file of symtab S, starting with line
    number LINE and stopping before line number STOPLINE.  If this is
    not the command line version, then the source is shown in the source
@@ -1535,75 +1422,61 @@ info_line_command (const char *arg, int from_tty)
 
 /* Commands to search the source file for a regexp.  */
 
-static void
-forward_search_command (const char *regex, int from_tty)
+/* Return line LINE of TEXT, for matching against a regexp.  */
+
+static std::string
+source_line_for_search (source_text *text, int line)
 {
-  int c;
-  int line;
-  char *msg;
+  off_t start = text->line_charpos ()[line - 1];
+  std::string buf (text->data () + start, text->line_end (line) - start);
 
-  line = last_line_listed + 1;
+  /* Remove the \r, if any, at the end of the line, otherwise
+     regular expressions that end with $ or \n won't work.  */
+  size_t len = buf.size ();
+  if (len > 1 && buf[len - 2] == '\r' && buf[len - 1] == '\n')
+    buf.erase (len - 2, 1);
 
-  msg = (char *) re_comp (regex);
-  if (msg)
-    error (("%s"), msg);
+  return buf;
+}
+
+/* Find the source text of the current source symtab for searching,
+   and check that LINE is within it.  */
 
+static source_text_ref
+get_source_text_for_search (int line)
+{
   if (current_source_symtab == 0)
     select_source_symtab (0);
 
-  scoped_fd desc (open_source_file (current_source_symtab));
-  if (desc.get () < 0)
+  source_text_ref text = source_cache_get (current_source_symtab);
+  if (text == NULL)
     perror_with_name (symtab_to_filename_for_display (current_source_symtab));
 
-  if (current_source_symtab->line_charpos == 0)
-    find_source_lines (current_source_symtab, desc.get ());
-
-  if (line < 1 || line > current_source_symtab->nlines)
+  if (line < 1 || line > text->nlines ())
     error (_("Expression not found"));
 
-  if (lseek (desc.get (), current_source_symtab->line_charpos[line - 1], 0)
-      < 0)
-    perror_with_name (symtab_to_filename_for_display (current_source_symtab));
+  return text;
+}
 
-  gdb_file_up stream (fdopen (desc.release (), FDOPEN_MODE));
-  clearerr (stream.get ());
-  while (1)
-    {
-      static char *buf = NULL;
-      char *p;
-      int cursize, newsize;
+static void
+forward_search_command (const char *regex, int from_tty)
+{
+  int line;
+  char *msg;
 
-      cursize = 256;
-      buf = (char *) xmalloc (cursize);
-      p = buf;
+  line = last_line_listed + 1;
 
-      c = fgetc (stream.get ());
-      if (c == EOF)
-	break;
-      do
-	{
-	  *p++ = c;
-	  if (p - buf == cursize)
-	    {
-	      newsize = cursize + cursize / 2;
-	      buf = (char *) xrealloc (buf, newsize);
-	      p = buf + cursize;
-	      cursize = newsize;
-	    }
-	}
-      while (c != '\n' && (c = fgetc (stream.get ())) >= 0);
+  msg = (char *) re_comp (regex);
+  if (msg)
+    error (("%s"), msg);
 
-      /* Remove the \r, if any, at the end of the line, otherwise
-         regular expressions that end with $ or \n won't work.  */
-      if (p - buf > 1 && p[-2] == '\r')
-	{
-	  p--;
-	  p[-1] = '\n';
-	}
+  source_text_ref text = get_source_text_for_search (line);
 
-      /* We now have a source line in buf, null terminate and match.  */
-      *p = 0;
-      if (re_exec (buf) > 0)
+  for (; line <= text->nlines (); line++)
+    {
+      std::string buf = source_line_for_search (text.get (), line);
+
+      if (re_exec (buf.c_str ()) > 0)
 	{
 	  /* Match!  */
 	  print_source_lines (current_source_symtab, line, line + 1, 0);
@@ -1611,7 +1484,6 @@ forward_search_command (const char *regex, int from_tty)
 	  current_source_line = std::max (line - lines_to_list / 2, 1);
 	  return;
 	}
-      line++;
     }
 
   printf_filtered (_("Expression not found\n"));
@@ -1620,7 +1492,6 @@ forward_search_command (const char *regex, int from_tty)
 static void
 reverse_search_command (const char *regex, int from_tty)
 {
-  int c;
   int line;
   char *msg;
 
@@ -1630,51 +1501,13 @@ reverse_search_command (const char *regex, int from_tty)
   if (msg)
     error (("%s"), msg);
 
-  if (current_source_symtab == 0)
-    select_source_symtab (0);
-
-  scoped_fd desc (open_source_file (current_source_symtab));
-  if (desc.get () < 0)
-    perror_with_name (symtab_to_filename_for_display (current_source_symtab));
-
-  if (current_source_symtab->line_charpos == 0)
-    find_source_lines (current_source_symtab, desc.get ());
-
-  if (line < 1 || line > current_source_symtab->nlines)
-    error (_("Expression not found"));
+  source_text_ref text = get_source_text_for_search (line);
 
-  if (lseek (desc.get (), current_source_symtab->line_charpos[line - 1], 0)
-      < 0)
-    perror_with_name (symtab_to_filename_for_display (current_source_symtab));
-
-  gdb_file_up stream (fdopen (desc.release (), FDOPEN_MODE));
-  clearerr (stream.get ());
-  while (line > 1)
+  for (; line > 1; line--)
     {
-/* FIXME!!!  We walk right off the end of buf if we get a long line!!!  */
-      char buf[4096];		/* Should be reasonable???  */
-      char *p = buf;
-
-      c = fgetc (stream.get ());
-      if (c == EOF)
-	break;
-      do
-	{
-	  *p++ = c;
-	}
-      while (c != '\n' && (c = fgetc (stream.get ())) >= 0);
+      std::string buf = source_line_for_search (text.get (), line);
 
-      /* Remove the \r, if any, at the end of the line, otherwise
-         regular expressions that end with $ or \n won't work.  */
-      if (p - buf > 1 && p[-2] == '\r')
-	{
-	  p--;
-	  p[-1] = '\n';
-	}
-
-      /* We now have a source line in buf; null terminate and match.  */
-      *p = 0;
-      if (re_exec (buf) > 0)
+      if (re_exec (buf.c_str ()) > 0)
 	{
 	  /* Match!  */
 	  print_source_lines (current_source_symtab, line, line + 1, 0);
@@ -1682,15 +1515,6 @@ reverse_search_command (const char *regex, int from_tty)
 	  current_source_line = std::max (line - lines_to_list / 2, 1);
 	  return;
 	}
-      line--;
-      if (fseek (stream.get (),
-		 current_source_symtab->line_charpos[line - 1], 0) < 0)
-	{
-	  const char *filename;
-
-	  filename = symtab_to_filename_for_display (current_source_symtab);
-	  perror_with_name (filename);
-	}
     }
 
   printf_filtered (_("Expression not found\n"));
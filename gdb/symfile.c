@@ -58,6 +58,7 @@
 #include "cli/cli-utils.h"
 #include "common/byte-vector.h"
 #include "selftest.h"
+#include "debug-file-cache.h"
 
 #include <sys/types.h>
 #include <fcntl.h>
@@ -1296,6 +1297,9 @@ separate_debug_file_exists (const std::string &name, unsigned long crc,
   if (separate_debug_file_debug)
     printf_unfiltered (_("  Trying %s\n"), name.c_str ());
 
+  if (!debug_file_cache_may_exist (name.c_str ()))
+    return 0;
+
   gdb_bfd_ref_ptr abfd (gdb_bfd_open (name.c_str (), gnutarget, -1));
 
   if (abfd == NULL)
@@ -66,13 +66,14 @@
 #include "filename-seen-cache.h"
 #include "arch-utils.h"
 #include <algorithm>
+#include <unordered_map>
 #include "common/pathstuff.h"
 
 /* Forward declarations for local functions.  */
 
 static void rbreak_command (const char *, int);
 
-static int find_line_common (struct linetable *, int, int *, int);
+static int find_line_common (struct symtab *, int, int *, int);
 
 static struct block_symbol
   lookup_symbol_aux (const char *name,
@@ -3335,7 +3336,7 @@ find_line_symtab (struct symtab *symtab, int line,
   /* First try looking it up in the given symtab.  */
   best_linetable = SYMTAB_LINETABLE (symtab);
   best_symtab = symtab;
-  best_index = find_line_common (best_linetable, line, &exact, 0);
+  best_index = find_line_common (symtab, line, &exact, 0);
   if (best_index < 0 || !exact)
     {
       /* Didn't find an exact match.  So we better keep looking for
@@ -3377,7 +3378,7 @@ find_line_symtab (struct symtab *symtab, int line,
 			  symtab_to_fullname (s)) != 0)
 	  continue;	
 	l = SYMTAB_LINETABLE (s);
-	ind = find_line_common (l, line, &exact, 0);
+	ind = find_line_common (s, line, &exact, 0);
 	if (ind >= 0)
 	  {
 	    if (exact)
@@ -3426,8 +3427,7 @@ find_pcs_for_symtab_line (struct symtab *symtab, int line,
       int was_exact;
       int idx;
 
-      idx = find_line_common (SYMTAB_LINETABLE (symtab), line, &was_exact,
-			      start);
+      idx = find_line_common (symtab, line, &was_exact, start);
       if (idx < 0)
 	break;
 
@@ -3513,7 +3513,60 @@ find_line_pc_range (struct symtab_and_line sal, CORE_ADDR *startptr,
   return 1;
 }
 
-/* Given a line table and a line number, return the index into the line
+/* Line tables are sorted by address, but linespecs look entries up
+   by line.  For each line table searched by line, an objfile keeps
+   the indices of its entries sorted by line, and by index within a
+   line, so that lookups need not scan the whole table.  Entries with
+   a line number of zero are left out; they never match.  The index
+   is built the first time a table is searched.  */
+
+typedef std::unordered_map<const struct linetable *, std::vector<int>>
+  linetable_index_map;
+
+static const struct objfile_data *linetable_index_key;
+
+/* Delete the line table indices of OBJFILE.  */
+
+static void
+linetable_index_cleanup (struct objfile *objfile, void *data)
+{
+  delete (linetable_index_map *) data;
+}
+
+/* Return the index of line table L, which belongs to OBJFILE.  */
+
+static const std::vector<int> &
+get_linetable_index (struct objfile *objfile, const struct linetable *l)
+{
+  linetable_index_map *map
+    = (linetable_index_map *) objfile_data (objfile, linetable_index_key);
+
+  if (map == NULL)
+    {
+      map = new linetable_index_map;
+      set_objfile_data (objfile, linetable_index_key, map);
+    }
+
+  auto found = map->find (l);
+  if (found != map->end ())
+    return found->second;
+
+  std::vector<int> &index = (*map)[l];
+
+  for (int i = 0; i < l->nitems; i++)
+    if (l->item[i].line > 0)
+      index.push_back (i);
+
+  std::stable_sort (index.begin (), index.end (),
+		    [l] (int a, int b)
+		    {
+		      return l->item[a].line < l->item[b].line;
+		    });
+
+  return index;
+}
+
+/* Given a symtab and a line number, return the index into the line
    table for the pc of the nearest line whose number is >= the specified one.
    Return -1 if none is found.  The value is >= 0 if it is an index.
    START is the index at which to start searching the line table.
@@ -3521,18 +3574,10 @@ find_line_pc_range (struct symtab_and_line sal, CORE_ADDR *startptr,
    Set *EXACT_MATCH nonzero if the value returned is an exact match.  */
 
 static int
-find_line_common (struct linetable *l, int lineno,
+find_line_common (struct symtab *symtab, int lineno,
 		  int *exact_match, int start)
 {
-  int i;
-  int len;
-
-  /* BEST is the smallest linenumber > LINENO so far seen,
-     or 0 if none has been seen so far.
-     BEST_INDEX identifies the item for it.  */
-
-  int best_index = -1;
-  int best = 0;
+  struct linetable *l = SYMTAB_LINETABLE (symtab);
 
   *exact_match = 0;
 
@@ -3541,27 +3586,39 @@ find_line_common (struct linetable *l, int lineno,
   if (l == 0)
     return -1;
 
-  len = l->nitems;
-  for (i = start; i < len; i++)
-    {
-      struct linetable_entry *item = &(l->item[i]);
-
-      if (item->line == lineno)
+  const std::vector<int> &index
+    = get_linetable_index (SYMTAB_OBJFILE (symtab), l);
+  auto end = index.end ();
+
+  /* Look at the lines >= LINENO in order.  The first entry at or
+     after START for one of them is the best: the first (lowest
+     address) one for LINENO itself, else the first one for the
+     smallest line above it.  */
+  auto group = std::lower_bound (index.begin (), end, lineno,
+				 [l] (int i, int line)
+				 {
+				   return l->item[i].line < line;
+				 });
+  while (group != end)
+    {
+      int line = l->item[*group].line;
+      auto group_end = std::upper_bound (group, end, line,
+					 [l] (int line, int i)
+					 {
+					   return line < l->item[i].line;
+					 });
+      auto found = std::lower_bound (group, group_end, start);
+
+      if (found != group_end)
 	{
-	  /* Return the first (lowest address) entry which matches.  */
-	  *exact_match = 1;
-	  return i;
+	  *exact_match = line == lineno;
+	  return *found;
 	}
 
-      if (item->line > lineno && (best == 0 || item->line < best))
-	{
-	  best = item->line;
-	  best_index = i;
-	}
+      group = group_end;
     }
 
-  /* If we got here, we didn't get an exact match.  */
-  return best_index;
+  return -1;
 }
 
 int
@@ -4265,14 +4322,168 @@ symbol_search::compare_search_syms (const symbol_search &sym_a,
 		 SYMBOL_PRINT_NAME (sym_b.symbol));
 }
 
+/* The key symbol_search::compare_search_syms sorts on, computed once
+   per symbol rather than once per comparison.  */
+
+struct search_symbols_sort_key
+{
+  const char *filename;
+  int block;
+  const char *name;
+
+  /* Index of the symbol in the vector being sorted.  */
+  size_t index;
+
+  bool operator< (const search_symbols_sort_key &other) const
+  {
+    int c = FILENAME_CMP (filename, other.filename);
+
+    if (c != 0)
+      return c < 0;
+    if (block != other.block)
+      return block < other.block;
+    return strcmp (name, other.name) < 0;
+  }
+
+  bool operator== (const search_symbols_sort_key &other) const
+  {
+    return (block == other.block
+	    && strcmp (name, other.name) == 0
+	    && FILENAME_CMP (filename, other.filename) == 0);
+  }
+};
+
 /* Sort the symbols in RESULT and remove duplicates.  */
 
 static void
 sort_search_symbols_remove_dups (std::vector<symbol_search> *result)
 {
-  std::sort (result->begin (), result->end ());
-  result->erase (std::unique (result->begin (), result->end ()),
-		 result->end ());
+  std::vector<search_symbols_sort_key> keys;
+
+  keys.reserve (result->size ());
+  for (size_t i = 0; i < result->size (); ++i)
+    {
+      const symbol_search &p = (*result)[i];
+
+      keys.push_back ({symbol_symtab (p.symbol)->filename, p.block,
+		       SYMBOL_PRINT_NAME (p.symbol), i});
+    }
+
+  std::sort (keys.begin (), keys.end ());
+  keys.erase (std::unique (keys.begin (), keys.end ()), keys.end ());
+
+  std::vector<symbol_search> sorted;
+  sorted.reserve (keys.size ());
+  for (const search_symbols_sort_key &key : keys)
+    sorted.push_back ((*result)[key.index]);
+  *result = std::move (sorted);
+}
+
+/* Matches symbol names against the regexp given to search_symbols.
+   Most regexps are a plain word, maybe anchored at either end, as in
+   "info functions ^foo".  Those are matched with strncmp or strstr,
+   which is much cheaper than running the regexp engine on every name
+   in the program.  Other regexps are compiled once.  */
+
+class search_symbols_matcher
+{
+public:
+
+  search_symbols_matcher (const char *regexp, int cflags);
+
+  DISABLE_COPY_AND_ASSIGN (search_symbols_matcher);
+
+  /* Return true if NAME matches.  */
+  bool matches (const char *name) const;
+
+private:
+
+  enum kind
+  {
+    MATCH_EXACT,
+    MATCH_PREFIX,
+    MATCH_SUFFIX,
+    MATCH_SUBSTRING,
+    MATCH_REGEXP,
+  };
+
+  enum kind m_kind;
+
+  /* For all kinds but MATCH_REGEXP, the string to look for.  */
+  std::string m_literal;
+
+  /* For MATCH_REGEXP, the compiled regexp.  */
+  gdb::optional<compiled_regex> m_regex;
+};
+
+search_symbols_matcher::search_symbols_matcher (const char *regexp,
+						int cflags)
+{
+  const char *start = regexp;
+  const char *end = regexp + strlen (regexp);
+  bool anchored_start = false;
+  bool anchored_end = false;
+
+  if (*start == '^')
+    {
+      anchored_start = true;
+      ++start;
+    }
+  if (end > start && end[-1] == '$')
+    {
+      anchored_end = true;
+      --end;
+    }
+
+  /* Anything that may be special to the regexp engine, in either
+     basic or extended syntax, is left to it.  */
+  bool literal = (cflags & REG_ICASE) == 0 && start < end;
+  for (const char *p = start; literal && p < end; ++p)
+    if (strchr (".[]*^$\\+?(){}|", *p) != NULL || !isprint ((unsigned char) *p))
+      literal = false;
+
+  if (!literal)
+    {
+      m_kind = MATCH_REGEXP;
+      m_regex.emplace (regexp, cflags, _("Invalid regexp"));
+      return;
+    }
+
+  m_literal.assign (start, end - start);
+  if (anchored_start && anchored_end)
+    m_kind = MATCH_EXACT;
+  else if (anchored_start)
+    m_kind = MATCH_PREFIX;
+  else if (anchored_end)
+    m_kind = MATCH_SUFFIX;
+  else
+    m_kind = MATCH_SUBSTRING;
+}
+
+bool
+search_symbols_matcher::matches (const char *name) const
+{
+  switch (m_kind)
+    {
+    case MATCH_EXACT:
+      return strcmp (name, m_literal.c_str ()) == 0;
+    case MATCH_PREFIX:
+      return strncmp (name, m_literal.c_str (), m_literal.size ()) == 0;
+    case MATCH_SUFFIX:
+      {
+	size_t len = strlen (name);
+
+	return (len >= m_literal.size ()
+		&& strcmp (name + len - m_literal.size (),
+			   m_literal.c_str ()) == 0);
+      }
+    case MATCH_SUBSTRING:
+      return strstr (name, m_literal.c_str ()) != NULL;
+    case MATCH_REGEXP:
+      return m_regex->exec (name, 0, NULL, 0) == 0;
+    }
+
+  gdb_assert_not_reached ("unhandled search_symbols_matcher kind");
 }
 
 /* Search the symbol table for matches to the regular expression REGEXP,
@@ -4315,7 +4526,7 @@ search_symbols (const char *regexp, enum search_domain kind,
   enum minimal_symbol_type ourtype3;
   enum minimal_symbol_type ourtype4;
   std::vector<symbol_search> result;
-  gdb::optional<compiled_regex> preg;
+  gdb::optional<search_symbols_matcher> matcher;
 
   gdb_assert (kind <= TYPES_DOMAIN);
 
@@ -4362,7 +4573,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 
       int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
 				? REG_ICASE : 0);
-      preg.emplace (regexp, cflags, _("Invalid regexp"));
+      matcher.emplace (regexp, cflags);
     }
 
   /* Search through the partial symtabs *first* for all symbols
@@ -4376,8 +4587,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 			   lookup_name_info::match_any (),
 			   [&] (const char *symname)
 			   {
-			     return (!preg || preg->exec (symname,
-							  0, NULL, 0) == 0);
+			     return !matcher || matcher->matches (symname);
 			   },
 			   NULL,
 			   kind);
@@ -4412,9 +4622,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 	    || MSYMBOL_TYPE (msymbol) == ourtype3
 	    || MSYMBOL_TYPE (msymbol) == ourtype4)
 	  {
-	    if (!preg
-		|| preg->exec (MSYMBOL_NATURAL_NAME (msymbol), 0,
-			       NULL, 0) == 0)
+	    if (!matcher || matcher->matches (MSYMBOL_NATURAL_NAME (msymbol)))
 	      {
 		/* Note: An important side-effect of these lookup functions
 		   is to expand the symbol table if msymbol is found, for the
@@ -4451,9 +4659,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 				       files, nfiles, 1))
 		     && file_matches (symtab_to_fullname (real_symtab),
 				      files, nfiles, 0)))
-		&& ((!preg
-		     || preg->exec (SYMBOL_NATURAL_NAME (sym), 0,
-				    NULL, 0) == 0)
+		&& ((!matcher || matcher->matches (SYMBOL_NATURAL_NAME (sym)))
 		    && ((kind == VARIABLES_DOMAIN
 			 && SYMBOL_CLASS (sym) != LOC_TYPEDEF
 			 && SYMBOL_CLASS (sym) != LOC_UNRESOLVED
@@ -4496,8 +4702,7 @@ search_symbols (const char *regexp, enum search_domain kind,
 	    || MSYMBOL_TYPE (msymbol) == ourtype3
 	    || MSYMBOL_TYPE (msymbol) == ourtype4)
 	  {
-	    if (!preg || preg->exec (MSYMBOL_NATURAL_NAME (msymbol), 0,
-				     NULL, 0) == 0)
+	    if (!matcher || matcher->matches (MSYMBOL_NATURAL_NAME (msymbol)))
 	      {
 		/* For functions we can do a quick check of whether the
 		   symbol might be found via find_pc_symtab.  */
@@ -4703,6 +4908,7 @@ rbreak_command (const char *regexp, int from_tty)
 						       nfiles, files);
 
   scoped_rbreak_breakpoints finalize;
+  scoped_defer_location_list_update defer_update;
   for (const symbol_search &p : symbols)
     {
       if (p.msymbol.minsym == NULL)
@@ -5389,6 +5595,16 @@ add_filename_to_list (const char *fname, const char *text, const char *word,
   list->emplace_back (make_completion_match_str (fname, text, word));
 }
 
+/* Return true if LIST already holds more file names than
+   max-completions allows.  Completing those is enough for the caller
+   to hit the limit, so there is no point in looking for more.  */
+
+static bool
+source_files_completion_list_full (const completion_list &list)
+{
+  return max_completions >= 0 && list.size () > (size_t) max_completions;
+}
+
 static int
 not_interesting_fname (const char *fname)
 {
@@ -5426,7 +5642,8 @@ maybe_add_partial_symtab_filename (const char *filename, const char *fullname,
   struct add_partial_filename_data *data
     = (struct add_partial_filename_data *) user_data;
 
-  if (not_interesting_fname (filename))
+  if (not_interesting_fname (filename)
+      || source_files_completion_list_full (*data->list))
     return;
   if (!data->filename_seen_cache->seen (filename)
       && filename_ncmp (filename, data->text, data->text_len) == 0)
@@ -5468,6 +5685,8 @@ make_source_files_completion_list (const char *text, const char *word)
 
   ALL_FILETABS (objfile, cu, s)
     {
+      if (source_files_completion_list_full (list))
+	return list;
       if (not_interesting_fname (s->filename))
 	continue;
       if (!filenames_seen.seen (s->filename)
@@ -5901,6 +6120,9 @@ _initialize_symtab (void)
   symbol_cache_key
     = register_program_space_data_with_cleanup (NULL, symbol_cache_cleanup);
 
+  linetable_index_key
+    = register_objfile_data_with_cleanup (NULL, linetable_index_cleanup);
+
   add_info ("variables", info_variables_command, _("\
 All global and static variable names, or those matching REGEXP."));
   if (dbx_commands)
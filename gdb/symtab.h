@@ -1326,16 +1326,6 @@ struct symtab
 
   const char *filename;
 
-  /* Total number of lines found in source file.  */
-
-  int nlines;
-
-  /* line_charpos[N] is the position of the (N-1)th line of the
-     source file.  "position" means something we can lseek() to; it
-     is not guaranteed to be useful any other way.  */
-
-  int *line_charpos;
-
   /* Language of this source file.  */
 
   enum language language;
@@ -1841,7 +1831,8 @@ struct symtab_and_line
   struct symbol *symbol = NULL;
   struct obj_section *section = NULL;
   struct minimal_symbol *msymbol = NULL;
-  /* Line number.  Line numbers start at 1 and proceed through symtab->nlines.
+  /* Line number.  Line numbers start at 1 and proceed through the number
+     of lines in the source file.
      0 is never a valid line number; it is used to indicate that line number
      information is not available.  */
   int line = 0;
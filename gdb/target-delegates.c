@@ -22,6 +22,9 @@ struct dummy_target : public target_ops
   void files_info () override;
   int insert_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1) override;
   int remove_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1, enum remove_bp_reason arg2) override;
+  void begin_breakpoint_batch () override;
+  void end_breakpoint_batch (std::vector<bp_target_info *> *arg0) override;
+  bool keep_breakpoints_inserted () override;
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
   bool stopped_by_hw_breakpoint () override;
@@ -93,6 +96,7 @@ struct dummy_target : public target_ops
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
   ULONGEST get_memory_xfer_limit () override;
+  void read_memory_list (std::vector<memory_read_request> *arg0) override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
@@ -190,6 +194,9 @@ struct debug_target : public target_ops
   void files_info () override;
   int insert_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1) override;
   int remove_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1, enum remove_bp_reason arg2) override;
+  void begin_breakpoint_batch () override;
+  void end_breakpoint_batch (std::vector<bp_target_info *> *arg0) override;
+  bool keep_breakpoints_inserted () override;
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
   bool stopped_by_hw_breakpoint () override;
@@ -261,6 +268,7 @@ struct debug_target : public target_ops
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
   ULONGEST get_memory_xfer_limit () override;
+  void read_memory_list (std::vector<memory_read_request> *arg0) override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
@@ -631,6 +639,72 @@ debug_target::remove_breakpoint (struct gdbarch *arg0, struct bp_target_info *ar
   return result;
 }
 
+void
+target_ops::begin_breakpoint_batch ()
+{
+  this->beneath ()->begin_breakpoint_batch ();
+}
+
+void
+dummy_target::begin_breakpoint_batch ()
+{
+}
+
+void
+debug_target::begin_breakpoint_batch ()
+{
+  fprintf_unfiltered (gdb_stdlog, "-> %s->begin_breakpoint_batch (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->begin_breakpoint_batch ();
+  fprintf_unfiltered (gdb_stdlog, "<- %s->begin_breakpoint_batch (", this->beneath ()->shortname ());
+  fputs_unfiltered (")\n", gdb_stdlog);
+}
+
+void
+target_ops::end_breakpoint_batch (std::vector<bp_target_info *> *arg0)
+{
+  this->beneath ()->end_breakpoint_batch (arg0);
+}
+
+void
+dummy_target::end_breakpoint_batch (std::vector<bp_target_info *> *arg0)
+{
+}
+
+void
+debug_target::end_breakpoint_batch (std::vector<bp_target_info *> *arg0)
+{
+  fprintf_unfiltered (gdb_stdlog, "-> %s->end_breakpoint_batch (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->end_breakpoint_batch (arg0);
+  fprintf_unfiltered (gdb_stdlog, "<- %s->end_breakpoint_batch (", this->beneath ()->shortname ());
+  target_debug_print_std_vector_bp_target_info_p_p (arg0);
+  fputs_unfiltered (")\n", gdb_stdlog);
+}
+
+bool
+target_ops::keep_breakpoints_inserted ()
+{
+  return this->beneath ()->keep_breakpoints_inserted ();
+}
+
+bool
+dummy_target::keep_breakpoints_inserted ()
+{
+  return false;
+}
+
+bool
+debug_target::keep_breakpoints_inserted ()
+{
+  bool result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->keep_breakpoints_inserted (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->keep_breakpoints_inserted ();
+  fprintf_unfiltered (gdb_stdlog, "<- %s->keep_breakpoints_inserted (", this->beneath ()->shortname ());
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
 bool
 target_ops::stopped_by_sw_breakpoint ()
 {
@@ -2437,6 +2511,28 @@ debug_target::get_memory_xfer_limit ()
   return result;
 }
 
+void
+target_ops::read_memory_list (std::vector<memory_read_request> *arg0)
+{
+  this->beneath ()->read_memory_list (arg0);
+}
+
+void
+dummy_target::read_memory_list (std::vector<memory_read_request> *arg0)
+{
+  default_read_memory_list (this, arg0);
+}
+
+void
+debug_target::read_memory_list (std::vector<memory_read_request> *arg0)
+{
+  fprintf_unfiltered (gdb_stdlog, "-> %s->read_memory_list (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->read_memory_list (arg0);
+  fprintf_unfiltered (gdb_stdlog, "<- %s->read_memory_list (", this->beneath ()->shortname ());
+  target_debug_print_std_vector_memory_read_request_p (arg0);
+  fputs_unfiltered (")\n", gdb_stdlog);
+}
+
 std::vector<mem_region>
 target_ops::memory_map ()
 {
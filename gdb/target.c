@@ -71,6 +71,9 @@ static int default_follow_fork (struct target_ops *self, int follow_child,
 
 static void default_mourn_inferior (struct target_ops *self);
 
+static void default_read_memory_list
+  (struct target_ops *self, std::vector<memory_read_request> *requests);
+
 static int default_search_memory (struct target_ops *ops,
 				  CORE_ADDR start_addr,
 				  ULONGEST search_space_len,
@@ -954,17 +957,11 @@ struct target_section *
 target_section_by_addr (struct target_ops *target, CORE_ADDR addr)
 {
   struct target_section_table *table = target_get_section_table (target);
-  struct target_section *secp;
 
   if (table == NULL)
     return NULL;
 
-  for (secp = table->sections; secp < table->sections_end; secp++)
-    {
-      if (addr >= secp->addr && addr < secp->endaddr)
-	return secp;
-    }
-  return NULL;
+  return target_section_table_lookup (table, addr);
 }
 
 
@@ -1100,9 +1097,7 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
 	  memaddr = overlay_mapped_address (memaddr, section);
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len, xfered_len,
-						    table->sections,
-						    table->sections_end,
-						    section_name);
+						    table, section_name);
 	}
     }
 
@@ -1121,9 +1116,7 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
 	  table = target_get_section_table (ops);
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len, xfered_len,
-						    table->sections,
-						    table->sections_end,
-						    NULL);
+						    table, NULL);
 	}
     }
 
@@ -1224,6 +1217,18 @@ make_scoped_restore_show_memory_breakpoints (int show)
   return make_scoped_restore (&show_memory_breakpoints, show);
 }
 
+/* Number of writes to a target; see get_target_write_generation.  */
+
+static unsigned int target_write_generation;
+
+/* See target.h.  */
+
+unsigned int
+get_target_write_generation (void)
+{
+  return target_write_generation;
+}
+
 /* For docs see target.h, to_xfer_partial.  */
 
 enum target_xfer_status
@@ -1243,6 +1248,9 @@ target_xfer_partial (struct target_ops *ops,
     error (_("Writing to memory is not allowed (addr %s, len %s)"),
 	   core_addr_to_string_nz (offset), plongest (len));
 
+  if (writebuf != NULL)
+    ++target_write_generation;
+
   *xfered_len = 0;
 
   /* If this is a memory transfer, let the memory-specific code
@@ -1376,6 +1384,33 @@ target_read_raw_memory (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* The default implementation of the read_memory_list target method:
+   read each request on its own.  */
+
+static void
+default_read_memory_list (struct target_ops *self,
+			  std::vector<memory_read_request> *requests)
+{
+  for (memory_read_request &r : *requests)
+    r.ok = target_read_raw_memory (r.addr, r.buf, r.len) == 0;
+}
+
+/* See target.h.  */
+
+void
+target_read_raw_memory_list (std::vector<memory_read_request> *requests)
+{
+  struct target_ops *top = current_top_target ();
+
+  /* Layers above the process stratum (e.g., record targets replaying
+     the execution history) may need to see every memory read, and
+     do not implement the method themselves.  */
+  if (top->to_stratum > process_stratum)
+    default_read_memory_list (top, requests);
+  else
+    top->read_memory_list (requests);
+}
+
 /* Like target_read_memory, but specify explicitly that this is a read from
    the target's stack.  This may trigger different cache behavior.  */
 
@@ -3512,6 +3547,7 @@ target_store_registers (struct regcache *regcache, int regno)
   if (!may_write_registers)
     error (_("Writing to registers is not allowed (regno %d)"), regno);
 
+  ++target_write_generation;
   current_top_target ()->store_registers (regcache, regno);
   if (targetdebug)
     {
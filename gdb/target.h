@@ -292,6 +292,21 @@ struct memory_read_result
   gdb::unique_xmalloc_ptr<gdb_byte> data;
 };
 
+/* One of the ranges read by target_read_raw_memory_list.  */
+
+struct memory_read_request
+{
+  /* The range to read.  */
+  CORE_ADDR addr;
+  ULONGEST len;
+
+  /* Where to store the contents.  */
+  gdb_byte *buf;
+
+  /* Set to true if the whole range was read.  */
+  bool ok;
+};
+
 extern std::vector<memory_read_result> read_memory_robust
     (struct target_ops *ops, const ULONGEST offset, const LONGEST len);
 
@@ -495,6 +510,25 @@ struct target_ops
 				 enum remove_bp_reason)
       TARGET_DEFAULT_NORETURN (noprocess ());
 
+    /* Breakpoint insertions and removals requested between calls to
+       these two methods may be queued by the target, and sent to the
+       remote side in as few requests as possible.  A queued request
+       reports success when made; END_BREAKPOINT_BATCH sends whatever
+       is still queued, and appends to FAILED the breakpoints whose
+       queued insertion or removal did not succeed.  */
+    virtual void begin_breakpoint_batch ()
+      TARGET_DEFAULT_IGNORE ();
+    virtual void end_breakpoint_batch (std::vector<bp_target_info *> *failed)
+      TARGET_DEFAULT_IGNORE ();
+
+    /* Return true if breakpoints should be left inserted while all
+       threads are stopped, as if "set breakpoint always-inserted on"
+       were in effect.  For targets where inserting and removing
+       breakpoints is expensive, and inserted breakpoints are not
+       visible in memory reads.  */
+    virtual bool keep_breakpoints_inserted ()
+      TARGET_DEFAULT_RETURN (false);
+
     /* Returns true if the target stopped because it executed a
        software breakpoint.  This is necessary for correct background
        execution / non-stop mode operation, and for correct PC
@@ -772,6 +806,13 @@ struct target_ops
     virtual ULONGEST get_memory_xfer_limit ()
       TARGET_DEFAULT_RETURN (ULONGEST_MAX);
 
+    /* Read each of REQUESTS from raw memory, setting their OK field.
+       Targets that can fetch several scattered ranges in one
+       exchange override this; the default reads them one at a
+       time.  */
+    virtual void read_memory_list (std::vector<memory_read_request> *requests)
+      TARGET_DEFAULT_FUNC (default_read_memory_list);
+
     /* Returns the memory map for the target.  A return value of NULL
        means that no memory map is available.  If a memory address
        does not fall within any returned regions, it's assumed to be
@@ -1430,6 +1471,13 @@ extern void target_fetch_registers (struct regcache *regcache, int regno);
 
 extern void target_store_registers (struct regcache *regcache, int regs);
 
+/* Return the number of times GDB has asked a target to write to its
+   registers, memory or other objects.  The inferior's state can only
+   have been changed by GDB while it is stopped if this number has
+   changed.  */
+
+extern unsigned int get_target_write_generation (void);
+
 /* Get ready to modify the registers array.  On machines which store
    individual registers, this doesn't need to do anything.  On machines
    which store all the registers in one fell swoop, this makes sure
@@ -1492,6 +1540,12 @@ extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 extern int target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr,
 				    ssize_t len);
 
+/* Read each of REQUESTS from raw memory, in as few target requests
+   as possible, setting their OK field.  */
+
+extern void target_read_raw_memory_list
+  (std::vector<memory_read_request> *requests);
+
 /* Fetches the target's memory map.  If one is found it is sorted
    and returned, after some consistency checking.  Otherwise, NULL
    is returned.  */
@@ -1573,6 +1627,21 @@ extern int target_remove_breakpoint (struct gdbarch *gdbarch,
 				     struct bp_target_info *bp_tgt,
 				     enum remove_bp_reason reason);
 
+/* Start and end a batch of breakpoint insertions and removals.  See
+   target_ops::begin_breakpoint_batch.  */
+
+#define target_begin_breakpoint_batch() \
+  (current_top_target ()->begin_breakpoint_batch) ()
+
+#define target_end_breakpoint_batch(failed) \
+  (current_top_target ()->end_breakpoint_batch) (failed)
+
+/* Return true if breakpoints should stay inserted while the inferior
+   is stopped.  */
+
+#define target_keep_breakpoints_inserted() \
+  (current_top_target ()->keep_breakpoints_inserted) ()
+
 /* Return true if the target stack has a non-default
   "terminal_ours" method.  */
 
@@ -2362,6 +2431,13 @@ struct target_section_table
 {
   struct target_section *sections;
   struct target_section *sections_end;
+
+  /* An index of SECTIONS sorted by start address, built on demand by
+     target_section_table_lookup.  Each entry holds the position of a
+     section in SECTIONS, and the highest end address of that section
+     and of all the entries before it.  Must be cleared whenever the
+     table changes.  */
+  std::vector<std::pair<int, CORE_ADDR>> addr_index;
 };
 
 /* Return the "section" containing the specified address.  */
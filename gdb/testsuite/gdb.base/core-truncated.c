@@ -0,0 +1,34 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Large enough for GDB to map its contents from the core file, and
+   for the buffer to get a mapping, and a core file section, of its
+   own.  */
+#define BUF_SIZE (1024 * 1024)
+
+char *buf;
+
+int
+main (void)
+{
+  buf = malloc (BUF_SIZE);
+  memset (buf, 'x', BUF_SIZE);
+  return 0; /* break here */
+}
@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Many pages, most of them zero, so that the core file has holes
+   between the pages that are written.  */
+#define PAGES 64
+#define PAGE 4096
+
+char big_array[PAGES * PAGE];
+char *heap_buffer;
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < PAGES; i += 7)
+    big_array[i * PAGE + i] = i + 1;
+  big_array[PAGES * PAGE - 1] = 0x5a;
+
+  heap_buffer = malloc (PAGES * PAGE);
+  memset (heap_buffer, 0, PAGES * PAGE);
+  strcpy (heap_buffer + 5 * PAGE, "after zero pages");
+
+  return 0;	/* Break here.  */
+}
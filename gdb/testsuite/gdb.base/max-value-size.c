@@ -19,8 +19,30 @@ char one;
 char ten[10];
 char one_hundred[100];
 
+struct tail_array
+{
+  int n;
+  int data[100];
+} tail_array;
+
+struct middle_array
+{
+  int data[100];
+  int n;
+} middle_array, zero_middle_array;
+
 int
 main (void)
 {
-  return 0;
+  int i;
+
+  for (i = 0; i < 100; i++)
+    {
+      tail_array.data[i] = i;
+      middle_array.data[i] = i;
+    }
+  tail_array.n = -1;
+  middle_array.n = -1;
+
+  return 0; /* Break here.  */
 }
@@ -0,0 +1,37 @@
+/* Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int lib2_value;
+
+int
+lib2_func (int arg)
+{
+  lib2_value = arg;
+  return lib2_value;
+}
+
+/* A function of the same name as one in the first library.  */
+
+static int
+common_func (void)
+{
+  return 2;
+}
+
+int
+lib2_common (void)
+{
+  return common_func ();
+}
@@ -0,0 +1,54 @@
+/* Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <assert.h>
+#include <stddef.h>
+
+/* The handles of the two libraries.  The libraries are built from the
+   same source and their names have the same length, so the dynamic
+   linker is likely to give the second one the link map and name
+   buffer freed by the first.  */
+
+void *handle1, *handle2;
+
+void
+stop (void)
+{
+}
+
+int
+main (void)
+{
+  handle1 = dlopen (SHLIB1_NAME, RTLD_LAZY);
+  assert (handle1 != NULL);
+  stop ();
+
+  dlclose (handle1);
+  stop ();
+
+  handle2 = dlopen (SHLIB2_NAME, RTLD_LAZY);
+  assert (handle2 != NULL);
+  stop ();
+
+  dlclose (handle2);
+  stop ();
+
+  handle1 = dlopen (SHLIB1_NAME, RTLD_LAZY);
+  assert (handle1 != NULL);
+  stop ();
+
+  return 0;
+}
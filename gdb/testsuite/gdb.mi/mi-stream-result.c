@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Keep in sync with the .exp file.  */
+#define BUF_SIZE (256 * 1024)
+
+char *buf;
+
+int
+main (void)
+{
+  long page = sysconf (_SC_PAGESIZE);
+
+  buf = mmap (NULL, BUF_SIZE + page, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buf == MAP_FAILED)
+    return 1;
+  memset (buf, 0x5a, BUF_SIZE);
+
+  /* Leave nothing to read right after the buffer.  */
+  munmap (buf + BUF_SIZE, page);
+
+  return 0; /* break here */
+}
@@ -0,0 +1,55 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+
+/* Incremented by the worker thread while it runs.  */
+volatile int counter;
+
+void *
+worker (void *arg)
+{
+  for (;;)
+    {
+      counter++;
+      usleep (1000);
+    }
+  return NULL;
+}
+
+void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t thread;
+
+  pthread_create (&thread, NULL, worker, NULL);
+
+  /* Wait for the worker to start counting.  */
+  while (counter == 0)
+    usleep (1000);
+
+  break_here ();
+
+  pthread_join (thread, NULL);
+  return 0;
+}
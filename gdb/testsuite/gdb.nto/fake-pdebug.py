@@ -0,0 +1,877 @@
+# Copyright 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# A stand-in for the QNX pdebug agent, for testing remote-nto.c on an
+# x86-64 GNU/Linux host.  It speaks the DS protocol described in
+# nto-share/dsmsgs.h on stdin/stdout, so that GDB can use it with
+# "target qnx | python3 fake-pdebug.py PROGRAM", and runs PROGRAM (a
+# static x86-64 executable) under ptrace, presenting it as QNX
+# process/thread 1 of whatever pid GDB attaches to.
+#
+# Breakpoints are kept out of memory reads, and their agent expressions
+# are evaluated here, as a pdebug implementing protover 0.11 does.
+# Options make it claim an older protocol version or reject parts of
+# it, and --log records the requests it handles so that tests can
+# check which ones GDB sent.
+
+import argparse
+import ctypes
+import os
+import re
+import signal
+import struct
+import sys
+
+# Framing.
+FRAME_CHAR = 0x7e
+ESC_CHAR = 0x7d
+
+SET_CHANNEL_DEBUG = 1
+SET_CHANNEL_TEXT = 2
+
+# Messages.
+DStMsg_connect = 0
+DStMsg_disconnect = 1
+DStMsg_select = 2
+DStMsg_attach = 5
+DStMsg_detach = 6
+DStMsg_kill = 7
+DStMsg_stop = 8
+DStMsg_memrd = 9
+DStMsg_memwr = 10
+DStMsg_regrd = 11
+DStMsg_regwr = 12
+DStMsg_run = 13
+DStMsg_brk = 14
+DStMsg_pidlist = 19
+DStMsg_protover = 23
+DStMsg_handlesig = 24
+DStMsg_cpuinfo = 25
+DSrMsg_err = 32
+DSrMsg_ok = 33
+DSrMsg_okstatus = 34
+DSrMsg_okdata = 35
+DShMsg_notify = 64
+
+DSMSG_SELECT_QUERY = 1
+DSMSG_RUN = 0
+DSMSG_RUN_COUNT = 1
+DSMSG_RUN_RANGE = 2
+DSMSG_PIDLIST_SPECIFIC = 2
+DSMSG_PIDLIST_SPECIFIC_TID = 3
+
+DSMSG_MEMRD_LIST = 0x01
+
+DSMSG_BRK_EXEC = 0x01
+DSMSG_BRK_LIST = 0x20
+DSMSG_BRK_AGENT = 0x40
+
+DSMSG_NOTIFY_PIDUNLOAD = 3
+DSMSG_NOTIFY_BRK = 6
+DSMSG_NOTIFY_STEP = 7
+DSMSG_NOTIFY_SIGEV = 8
+
+X86_64_CPU_FXSR = 1 << 12
+
+EINVAL = 22
+EIO = 5
+ESRCH = 3
+
+# Ptrace.
+PTRACE_TRACEME = 0
+PTRACE_CONT = 7
+PTRACE_KILL = 8
+PTRACE_SINGLESTEP = 9
+PTRACE_GETREGS = 12
+PTRACE_SETREGS = 13
+PTRACE_GETFPREGS = 14
+PTRACE_SETFPREGS = 15
+PTRACE_DETACH = 17
+
+ADDR_NO_RANDOMIZE = 0x0040000
+
+LINUX_REGS = ['r15', 'r14', 'r13', 'r12', 'rbp', 'rbx', 'r11', 'r10',
+              'r9', 'r8', 'rax', 'rcx', 'rdx', 'rsi', 'rdi', 'orig_rax',
+              'rip', 'cs', 'eflags', 'rsp', 'ss', 'fs_base', 'gs_base',
+              'ds', 'es', 'fs', 'gs']
+
+# The QNX x86_64 general register set, see amd64-nto-tdep.h.
+QNX_REGS = ['rdi', 'rsi', 'rdx', 'r10', 'r8', 'r9', 'rax', 'rbx', 'rbp',
+            'rcx', 'r11', 'r12', 'r13', 'r14', 'r15', 'rip', 'cs',
+            'eflags', 'rsp', 'ss']
+
+# GDB's amd64 register numbers, as used by the "reg" bytecode.
+GDB_REGS = ['rax', 'rbx', 'rcx', 'rdx', 'rsi', 'rdi', 'rbp', 'rsp',
+            'r8', 'r9', 'r10', 'r11', 'r12', 'r13', 'r14', 'r15',
+            'rip', 'eflags']
+
+# Linux signal numbers to QNX ones, where they differ.
+LINUX_TO_QNX_SIG = {7: 10, 10: 16, 12: 17, 17: 18, 18: 25, 19: 23,
+                    20: 24, 28: 20}
+QNX_TO_LINUX_SIG = {q: l for l, q in LINUX_TO_QNX_SIG.items()}
+
+MASK64 = (1 << 64) - 1
+
+libc = ctypes.CDLL(None, use_errno=True)
+libc.ptrace.argtypes = [ctypes.c_long, ctypes.c_long, ctypes.c_void_p,
+                        ctypes.c_void_p]
+libc.ptrace.restype = ctypes.c_long
+
+
+class UserRegs(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_ulonglong) for name in LINUX_REGS]
+
+
+class AgentError(Exception):
+    pass
+
+
+def ptrace(request, pid, addr=0, data=0):
+    ret = libc.ptrace(request, pid, addr, data)
+    if ret == -1:
+        err = ctypes.get_errno()
+        raise OSError(err, os.strerror(err))
+    return ret
+
+
+def signed(value, bits=64):
+    value &= (1 << bits) - 1
+    if value & (1 << (bits - 1)):
+        value -= 1 << bits
+    return value
+
+
+class Inferior(object):
+    """The traced program."""
+
+    def __init__(self, argv):
+        self.pid = os.fork()
+        if self.pid == 0:
+            # Keep the program's output off the protocol stream.
+            devnull = os.open(os.devnull, os.O_RDONLY)
+            os.dup2(devnull, 0)
+            os.dup2(2, 1)
+            libc.personality(ADDR_NO_RANDOMIZE)
+            libc.ptrace(PTRACE_TRACEME, 0, None, None)
+            os.execv(argv[0], argv)
+            os._exit(127)
+        _, status = os.waitpid(self.pid, 0)
+        if not os.WIFSTOPPED(status):
+            sys.exit("fake-pdebug: could not start %s" % argv[0])
+        self.mem = os.open("/proc/%d/mem" % self.pid, os.O_RDWR)
+        self.alive = True
+
+    def get_regs(self):
+        regs = UserRegs()
+        ptrace(PTRACE_GETREGS, self.pid, 0, ctypes.addressof(regs))
+        return regs
+
+    def set_regs(self, regs):
+        ptrace(PTRACE_SETREGS, self.pid, 0, ctypes.addressof(regs))
+
+    def get_fpregs(self):
+        buf = ctypes.create_string_buffer(512)
+        ptrace(PTRACE_GETFPREGS, self.pid, 0, ctypes.addressof(buf))
+        return buf.raw
+
+    def set_fpregs(self, data):
+        buf = ctypes.create_string_buffer(data, 512)
+        ptrace(PTRACE_SETFPREGS, self.pid, 0, ctypes.addressof(buf))
+
+    def pc(self):
+        return self.get_regs().rip
+
+    def set_pc(self, pc):
+        regs = self.get_regs()
+        regs.rip = pc
+        self.set_regs(regs)
+
+    def read(self, addr, size):
+        return os.pread(self.mem, size, addr)
+
+    def write(self, addr, data):
+        return os.pwrite(self.mem, data, addr)
+
+    def resume(self, request, sig):
+        ptrace(request, self.pid, 0, QNX_TO_LINUX_SIG.get(sig, sig))
+        _, status = os.waitpid(self.pid, 0)
+        if os.WIFEXITED(status) or os.WIFSIGNALED(status):
+            self.alive = False
+            os.close(self.mem)
+        return status
+
+    def kill(self):
+        if self.alive:
+            os.kill(self.pid, signal.SIGKILL)
+            os.waitpid(self.pid, 0)
+            self.alive = False
+            os.close(self.mem)
+
+
+class Breakpoint(object):
+    def __init__(self, orig):
+        self.orig = orig
+        self.conds = []
+        self.cmds = []
+
+
+class Agent(object):
+    """The pdebug side of the connection."""
+
+    def __init__(self, opts, inferior):
+        self.opts = opts
+        self.inf = inferior
+        self.log_file = open(opts.log, "w") if opts.log else None
+        self.inbuf = bytearray()
+        self.gdb_pid = 0
+        self.bps = {}
+        self.sig_to_pass = 0
+        self.quiet_signals = set()
+        self.notify_mid = 0
+        major, minor = opts.protover.split(".")
+        self.protover = (int(major) << 8) | int(minor)
+
+    def log(self, fmt, *args):
+        if self.log_file:
+            self.log_file.write((fmt % args) + "\n")
+            self.log_file.flush()
+
+    # Transport.
+
+    def read_packet(self):
+        """Return the next packet from GDB, or None at EOF."""
+        while True:
+            start = self.inbuf.find(bytes([FRAME_CHAR]))
+            if start >= 0:
+                end = self.inbuf.find(bytes([FRAME_CHAR]), start + 1)
+                if end == start + 1:
+                    # Back to back frame characters; skip one.
+                    del self.inbuf[:start + 1]
+                    continue
+                if end > start:
+                    raw = self.inbuf[start + 1:end]
+                    del self.inbuf[:end + 1]
+                    pkt = bytearray()
+                    esc = False
+                    for c in raw:
+                        if c == ESC_CHAR:
+                            esc = True
+                            continue
+                        pkt.append(c ^ 0x20 if esc else c)
+                        esc = False
+                    if sum(pkt) & 0xff != 0xff:
+                        continue
+                    return bytes(pkt[:-1])
+            data = os.read(0, 4096)
+            if not data:
+                return None
+            self.inbuf += data
+
+    def send_packet(self, data):
+        data = bytes(data)
+        data += bytes([~sum(data) & 0xff])
+        out = bytearray([FRAME_CHAR])
+        for c in data:
+            if c in (FRAME_CHAR, ESC_CHAR):
+                out += bytes([ESC_CHAR, c ^ 0x20])
+            else:
+                out.append(c)
+        out.append(FRAME_CHAR)
+        os.write(1, bytes(out))
+
+    def reply(self, req, cmd, payload=b""):
+        self.send_packet(struct.pack("<BBBB", cmd, 0, req[2],
+                                     SET_CHANNEL_DEBUG) + payload)
+
+    def reply_ok(self, req):
+        self.reply(req, DSrMsg_ok)
+
+    def reply_err(self, req, err):
+        self.reply(req, DSrMsg_err, struct.pack("<i", err))
+
+    def reply_status(self, req, status):
+        self.reply(req, DSrMsg_okstatus, struct.pack("<i", status))
+
+    def reply_data(self, req, data):
+        self.reply(req, DSrMsg_okdata, data)
+
+    def notify(self, subcmd, payload):
+        self.notify_mid = (self.notify_mid + 1) & 0xff
+        self.send_packet(struct.pack("<BBBBiii", DShMsg_notify, subcmd,
+                                     self.notify_mid, SET_CHANNEL_DEBUG,
+                                     self.gdb_pid, 1, 0) + payload)
+
+    def text(self, string):
+        self.send_packet(struct.pack("<BBBB", 0, 0, 0, SET_CHANNEL_TEXT)
+                         + string.encode())
+
+    # Memory, with the breakpoints hidden.
+
+    def read_memory(self, addr, size):
+        data = bytearray(self.inf.read(addr, size))
+        for bp_addr, bp in self.bps.items():
+            if addr <= bp_addr < addr + len(data):
+                data[bp_addr - addr] = bp.orig
+        return bytes(data)
+
+    def write_memory(self, addr, data):
+        data = bytearray(data)
+        for bp_addr, bp in self.bps.items():
+            if addr <= bp_addr < addr + len(data):
+                bp.orig = data[bp_addr - addr]
+                data[bp_addr - addr] = 0xcc
+        return self.inf.write(addr, bytes(data))
+
+    def handle_memrd_list(self, req):
+        if self.opts.reject_memrdlist or self.protover < 0x000b:
+            self.log("memrdlist rejected")
+            return self.reply_err(req, EINVAL)
+        count, = struct.unpack_from("<I", req, 4)
+        self.log("memrdlist %d", count)
+        data = b""
+        for i in range(count):
+            addr, size, _ = struct.unpack_from("<QII", req, 8 + 16 * i)
+            try:
+                chunk = self.read_memory(addr, size)
+            except OSError:
+                chunk = b""
+            if len(chunk) != size:
+                break
+            data += chunk
+        return self.reply_data(req, data)
+
+    # Breakpoints.
+
+    def set_breakpoint(self, addr):
+        if addr not in self.bps:
+            orig = self.inf.read(addr, 1)
+            if len(orig) != 1:
+                return False
+            self.inf.write(addr, b"\xcc")
+            self.bps[addr] = Breakpoint(orig[0])
+        bp = self.bps[addr]
+        bp.conds = []
+        bp.cmds = []
+        return True
+
+    def clear_breakpoint(self, addr):
+        bp = self.bps.pop(addr, None)
+        if bp is None:
+            return False
+        if self.inf.alive:
+            self.inf.write(addr, bytes([bp.orig]))
+        return True
+
+    def handle_brk(self, subcmd, addr, size):
+        """Handle one breakpoint request without expressions."""
+        if size == -1:
+            self.log("brk clear 0x%x", addr)
+            return self.clear_breakpoint(addr)
+        if not subcmd & DSMSG_BRK_EXEC:
+            return False
+        if subcmd & DSMSG_BRK_AGENT and self.opts.reject_agent:
+            self.log("brk agent rejected")
+            return False
+        self.log("brk set 0x%x", addr)
+        return self.set_breakpoint(addr)
+
+    def handle_brk_msg(self, req):
+        subcmd = req[1]
+        if subcmd & DSMSG_BRK_LIST:
+            if self.opts.reject_brklist or self.protover < 0x0008:
+                self.log("brklist rejected")
+                return self.reply_err(req, EINVAL)
+            count, = struct.unpack_from("<I", req, 4)
+            self.log("brklist %d", count)
+            done = 0
+            for i in range(count):
+                addr, size, esubcmd = struct.unpack_from("<QiI", req, 8 + 16 * i)
+                if not self.handle_brk(esubcmd, addr, size):
+                    break
+                done += 1
+            return self.reply_status(req, done)
+        size, addr = struct.unpack_from("<iQ", req, 4)
+        if subcmd & DSMSG_BRK_AGENT and size != -1:
+            if self.opts.reject_agent or self.protover < 0x0009:
+                self.log("brk agent rejected")
+                return self.reply_err(req, EINVAL)
+            ncond, ncmd, persist = struct.unpack_from("<HHI", req, 16)
+            exprs = []
+            off = 24
+            for i in range(ncond + ncmd):
+                length, = struct.unpack_from("<H", req, off)
+                exprs.append(req[off + 2:off + 2 + length])
+                off += 2 + length
+            if not self.set_breakpoint(addr):
+                return self.reply_err(req, EIO)
+            self.log("brk agent 0x%x %d %d", addr, ncond, ncmd)
+            self.bps[addr].conds = exprs[:ncond]
+            self.bps[addr].cmds = exprs[ncond:]
+            return self.reply_ok(req)
+        if self.handle_brk(subcmd, addr, size):
+            return self.reply_ok(req)
+        return self.reply_err(req, EINVAL)
+
+    # Agent expressions, as in gdbserver/ax.c.
+
+    def eval_expr(self, expr, regs):
+        stack = []
+        pc = 0
+
+        def pop():
+            if not stack:
+                raise AgentError("stack underflow")
+            return stack.pop()
+
+        def ref(size):
+            data = self.read_memory(pop(), size)
+            if len(data) != size:
+                raise AgentError("memory error")
+            return int.from_bytes(data, "little")
+
+        while pc < len(expr):
+            op = expr[pc]
+            pc += 1
+            if op == 0x27:              # end
+                return pop() if stack else 0
+            elif op in (0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+                        0x0a, 0x0b, 0x0f, 0x10, 0x11, 0x13, 0x14, 0x15):
+                b = pop()
+                a = pop()
+                if op == 0x02:
+                    r = a + b
+                elif op == 0x03:
+                    r = a - b
+                elif op == 0x04:
+                    r = a * b
+                elif op in (0x05, 0x07):
+                    if b == 0:
+                        raise AgentError("division by zero")
+                    q = abs(signed(a)) // abs(signed(b))
+                    if (signed(a) < 0) != (signed(b) < 0):
+                        q = -q
+                    r = q if op == 0x05 else signed(a) - q * signed(b)
+                elif op in (0x06, 0x08):
+                    if b == 0:
+                        raise AgentError("division by zero")
+                    r = a // b if op == 0x06 else a % b
+                elif op == 0x09:
+                    r = a << (b & 63)
+                elif op == 0x0a:
+                    r = signed(a) >> (b & 63)
+                elif op == 0x0b:
+                    r = a >> (b & 63)
+                elif op == 0x0f:
+                    r = a & b
+                elif op == 0x10:
+                    r = a | b
+                elif op == 0x11:
+                    r = a ^ b
+                elif op == 0x13:
+                    r = int(a == b)
+                elif op == 0x14:
+                    r = int(signed(a) < signed(b))
+                else:
+                    r = int(a < b)
+                stack.append(r & MASK64)
+            elif op == 0x0e:            # log_not
+                stack.append(int(pop() == 0))
+            elif op == 0x12:            # bit_not
+                stack.append(~pop() & MASK64)
+            elif op == 0x16:            # ext
+                bits = expr[pc]
+                pc += 1
+                stack.append(signed(pop(), bits) & MASK64)
+            elif op == 0x2a:            # zero_ext
+                bits = expr[pc]
+                pc += 1
+                stack.append(pop() & ((1 << bits) - 1))
+            elif 0x17 <= op <= 0x1a:    # ref8 ... ref64
+                stack.append(ref(1 << (op - 0x17)))
+            elif op in (0x20, 0x21):    # if_goto, goto
+                target = int.from_bytes(expr[pc:pc + 2], "big")
+                pc += 2
+                if op == 0x21 or pop():
+                    pc = target
+            elif 0x22 <= op <= 0x25:    # const8 ... const64
+                size = 1 << (op - 0x22)
+                stack.append(int.from_bytes(expr[pc:pc + size], "big"))
+                pc += size
+            elif op == 0x26:            # reg
+                regno = int.from_bytes(expr[pc:pc + 2], "big")
+                pc += 2
+                if regno >= len(GDB_REGS):
+                    raise AgentError("register %d" % regno)
+                stack.append(getattr(regs, GDB_REGS[regno]))
+            elif op == 0x28:            # dup
+                stack.append(stack[-1])
+            elif op == 0x29:            # pop
+                pop()
+            elif op == 0x2b:            # swap
+                stack[-1], stack[-2] = stack[-2], stack[-1]
+            elif op == 0x32:            # pick
+                n = expr[pc]
+                pc += 1
+                stack.append(stack[-1 - n])
+            elif op == 0x33:            # rot
+                stack[-3:] = [stack[-1], stack[-3], stack[-2]]
+            elif op == 0x34:            # printf
+                nargs = expr[pc]
+                slen = int.from_bytes(expr[pc + 1:pc + 3], "big")
+                fmt = bytes(expr[pc + 3:pc + 3 + slen]).rstrip(b"\0").decode()
+                pc += 3 + slen
+                pop()                   # function
+                pop()                   # channel
+                args = [pop() for i in range(nargs)]
+                self.agent_printf(fmt, args)
+            else:
+                raise AgentError("unsupported bytecode 0x%x" % op)
+        raise AgentError("missing end")
+
+    def read_string(self, addr):
+        data = b""
+        while b"\0" not in data and len(data) < 4096:
+            chunk = self.read_memory(addr + len(data), 64)
+            if not chunk:
+                break
+            data += chunk
+        return data.split(b"\0")[0].decode(errors="replace")
+
+    def agent_printf(self, fmt, args):
+        args = list(args)
+
+        def convert(m):
+            flags, width, prec, length, conv = m.groups()
+            if conv == "%":
+                return "%"
+            value = args.pop(0) if args else 0
+            spec = "%" + (flags or "") + (width or "")
+            if prec is not None:
+                spec += "." + prec
+            bits = 64 if length in ("l", "ll", "z", "j", "t") else 32
+            if conv in "di":
+                return (spec + "d") % signed(value, bits)
+            if conv in "ouxX":
+                return (spec + conv) % (value & ((1 << bits) - 1))
+            if conv == "c":
+                return (spec + "c") % chr(value & 0xff)
+            if conv == "p":
+                return (spec + "s") % ("0x%x" % value)
+            return (spec + "s") % self.read_string(value)
+
+        # The format is sent as written, escapes included.
+        escapes = {"n": "\n", "t": "\t", "r": "\r", "a": "\a", "b": "\b",
+                   "f": "\f", "v": "\v", "e": "\033", "\\": "\\", '"': '"'}
+        fmt = re.sub(r"\\(.)", lambda m: escapes.get(m.group(1), m.group(1)),
+                     fmt)
+        out = re.sub(r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(hh|h|ll|l|z|j|t)?"
+                     r"([diouxXcsp%])", convert, fmt)
+        self.log("agent printf")
+        self.text(out)
+
+    def breakpoint_hit(self, addr):
+        """Evaluate the expressions of the breakpoint at ADDR, which the
+        thread just reached.  Return True if GDB is to be notified."""
+        bp = self.bps[addr]
+        regs = self.inf.get_regs()
+        regs.rip = addr
+        try:
+            if bp.conds:
+                if not any(self.eval_expr(c, regs) for c in bp.conds):
+                    self.log("condition false 0x%x", addr)
+                    return False
+                self.log("condition true 0x%x", addr)
+            if bp.cmds:
+                for cmd in bp.cmds:
+                    self.eval_expr(cmd, regs)
+                return False
+        except AgentError as e:
+            self.log("agent error: %s", e)
+        return True
+
+    # Execution control.
+
+    def step(self, from_bp, sig):
+        """Single-step the thread, stepping over the breakpoint at its pc
+        if FROM_BP."""
+        pc = self.inf.pc()
+        bp = self.bps.get(pc) if from_bp else None
+        if bp is not None:
+            self.inf.write(pc, bytes([bp.orig]))
+        status = self.inf.resume(PTRACE_SINGLESTEP, sig)
+        if bp is not None and self.inf.alive and pc in self.bps:
+            self.inf.write(pc, b"\xcc")
+        return status
+
+    def report_stop(self, status, lastip=None):
+        """Tell GDB why the thread stopped, unless it got a signal GDB
+        does not want to see.  LASTIP is the pc before the thread was
+        single-stepped, if it was.  Return the signal to pass and
+        resume with in that case, None otherwise."""
+        if os.WIFEXITED(status):
+            self.log("notify exit %d", os.WEXITSTATUS(status))
+            self.notify(DSMSG_NOTIFY_PIDUNLOAD,
+                        struct.pack("<iB3x", os.WEXITSTATUS(status), 0))
+            return None
+        if os.WIFSIGNALED(status):
+            sig = os.WTERMSIG(status)
+            self.notify(DSMSG_NOTIFY_PIDUNLOAD,
+                        struct.pack("<iB3x", LINUX_TO_QNX_SIG.get(sig, sig),
+                                    1))
+            return None
+        sig = os.WSTOPSIG(status)
+        sig = LINUX_TO_QNX_SIG.get(sig, sig)
+        if sig == signal.SIGTRAP:
+            pc = self.inf.pc()
+            if lastip is None and pc - 1 in self.bps:
+                self.log("notify brk 0x%x", pc - 1)
+                self.notify(DSMSG_NOTIFY_BRK, struct.pack("<QII", pc, 0, 0))
+            else:
+                self.log("notify step 0x%x", pc)
+                self.notify(DSMSG_NOTIFY_STEP,
+                            struct.pack("<QQ", pc, lastip or 0))
+            return None
+        if sig in self.quiet_signals:
+            return sig
+        self.log("notify signal %d", sig)
+        self.notify(DSMSG_NOTIFY_SIGEV, struct.pack("<iiq", sig, 0, 0))
+        return None
+
+    def run_continue(self, sig):
+        from_bp = True
+        while True:
+            if from_bp and self.inf.pc() in self.bps:
+                status = self.step(True, sig)
+                sig = 0
+                if not os.WIFSTOPPED(status) or os.WSTOPSIG(status) != signal.SIGTRAP:
+                    sig = self.report_stop(status)
+                    if sig is None:
+                        return
+                    continue
+            from_bp = False
+            status = self.inf.resume(PTRACE_CONT, sig)
+            sig = 0
+            if os.WIFSTOPPED(status) and os.WSTOPSIG(status) == signal.SIGTRAP:
+                addr = self.inf.pc() - 1
+                if addr in self.bps and not self.breakpoint_hit(addr):
+                    self.inf.set_pc(addr)
+                    from_bp = True
+                    continue
+            sig = self.report_stop(status)
+            if sig is None:
+                return
+
+    def run_range(self, start, end, sig):
+        self.log("run range 0x%x 0x%x", start, end)
+        from_bp = True
+        steps = 0
+        while True:
+            pc = self.inf.pc()
+            if not from_bp and pc in self.bps:
+                if self.breakpoint_hit(pc):
+                    # GDB is stepping, so it expects the pc at the
+                    # breakpoint rather than after it.
+                    self.log("range steps %d", steps)
+                    self.log("notify brk 0x%x", pc)
+                    self.notify(DSMSG_NOTIFY_BRK,
+                                struct.pack("<QII", pc, 0, 0))
+                    return
+            status = self.step(True, sig)
+            steps += 1
+            sig = 0
+            from_bp = False
+            if not os.WIFSTOPPED(status) or os.WSTOPSIG(status) != signal.SIGTRAP:
+                sig = self.report_stop(status)
+                if sig is None:
+                    self.log("range steps %d", steps)
+                    return
+                continue
+            if not start <= self.inf.pc() < end:
+                self.log("range steps %d", steps)
+                self.report_stop(status, pc)
+                return
+
+    def handle_run(self, req):
+        subcmd = req[1]
+        self.reply_ok(req)
+        sig, self.sig_to_pass = self.sig_to_pass, 0
+        if subcmd == DSMSG_RUN_RANGE and self.protover >= 0x000a:
+            start, end = struct.unpack_from("<QQ", req, 8)
+            self.run_range(start, end, sig)
+        elif subcmd == DSMSG_RUN_COUNT:
+            self.log("run count")
+            pc = self.inf.pc()
+            self.report_stop(self.step(True, sig), pc)
+        else:
+            self.log("run")
+            self.run_continue(sig)
+
+    # Registers.
+
+    def qnx_gregs(self):
+        regs = self.inf.get_regs()
+        return struct.pack("<20Q", *[getattr(regs, name) for name in QNX_REGS])
+
+    def set_qnx_gregs(self, data):
+        regs = self.inf.get_regs()
+        values = struct.unpack("<20Q", data)
+        for name, value in zip(QNX_REGS, values):
+            if name not in ("cs", "ss"):
+                setattr(regs, name, value)
+        self.inf.set_regs(regs)
+
+    def handle_regrd(self, req):
+        offset, size = struct.unpack_from("<HH", req, 4)
+        if req[1] == 0:
+            data = self.qnx_gregs()
+        elif req[1] == 1:
+            data = self.inf.get_fpregs()
+        else:
+            return self.reply_err(req, EINVAL)
+        self.reply_data(req, data[offset:offset + size])
+
+    def handle_regwr(self, req):
+        offset, = struct.unpack_from("<H", req, 4)
+        payload = req[6:]
+        if req[1] == 0:
+            data = bytearray(self.qnx_gregs())
+            data[offset:offset + len(payload)] = payload
+            self.set_qnx_gregs(bytes(data[:160]))
+        elif req[1] == 1:
+            data = bytearray(self.inf.get_fpregs())
+            data[offset:offset + len(payload)] = payload
+            self.inf.set_fpregs(bytes(data[:512]))
+        else:
+            return self.reply_err(req, EINVAL)
+        self.reply_ok(req)
+
+    # The main loop.
+
+    def pidlist(self):
+        name = os.path.basename(self.opts.program[0]).encode() + b"\0"
+        name += b"\0" * (-len(name) % 4)
+        return (struct.pack("<ii24x4x", self.gdb_pid, 1) + name
+                + struct.pack("<hBBhBB", 1, 2, 0, 0, 0, 0))
+
+    def handle(self, req):
+        cmd = req[0] & 0x7f
+        if cmd == DSrMsg_ok:
+            # GDB acknowledging a notification.
+            return
+        if cmd in (DStMsg_connect, DStMsg_disconnect):
+            return self.reply_ok(req)
+        if cmd == DStMsg_protover:
+            self.log("protover %d.%d", self.protover >> 8,
+                     self.protover & 0xff)
+            return self.reply_status(req, self.protover)
+        if cmd == DStMsg_cpuinfo:
+            return self.reply_data(req, struct.pack("<4I", X86_64_CPU_FXSR,
+                                                    0, 0, 0))
+        if cmd == DStMsg_attach:
+            self.gdb_pid, = struct.unpack_from("<i", req, 4)
+            name = os.path.basename(self.opts.program[0]).encode()
+            return self.reply(req, DSrMsg_okdata,
+                              struct.pack("<iiiqqHHI", self.gdb_pid, 1, 0,
+                                          0, 0, 0, 0, 0) + name + b"\0")
+        if not self.inf.alive:
+            if cmd in (DStMsg_detach, DStMsg_kill):
+                return self.reply_ok(req)
+            return self.reply_err(req, ESRCH)
+        if cmd == DStMsg_select:
+            pid, tid = struct.unpack_from("<ii", req, 4)
+            if req[1] == DSMSG_SELECT_QUERY:
+                if tid > 1:
+                    return self.reply_err(req, ESRCH)
+                return self.reply_data(req, struct.pack("<hBB", 1, 2, 0))
+            if tid != 1:
+                return self.reply_err(req, ESRCH)
+            return self.reply_ok(req)
+        if cmd == DStMsg_pidlist:
+            if req[1] in (DSMSG_PIDLIST_SPECIFIC, DSMSG_PIDLIST_SPECIFIC_TID):
+                return self.reply_data(req, self.pidlist())
+            return self.reply_err(req, EINVAL)
+        if cmd == DStMsg_memrd and req[1] & DSMSG_MEMRD_LIST:
+            return self.handle_memrd_list(req)
+        if cmd == DStMsg_memrd:
+            addr, size = struct.unpack_from("<QH", req, 8)
+            try:
+                data = self.read_memory(addr, size)
+            except OSError:
+                data = b""
+            if not data:
+                return self.reply_err(req, EIO)
+            return self.reply_data(req, data)
+        if cmd == DStMsg_memwr:
+            addr, = struct.unpack_from("<Q", req, 8)
+            try:
+                written = self.write_memory(addr, req[16:])
+            except OSError:
+                return self.reply_err(req, EIO)
+            return self.reply_status(req, written)
+        if cmd == DStMsg_regrd:
+            return self.handle_regrd(req)
+        if cmd == DStMsg_regwr:
+            return self.handle_regwr(req)
+        if cmd == DStMsg_brk:
+            return self.handle_brk_msg(req)
+        if cmd == DStMsg_handlesig:
+            signals = req[4:4 + 57]
+            self.quiet_signals = set(i for i, s in enumerate(signals) if not s)
+            self.sig_to_pass, = struct.unpack_from("<I", req, 64)
+            return self.reply_ok(req)
+        if cmd == DStMsg_run:
+            return self.handle_run(req)
+        if cmd == DStMsg_kill:
+            signo, = struct.unpack_from("<i", req, 4)
+            if signo == signal.SIGKILL:
+                self.inf.kill()
+            else:
+                self.sig_to_pass = signo
+            return self.reply_ok(req)
+        if cmd == DStMsg_detach:
+            for addr in list(self.bps):
+                self.clear_breakpoint(addr)
+            ptrace(PTRACE_DETACH, self.inf.pid)
+            self.inf.alive = False
+            return self.reply_ok(req)
+        # Everything else is not implemented.
+        return self.reply_err(req, EINVAL)
+
+    def serve(self):
+        while True:
+            req = self.read_packet()
+            if req is None:
+                break
+            if len(req) < 4:
+                # A channel command.
+                continue
+            self.handle(req)
+        self.inf.kill()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--log")
+    parser.add_argument("--protover", default="0.11")
+    parser.add_argument("--reject-brklist", action="store_true")
+    parser.add_argument("--reject-agent", action="store_true")
+    parser.add_argument("--reject-memrdlist", action="store_true")
+    parser.add_argument("program", nargs=argparse.REMAINDER)
+    opts = parser.parse_args()
+    Agent(opts, Inferior(opts.program)).serve()
+
+
+if __name__ == "__main__":
+    main()
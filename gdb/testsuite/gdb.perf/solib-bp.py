@@ -0,0 +1,59 @@
+# Copyright (C) 2018 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case is to test the speed of GDB when it loads shared
+# libraries while there are breakpoints in the libraries already
+# loaded and breakpoints pending on the libraries being loaded.
+
+from perftest import perftest
+from perftest import measure
+
+class SolibBreakpoints(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, solib_count):
+        # We want to measure time in this test.
+        super (SolibBreakpoints, self).__init__ ("solib_breakpoints")
+        self.solib_count = solib_count
+
+    def warm_up(self):
+        do_test_load = "call do_test_load (0, %d)" % self.solib_count
+        do_test_unload = "call do_test_unload (0, %d)" % self.solib_count
+        gdb.execute(do_test_load)
+        gdb.execute(do_test_unload)
+
+    def execute_test(self):
+        half = self.solib_count // 2
+        do_test_load = "call do_test_load (%d, %d)" % (half, self.solib_count)
+        do_test_unload = "call do_test_unload (%d, %d)" % (half,
+                                                           self.solib_count)
+
+        gdb.execute("set breakpoint pending on")
+        gdb.execute("call do_test_load (0, %d)" % half)
+
+        # NUM breakpoints in the libraries already loaded, and NUM
+        # pending on the libraries the measurement loads.
+        num = 0
+        while num <= half:
+            for i in range(num):
+                gdb.execute("break shr%d" % i, to_string=True)
+                gdb.execute("break shr%d" % (half + i), to_string=True)
+
+            func = lambda: gdb.execute (do_test_load)
+            self.measure.measure(func, num)
+
+            gdb.execute(do_test_unload)
+            gdb.execute("delete")
+            num = num * 2 if num > 0 else 1
+
+        gdb.execute("call do_test_unload (0, %d)" % half)
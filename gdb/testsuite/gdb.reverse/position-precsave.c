@@ -0,0 +1,39 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int counter;
+int values[8];
+
+static void
+bump (int i)
+{
+  counter += i;
+  values[i % 8] = counter;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+    bump (i);
+  counter++; /* middle */
+  for (i = 0; i < 16; i++)
+    bump (2 * i);
+  return 0; /* end */
+}
@@ -0,0 +1,37 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int
+main (void)
+{
+  int i;
+
+  /* Each iteration has a VLA of a different size, at the same address
+     and in the same frame.  */
+  for (i = 1; i <= 2; i++)
+    {
+      int vla[i];
+      int j;
+
+      for (j = 0; j < i; j++)
+	vla[j] = i;
+
+      vla[0] = i;  /* vla filled */
+    }
+
+  return 0;
+}
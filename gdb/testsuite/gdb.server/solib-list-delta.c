@@ -0,0 +1,70 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <link.h>
+#include <stddef.h>
+
+static void
+marker (void)
+{
+}
+
+/* Move the last library in the dynamic linker's list in front of the
+   one before it.  */
+
+static void
+swap_last_libraries (void)
+{
+  struct link_map *last = _r_debug.r_map;
+  struct link_map *prev;
+
+  while (last->l_next != NULL)
+    last = last->l_next;
+  prev = last->l_prev;
+
+  prev->l_prev->l_next = last;
+  last->l_prev = prev->l_prev;
+  last->l_next = prev;
+  prev->l_prev = last;
+  prev->l_next = NULL;
+}
+
+int
+main (void)
+{
+  void *h1, *h2, *h3;
+
+  h1 = dlopen (SHLIB_NAME1, RTLD_NOW);
+  h2 = dlopen (SHLIB_NAME2, RTLD_NOW);
+  marker ();
+
+  dlclose (h1);
+  marker ();
+
+  h1 = dlopen (SHLIB_NAME1, RTLD_NOW);
+  swap_last_libraries ();
+  h3 = dlopen (SHLIB_NAME3, RTLD_NOW);
+  marker ();
+
+  dlclose (h3);
+  marker ();
+
+  dlclose (h1);
+  dlclose (h2);
+  return 0;
+}
@@ -0,0 +1,183 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2018 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This program generates a trace file with several traceframes from
+   two tracepoints, and a copy of it truncated in the middle of a
+   traceframe.  */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <stdint.h>
+
+/* The number of traceframes, and the number of complete traceframes
+   in the truncated copy.  */
+#define FRAMES 6
+#define TRUNCATED_FRAMES 3
+
+char spbuf[200];
+
+char trbuf[1000];
+char *trptr;
+
+/* This global is put in each traceframe, with the number of the
+   traceframe times ten.  */
+
+int testglob;
+
+static void
+tfile_write_64 (uint64_t value)
+{
+  memcpy (trptr, &value, sizeof (uint64_t));
+  trptr += sizeof (uint64_t);
+}
+
+static void
+tfile_write_32 (uint32_t value)
+{
+  memcpy (trptr, &value, sizeof (uint32_t));
+  trptr += sizeof (uint32_t);
+}
+
+static void
+tfile_write_16 (uint16_t value)
+{
+  memcpy (trptr, &value, sizeof (uint16_t));
+  trptr += sizeof (uint16_t);
+}
+
+static void
+tfile_write_8 (uint8_t value)
+{
+  memcpy (trptr, &value, sizeof (uint8_t));
+  trptr += sizeof (uint8_t);
+}
+
+static void
+tfile_write_buf (const void *addr, size_t size)
+{
+  memcpy (trptr, addr, size);
+  trptr += size;
+}
+
+/* Adjust a function's address to account for architectural
+   particularities.  */
+
+static uintptr_t
+adjust_function_address (uintptr_t func_addr)
+{
+#if defined(__thumb__) || defined(__thumb2__)
+  /* Although Thumb functions are two-byte aligned, function
+     pointers have the Thumb bit set.  Clear it.  */
+  return func_addr & ~1;
+#elif defined __powerpc64__ && _CALL_ELF != 2
+  /* Get function address from function descriptor.  */
+  return *(uintptr_t *) func_addr;
+#else
+  return func_addr;
+#endif
+}
+
+/* Get a function's address as an integer.  */
+
+#define FUNCTION_ADDRESS(FUN) adjust_function_address ((uintptr_t) &FUN)
+
+/* The functions the two tracepoints are at.  */
+
+void
+tracepoint_one (void)
+{
+}
+
+void
+tracepoint_two (void)
+{
+}
+
+/* Write the trace file FILENAME, ending it after SIZE bytes of the
+   trace buffer if SIZE is not negative.  */
+
+void
+write_trace_file (const char *filename, int size)
+{
+  int fd, i, int_x;
+  char *frame_size;
+
+  fd = open (filename, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0)
+    return;
+
+  write (fd, "\x7fTRACE0\n", 8);
+
+  snprintf (spbuf, sizeof spbuf, "R %x\n", 500);
+  write (fd, spbuf, strlen (spbuf));
+  snprintf (spbuf, sizeof spbuf,
+	    "status 0;tstop:0;tframes:%x;tcreated:%x;tfree:100;tsize:1000\n",
+	    FRAMES, FRAMES);
+  write (fd, spbuf, strlen (spbuf));
+  snprintf (spbuf, sizeof spbuf, "tp T1:%llx:E:0:0\n",
+	    (unsigned long long) FUNCTION_ADDRESS (tracepoint_one));
+  write (fd, spbuf, strlen (spbuf));
+  snprintf (spbuf, sizeof spbuf, "tp T2:%llx:E:0:0\n",
+	    (unsigned long long) FUNCTION_ADDRESS (tracepoint_two));
+  write (fd, spbuf, strlen (spbuf));
+  write (fd, "\n", 1);
+
+  /* Traceframe I is collected by tracepoint I % 2 + 1.  */
+  trptr = trbuf;
+  for (i = 0; i < FRAMES; i++)
+    {
+      tfile_write_16 (i % 2 + 1);
+      frame_size = trptr;
+      trptr += 4;
+
+      testglob = i * 10;
+      tfile_write_8 ('M');
+      tfile_write_64 ((uint64_t) (uintptr_t) &testglob);
+      tfile_write_16 (sizeof (testglob));
+      tfile_write_buf (&testglob, sizeof (testglob));
+
+      /* Go back and patch in the frame size.  */
+      int_x = trptr - frame_size - 4;
+      memcpy (frame_size, &int_x, 4);
+    }
+
+  /* Write end of tracebuffer marker.  */
+  tfile_write_16 (0);
+  tfile_write_32 (0);
+
+  write (fd, trbuf, size < 0 ? trptr - trbuf : size);
+  close (fd);
+}
+
+int
+main (void)
+{
+  int frame_size = 2 + 4 + 1 + 8 + 2 + sizeof (testglob);
+
+  write_trace_file (TFILE_DIR "tfile-index.tf", -1);
+
+  /* Cut the copy in the middle of the data of a traceframe.  */
+  write_trace_file (TFILE_DIR "tfile-index-truncated.tf",
+		    TRUNCATED_FRAMES * frame_size + frame_size / 2);
+
+  tracepoint_one ();
+  tracepoint_two ();
+  return 0;
+}
@@ -33,6 +33,10 @@
 #include "target-descriptions.h"
 #include "buffer.h"
 #include <algorithm>
+#include <unordered_map>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -424,27 +428,102 @@ static int cur_data_size;
 int trace_regblock_size;
 static struct buffer trace_tdesc;
 
+/* Where the next tfile_read reads from.  */
+static off_t trace_pos;
+
+/* The whole trace file, if it could be mapped into memory, and its
+   size.  */
+static const gdb_byte *trace_map;
+static size_t trace_map_size;
+
+/* An entry in the index of the traceframes of the trace file.  */
+
+struct tfile_traceframe
+{
+  /* Offset of the traceframe's blocks in the file.  */
+  off_t offset;
+
+  /* Size of the traceframe's blocks.  */
+  unsigned int data_size;
+
+  /* Number of the tracepoint that collected the traceframe, as known
+     to the target.  */
+  short tpnum;
+};
+
+/* The traceframes of the trace file, in file order, so that a
+   traceframe's number is its index.  Built on the first tfind.  */
+static std::vector<tfile_traceframe> trace_frames;
+static bool trace_frames_indexed;
+
 static void tfile_append_tdesc_line (const char *line);
 static void tfile_interp_line (char *line,
 			       struct uploaded_tp **utpp,
 			       struct uploaded_tsv **utsvp);
 
-/* Read SIZE bytes into READBUF from the trace frame, starting at
-   TRACE_FD's current position.  Note that this call `read'
-   underneath, hence it advances the file's seek position.  Throws an
-   error if the `read' syscall fails, or less than SIZE bytes are
-   read.  */
+/* Read SIZE bytes into READBUF from the trace file, starting at
+   TRACE_POS, and advance TRACE_POS past them.  The bytes are copied
+   out of the mapped file if there is one, and read from TRACE_FD
+   otherwise.  Throws an error if the `read' syscall fails, or less
+   than SIZE bytes are read.  */
 
 static void
 tfile_read (gdb_byte *readbuf, int size)
 {
   int gotten;
 
+  if (trace_map != NULL)
+    {
+      if (trace_pos < 0 || (ULONGEST) trace_pos > trace_map_size
+	  || trace_map_size - trace_pos < (size_t) size)
+	error (_("Premature end of file while reading trace file"));
+      memcpy (readbuf, trace_map + trace_pos, size);
+      trace_pos += size;
+      return;
+    }
+
+  if (lseek (trace_fd, trace_pos, SEEK_SET) != trace_pos)
+    perror_with_name (trace_filename);
   gotten = read (trace_fd, readbuf, size);
   if (gotten < 0)
     perror_with_name (trace_filename);
   else if (gotten < size)
     error (_("Premature end of file while reading trace file"));
+  trace_pos += size;
+}
+
+/* Map the trace file into memory, if possible.  */
+
+static void
+tfile_map_file (void)
+{
+#ifdef HAVE_SYS_MMAN_H
+  struct stat st;
+
+  if (fstat (trace_fd, &st) != 0 || st.st_size <= 0
+      || (ULONGEST) st.st_size != (size_t) st.st_size)
+    return;
+
+  void *map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, trace_fd, 0);
+  if (map == MAP_FAILED)
+    return;
+
+  trace_map = (const gdb_byte *) map;
+  trace_map_size = st.st_size;
+#endif
+}
+
+/* Undo tfile_map_file.  */
+
+static void
+tfile_unmap_file (void)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (trace_map != NULL)
+    munmap ((void *) trace_map, trace_map_size);
+#endif
+  trace_map = NULL;
+  trace_map_size = 0;
 }
 
 /* Open the tfile target.  */
@@ -483,6 +562,11 @@ tfile_target_open (const char *arg, int from_tty)
 
   trace_filename = filename.release ();
   trace_fd = scratch_chan;
+  trace_pos = 0;
+  tfile_unmap_file ();
+  tfile_map_file ();
+  trace_frames.clear ();
+  trace_frames_indexed = false;
 
   /* Make sure this is clear.  */
   buffer_free (&trace_tdesc);
@@ -621,8 +705,13 @@ tfile_target::close ()
   inferior_ptid = null_ptid;	/* Avoid confusion from thread stuff.  */
   exit_inferior_silent (current_inferior ());
 
+  tfile_unmap_file ();
   ::close (trace_fd);
   trace_fd = -1;
+  trace_frames.clear ();
+  trace_frames_indexed = false;
+  cur_offset = 0;
+  cur_data_size = 0;
   xfree (trace_filename);
   trace_filename = NULL;
   buffer_free (&trace_tdesc);
@@ -643,54 +732,117 @@ tfile_target::get_tracepoint_status (struct breakpoint *tp, struct uploaded_tp *
      trace files, so nothing to do here.  */
 }
 
-/* Given the position of a traceframe in the file, figure out what
-   address the frame was collected at.  This would normally be the
-   value of a collected PC register, but if not available, we
-   improvise.  */
+/* Given the number, as known to the target, of the tracepoint that
+   collected a traceframe, figure out what address the frame was
+   collected at.  This would normally be the value of a collected PC
+   register, but if not available, we improvise.  */
 
 static CORE_ADDR
-tfile_get_traceframe_address (off_t tframe_offset)
+tfile_get_traceframe_address (short tpnum)
 {
   CORE_ADDR addr = 0;
-  short tpnum;
   struct tracepoint *tp;
-  off_t saved_offset = cur_offset;
 
   /* FIXME dig pc out of collected registers.  */
 
   /* Fall back to using tracepoint address.  */
-  lseek (trace_fd, tframe_offset, SEEK_SET);
-  tfile_read ((gdb_byte *) &tpnum, 2);
-  tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					  gdbarch_byte_order
-					      (target_gdbarch ()));
-
   tp = get_tracepoint_by_number_on_target (tpnum);
   /* FIXME this is a poor heuristic if multiple locations.  */
   if (tp && tp->loc)
     addr = tp->loc->address;
 
-  /* Restore our seek position.  */
-  cur_offset = saved_offset;
-  lseek (trace_fd, cur_offset, SEEK_SET);
   return addr;
 }
 
-/* Given a type of search and some parameters, scan the collection of
-   traceframes in the file looking for a match.  When found, return
-   both the traceframe and tracepoint number, otherwise -1 for
-   each.  */
+/* Return the size of the trace file.  */
+
+static off_t
+tfile_size (void)
+{
+  struct stat st;
+
+  if (trace_map != NULL)
+    return trace_map_size;
+
+  if (fstat (trace_fd, &st) != 0)
+    perror_with_name (trace_filename);
+  return st.st_size;
+}
+
+/* Fill in trace_frames, if not done yet, by walking the headers of
+   all the traceframes in the file.  If the file ends before the end
+   of the trace buffer, e.g. because it was truncated while being
+   copied, keep the traceframes that are complete.  */
+
+static void
+tfile_index_traceframes (void)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  std::vector<tfile_traceframe> frames;
+  bool truncated = true;
+  off_t size;
+
+  if (trace_frames_indexed)
+    return;
+
+  size = tfile_size ();
+  trace_pos = trace_frames_offset;
+  while (size - trace_pos >= 2)
+    {
+      tfile_traceframe frame;
+      gdb_byte buf[4];
+
+      tfile_read (buf, 2);
+      frame.tpnum = (short) extract_signed_integer (buf, 2, byte_order);
+      if (frame.tpnum == 0)
+	{
+	  truncated = false;
+	  break;
+	}
+      if (size - trace_pos < 4)
+	break;
+      tfile_read (buf, 4);
+      frame.data_size
+	= (unsigned int) extract_unsigned_integer (buf, 4, byte_order);
+      frame.offset = trace_pos;
+      if ((ULONGEST) (size - trace_pos) < frame.data_size)
+	break;
+
+      frames.push_back (frame);
+
+      /* Skip past the traceframe's data.  */
+      trace_pos += frame.data_size;
+    }
+
+  if (truncated)
+    warning (_("Trace file \"%s\" is truncated; "
+	       "only its first %d traceframes are available."),
+	     trace_filename, (int) frames.size ());
+
+  trace_frames = std::move (frames);
+  trace_frames_indexed = true;
+}
+
+/* Given a type of search and some parameters, look through the
+   traceframes in the file for a match.  When found, return both the
+   traceframe and tracepoint number, otherwise -1 for each.  */
 
 int
 tfile_target::trace_find (enum trace_find_type type, int num,
 			  CORE_ADDR addr1, CORE_ADDR addr2, int *tpp)
 {
-  short tpnum;
-  int tfnum = 0, found = 0;
-  unsigned int data_size;
-  struct tracepoint *tp;
-  off_t offset, tframe_offset;
+  int tfnum, found = -1;
   CORE_ADDR tfaddr;
+  /* Traceframe addresses, by tracepoint number.  */
+  std::unordered_map<short, CORE_ADDR> addrs;
+  auto traceframe_address = [&] (short tpnum)
+    {
+      auto it = addrs.find (tpnum);
+
+      if (it == addrs.end ())
+	it = addrs.emplace (tpnum, tfile_get_traceframe_address (tpnum)).first;
+      return it->second;
+    };
 
   if (num == -1)
     {
@@ -699,78 +851,62 @@ tfile_target::trace_find (enum trace_find_type type, int num,
       return -1;
     }
 
-  lseek (trace_fd, trace_frames_offset, SEEK_SET);
-  offset = trace_frames_offset;
-  while (1)
-    {
-      tframe_offset = offset;
-      tfile_read ((gdb_byte *) &tpnum, 2);
-      tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					      gdbarch_byte_order
-						  (target_gdbarch ()));
-      offset += 2;
-      if (tpnum == 0)
-	break;
-      tfile_read ((gdb_byte *) &data_size, 4);
-      data_size = (unsigned int) extract_unsigned_integer
-                                     ((gdb_byte *) &data_size, 4,
-				      gdbarch_byte_order (target_gdbarch ()));
-      offset += 4;
+  tfile_index_traceframes ();
 
-      if (type == tfind_number)
-	{
-	  /* Looking for a specific trace frame.  */
-	  if (tfnum == num)
-	    found = 1;
-	}
-      else
+  if (type == tfind_number)
+    {
+      /* Looking for a specific trace frame.  */
+      if (num >= 0 && (size_t) num < trace_frames.size ())
+	found = num;
+    }
+  else
+    {
+      /* Start from the _next_ trace frame.  */
+      for (tfnum = std::max (get_traceframe_number () + 1, 0);
+	   found < 0 && (size_t) tfnum < trace_frames.size ();
+	   tfnum++)
 	{
-	  /* Start from the _next_ trace frame.  */
-	  if (tfnum > get_traceframe_number ())
+	  short tpnum = trace_frames[tfnum].tpnum;
+
+	  switch (type)
 	    {
-	      switch (type)
-		{
-		case tfind_pc:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (tfaddr == addr1)
-		    found = 1;
-		  break;
-		case tfind_tp:
-		  tp = get_tracepoint (num);
-		  if (tp && tpnum == tp->number_on_target)
-		    found = 1;
-		  break;
-		case tfind_range:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (addr1 <= tfaddr && tfaddr <= addr2)
-		    found = 1;
-		  break;
-		case tfind_outside:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (!(addr1 <= tfaddr && tfaddr <= addr2))
-		    found = 1;
-		  break;
-		default:
-		  internal_error (__FILE__, __LINE__, _("unknown tfind type"));
-		}
+	    case tfind_pc:
+	      tfaddr = traceframe_address (tpnum);
+	      if (tfaddr == addr1)
+		found = tfnum;
+	      break;
+	    case tfind_tp:
+	      /* NUM is already the number the target knows the
+		 tracepoint by; see tfind_tracepoint_command.  */
+	      if (tpnum == num)
+		found = tfnum;
+	      break;
+	    case tfind_range:
+	      tfaddr = traceframe_address (tpnum);
+	      if (addr1 <= tfaddr && tfaddr <= addr2)
+		found = tfnum;
+	      break;
+	    case tfind_outside:
+	      tfaddr = traceframe_address (tpnum);
+	      if (!(addr1 <= tfaddr && tfaddr <= addr2))
+		found = tfnum;
+	      break;
+	    default:
+	      internal_error (__FILE__, __LINE__, _("unknown tfind type"));
 	    }
 	}
+    }
 
-      if (found)
-	{
-	  if (tpp)
-	    *tpp = tpnum;
-	  cur_offset = offset;
-	  cur_data_size = data_size;
+  if (found >= 0)
+    {
+      if (tpp)
+	*tpp = trace_frames[found].tpnum;
+      cur_offset = trace_frames[found].offset;
+      cur_data_size = trace_frames[found].data_size;
 
-	  return tfnum;
-	}
-      /* Skip past the traceframe's data.  */
-      lseek (trace_fd, data_size, SEEK_CUR);
-      offset += data_size;
-      /* Update our own count of traceframes.  */
-      ++tfnum;
+      return found;
     }
+
   /* Did not find what we were looking for.  */
   if (tpp)
     *tpp = -1;
@@ -808,7 +944,7 @@ traceframe_walk_blocks (walk_blocks_callback_func callback,
   /* Iterate through a traceframe's blocks, looking for a block of the
      requested type.  */
 
-  lseek (trace_fd, cur_offset + pos, SEEK_SET);
+  trace_pos = cur_offset + pos;
   while (pos < cur_data_size)
     {
       unsigned short mlen;
@@ -824,21 +960,21 @@ traceframe_walk_blocks (walk_blocks_callback_func callback,
       switch (block_type)
 	{
 	case 'R':
-	  lseek (trace_fd, cur_offset + pos + trace_regblock_size, SEEK_SET);
+	  trace_pos = cur_offset + pos + trace_regblock_size;
 	  pos += trace_regblock_size;
 	  break;
 	case 'M':
-	  lseek (trace_fd, cur_offset + pos + 8, SEEK_SET);
+	  trace_pos = cur_offset + pos + 8;
 	  tfile_read ((gdb_byte *) &mlen, 2);
           mlen = (unsigned short)
                 extract_unsigned_integer ((gdb_byte *) &mlen, 2,
                                           gdbarch_byte_order
                                               (target_gdbarch ()));
-	  lseek (trace_fd, mlen, SEEK_CUR);
+	  trace_pos += mlen;
 	  pos += (8 + 2 + mlen);
 	  break;
 	case 'V':
-	  lseek (trace_fd, cur_offset + pos + 4 + 8, SEEK_SET);
+	  trace_pos = cur_offset + pos + 4 + 8;
 	  pos += (4 + 8);
 	  break;
 	default:
@@ -986,7 +1122,7 @@ tfile_target::xfer_partial (enum target_object object,
 		amt = len;
 
 	      if (maddr != offset)
-	        lseek (trace_fd, offset - maddr, SEEK_CUR);
+	        trace_pos += offset - maddr;
 	      tfile_read (readbuf, amt);
 	      *xfered_len = amt;
 	      return TARGET_XFER_OK;
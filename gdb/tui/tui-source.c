@@ -25,6 +25,7 @@
 #include "frame.h"
 #include "breakpoint.h"
 #include "source.h"
+#include "source-cache.h"
 #include "symtab.h"
 #include "objfiles.h"
 #include "filenames.h"
@@ -36,6 +37,17 @@
 #include "tui/tui-source.h"
 #include "gdb_curses.h"
 
+/* Return the character at *P and advance *P, or return EOF if *P is
+   END.  */
+
+static int
+tui_next_source_char (const char **p, const char *end)
+{
+  if (*p == end)
+    return EOF;
+  return (unsigned char) *(*p)++;
+}
+
 /* Function to display source in the source window.  */
 enum tui_status
 tui_set_source_content (struct symtab *s, 
@@ -46,8 +58,7 @@ tui_set_source_content (struct symtab *s,
 
   if (s != (struct symtab *) NULL)
     {
-      FILE *stream;
-      int i, desc, c, line_width, nlines;
+      int i, c, line_width, nlines;
       char *src_line = 0;
 
       if ((ret = tui_alloc_source_buffer (TUI_SRC_WIN)) == TUI_SUCCESS)
@@ -56,8 +67,8 @@ tui_set_source_content (struct symtab *s,
 	  /* Take hilite (window border) into account, when
 	     calculating the number of lines.  */
 	  nlines = (line_no + (TUI_SRC_WIN->generic.height - 2)) - line_no;
-	  desc = open_source_file (s);
-	  if (desc < 0)
+	  source_text_ref text = source_cache_get (s);
+	  if (text == NULL)
 	    {
 	      if (!noerror)
 		{
@@ -71,23 +82,12 @@ tui_set_source_content (struct symtab *s,
 	    }
 	  else
 	    {
-	      if (s->line_charpos == 0)
-		find_source_lines (s, desc);
-
-	      if (line_no < 1 || line_no > s->nlines)
-		{
-		  close (desc);
-		  printf_unfiltered ("Line number %d out of range; "
-				     "%s has %d lines.\n",
-				     line_no,
-				     symtab_to_filename_for_display (s),
-				     s->nlines);
-		}
-	      else if (lseek (desc, s->line_charpos[line_no - 1], 0) < 0)
-		{
-		  close (desc);
-		  perror_with_name (symtab_to_filename_for_display (s));
-		}
+	      if (line_no < 1 || line_no > text->nlines ())
+		printf_unfiltered ("Line number %d out of range; "
+				   "%s has %d lines.\n",
+				   line_no,
+				   symtab_to_filename_for_display (s),
+				   text->nlines ());
 	      else
 		{
 		  int offset, cur_line_no, cur_line, cur_len, threshold;
@@ -108,8 +108,9 @@ tui_set_source_content (struct symtab *s,
                      line and the offset to start the display.  */
 		  offset = src->horizontal_offset;
 		  threshold = (line_width - 1) + offset;
-		  stream = fdopen (desc, FOPEN_RT);
-		  clearerr (stream);
+		  const char *p
+		    = text->data () + text->line_charpos ()[line_no - 1];
+		  const char *end = text->data () + text->size ();
 		  cur_line = 0;
 		  src->gdbarch = get_objfile_arch (SYMTAB_OBJFILE (s));
 		  src->start_line_or_addr.loa = LOA_LINE;
@@ -123,7 +124,7 @@ tui_set_source_content (struct symtab *s,
 			= TUI_SRC_WIN->generic.content[cur_line];
 
 		      /* Get the first character in the line.  */
-		      c = fgetc (stream);
+		      c = tui_next_source_char (&p, end);
 
 		      if (offset == 0)
 			src_line = TUI_SRC_WIN->generic.content[cur_line]
@@ -200,13 +201,13 @@ tui_set_source_content (struct symtab *s,
 				{ /* If we have not reached EOL, then
 				     eat chars until we do.  */
 				  while (c != EOF && c != '\n' && c != '\r')
-				    c = fgetc (stream);
+				    c = tui_next_source_char (&p, end);
 				  /* Handle non-'\n' end-of-line.  */
 				  if (c == '\r' 
-				      && (c = fgetc (stream)) != '\n' 
+				      && (c = tui_next_source_char (&p, end)) != '\n' 
 				      && c != EOF)
 				    {
-				       ungetc (c, stream);
+				       p--;
 				       c = '\r';
 				    }
 				  
@@ -214,7 +215,7 @@ tui_set_source_content (struct symtab *s,
 			    }
 			  while (c != EOF && c != '\n' && c != '\r' 
 				 && i < threshold 
-				 && (c = fgetc (stream)));
+				 && (c = tui_next_source_char (&p, end)));
 			}
 		      /* Now copy the line taking the offset into
 			 account.  */
@@ -232,7 +233,6 @@ tui_set_source_content (struct symtab *s,
 		    }
 		  if (offset > 0)
 		    xfree (src_line);
-		  fclose (stream);
 		  TUI_SRC_WIN->generic.content_size = nlines;
 		  ret = TUI_SUCCESS;
 		}
@@ -362,10 +362,12 @@ tui_vertical_source_scroll (enum tui_scroll_direction scroll_direction,
       l.loa = LOA_LINE;
       if (scroll_direction == FORWARD_SCROLL)
 	{
+	  source_text_ref text = source_cache_get (s);
+
 	  l.u.line_no = content[0]->which_element.source.line_or_addr.u.line_no
 	    + num_to_scroll;
-	  if (l.u.line_no > s->nlines)
-	    /* line = s->nlines - win_info->generic.content_size + 1; */
+	  if (text == NULL || l.u.line_no > text->nlines ())
+	    /* line = nlines - win_info->generic.content_size + 1; */
 	    /* elz: fix for dts 23398.  */
 	    l.u.line_no
 	      = content[0]->which_element.source.line_or_addr.u.line_no;
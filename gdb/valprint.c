@@ -30,6 +30,7 @@
 #include "target-float.h"
 #include "extension.h"
 #include "ada-lang.h"
+#include "c-lang.h"
 #include "gdb_obstack.h"
 #include "charset.h"
 #include "typeprint.h"
@@ -1123,6 +1124,78 @@ value_check_printable (struct value *val, struct ui_file *stream,
   return 1;
 }
 
+/* Limit the arrays of type TYPE at byte OFFSET within VAL, or within
+   the structure of type TYPE there, to the elements OPTIONS let GDB
+   print.  Return nonzero if any array was limited.  */
+
+static int
+limit_arrays_for_printing (struct value *val, struct type *type,
+			   LONGEST offset,
+			   const struct value_print_options *options)
+{
+  int limited = 0;
+
+  type = check_typedef (type);
+  if (TYPE_CODE (type) == TYPE_CODE_ARRAY)
+    {
+      struct type *elttype = check_typedef (TYPE_TARGET_TYPE (type));
+
+      /* Strings are printed from the whole array.  */
+      if (c_textual_element_type (TYPE_TARGET_TYPE (type), options->format))
+	return 0;
+      return value_limit_array (val, offset, type,
+				((LONGEST) options->print_max
+				 * TYPE_LENGTH (elttype)));
+    }
+
+  /* The members of a union overlap, and base classes may be
+     virtual, so only look into the fields of structures.  */
+  if (TYPE_CODE (type) != TYPE_CODE_STRUCT)
+    return 0;
+
+  for (int i = TYPE_N_BASECLASSES (type); i < TYPE_NFIELDS (type); i++)
+    {
+      if (field_is_static (&TYPE_FIELD (type, i))
+	  || TYPE_FIELD_PACKED (type, i))
+	continue;
+
+      limited |= limit_arrays_for_printing (val, TYPE_FIELD_TYPE (type, i),
+					    (offset
+					     + (TYPE_FIELD_BITPOS (type, i)
+						/ TARGET_CHAR_BIT)),
+					    options);
+    }
+  return limited;
+}
+
+/* If VAL is a lazy array or structure in memory with arrays that have
+   more elements than OPTIONS let GDB print, return a copy of it that
+   is only read as far as printing goes.  VAL itself is left alone, as
+   its owner may need all of it later.  Otherwise, return VAL.  */
+
+static struct value *
+value_limited_for_printing (struct value *val,
+			    const struct value_print_options *options,
+			    const struct language_defn *language)
+{
+  struct value *copy;
+
+  if (!value_lazy (val)
+      || VALUE_LVAL (val) != lval_memory
+      || options->print_max == UINT_MAX
+      || (language->la_language != language_c
+	  && language->la_language != language_cplus
+	  && language->la_language != language_objc
+	  && language->la_language != language_asm
+	  && language->la_language != language_minimal))
+    return val;
+
+  copy = value_copy (val);
+  if (!limit_arrays_for_printing (copy, value_type (val), 0, options))
+    return val;
+  return copy;
+}
+
 /* Print using the given LANGUAGE the value VAL onto stream STREAM according
    to OPTIONS.
 
@@ -1134,6 +1207,8 @@ common_val_print (struct value *val, struct ui_file *stream, int recurse,
 		  const struct value_print_options *options,
 		  const struct language_defn *language)
 {
+  val = value_limited_for_printing (val, options, language);
+
   if (!value_check_printable (val, stream, options))
     return;
 
@@ -1160,6 +1235,8 @@ void
 value_print (struct value *val, struct ui_file *stream,
 	     const struct value_print_options *options)
 {
+  val = value_limited_for_printing (val, options, current_language);
+
   if (!value_check_printable (val, stream, options))
     return;
 
@@ -1991,6 +2068,12 @@ val_print_array_elements (struct type *type,
 
   for (; i < len && things_printed < options->print_max; i++)
     {
+      /* VAL may have been read only partially; read this element, or
+	 stop where it can not be read.  */
+      value_read_limited (val, embedded_offset + i * eltlen, eltlen);
+      if (value_bytes_limited (val, embedded_offset + i * eltlen, eltlen))
+	break;
+
       if (i != 0)
 	{
 	  if (options->prettyformat_arrays)
@@ -2013,14 +2096,17 @@ val_print_array_elements (struct type *type,
 	 UINT_MAX (unlimited).  */
       if (options->repeat_count_threshold < UINT_MAX)
 	{
-	  while (rep1 < len
-		 && value_contents_eq (val,
-				       embedded_offset + i * eltlen,
-				       val,
-				       (embedded_offset
-					+ rep1 * eltlen),
-				       eltlen))
+	  while (rep1 < len)
 	    {
+	      value_read_limited (val, embedded_offset + rep1 * eltlen,
+				  eltlen);
+	      if (!value_contents_eq (val,
+				      embedded_offset + i * eltlen,
+				      val,
+				      (embedded_offset
+				       + rep1 * eltlen),
+				      eltlen))
+		break;
 	      ++reps;
 	      ++rep1;
 	    }
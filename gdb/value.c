@@ -86,6 +86,16 @@ struct range
   }
 };
 
+/* An array of LENGTH bytes at byte OFFSET within a value, of which
+   only the first READ bytes are read from the target.  */
+
+struct limited_array
+{
+  LONGEST offset;
+  LONGEST length;
+  LONGEST read;
+};
+
 /* Returns true if the ranges defined by [offset1, offset1+len1) and
    [offset2, offset2+len2) overlap.  */
 
@@ -355,6 +365,11 @@ struct value
      treated pretty much the same, except not-saved registers have a
      different string representation and related error strings.  */
   std::vector<range> optimized_out;
+
+  /* Arrays within this value in memory that are read only partially
+     from the target when the value is fetched, sorted by offset.  The
+     parts not read are marked unavailable.  See value_limit_array.  */
+  std::vector<limited_array> limited;
 };
 
 /* See value.h.  */
@@ -1009,6 +1024,31 @@ check_type_length_before_alloc (const struct type *type)
     }
 }
 
+/* Return nonzero if VAL is an array limited by value_limit_array as
+   a whole.  */
+
+static int
+value_is_limited_array (const struct value *val)
+{
+  return (val->limited.size () == 1
+	  && val->limited[0].offset == 0
+	  && val->limited[0].length == TYPE_LENGTH (val->enclosing_type));
+}
+
+/* Return the number of bytes allocated for the contents of VAL: the
+   length of its enclosing type, or, for an array limited as a whole,
+   only the part of it that is read.  Arrays within a limited
+   aggregate are allocated whole, as the aggregate may be copied
+   whole when printed.  */
+
+static LONGEST
+value_allocated_length (const struct value *val)
+{
+  if (value_is_limited_array (val))
+    return val->limited[0].read;
+  return TYPE_LENGTH (val->enclosing_type);
+}
+
 /* Allocate the contents of VAL if it has not been allocated yet.  */
 
 static void
@@ -1016,9 +1056,13 @@ allocate_value_contents (struct value *val)
 {
   if (!val->contents)
     {
-      check_type_length_before_alloc (val->enclosing_type);
+      /* Only the part read of a limited array is allocated, so that
+	 GDB may show the beginning of an array larger than
+	 max-value-size.  */
+      if (!value_is_limited_array (val))
+	check_type_length_before_alloc (val->enclosing_type);
       val->contents.reset
-	((gdb_byte *) xzalloc (TYPE_LENGTH (val->enclosing_type)));
+	((gdb_byte *) xzalloc (value_allocated_length (val)));
     }
 }
 
@@ -1304,7 +1348,7 @@ void
 value_contents_copy_raw (struct value *dst, LONGEST dst_offset,
 			 struct value *src, LONGEST src_offset, LONGEST length)
 {
-  LONGEST src_bit_offset, dst_bit_offset, bit_length;
+  LONGEST src_bit_offset, dst_bit_offset, bit_length, copy_length;
   struct gdbarch *arch = get_value_arch (src);
   int unit_size = gdbarch_addressable_memory_unit_size (arch);
 
@@ -1322,10 +1366,15 @@ value_contents_copy_raw (struct value *dst, LONGEST dst_offset,
 					     TARGET_CHAR_BIT * dst_offset,
 					     TARGET_CHAR_BIT * length));
 
-  /* Copy the data.  */
-  memcpy (value_contents_all_raw (dst) + dst_offset * unit_size,
-	  value_contents_all_raw (src) + src_offset * unit_size,
-	  length * unit_size);
+  /* Copy the data.  Past the allocated part of a limited SRC there
+     is nothing to copy; that part is unavailable.  */
+  copy_length = std::min (length * unit_size,
+			  value_allocated_length (src)
+			  - src_offset * unit_size);
+  if (copy_length > 0)
+    memcpy (value_contents_all_raw (dst) + dst_offset * unit_size,
+	    value_contents_all_raw (src) + src_offset * unit_size,
+	    copy_length);
 
   /* Copy the meta-data, adjusted.  */
   src_bit_offset = src_offset * unit_size * HOST_CHAR_BIT;
@@ -1662,10 +1711,10 @@ value_copy (struct value *arg)
   struct type *encl_type = value_enclosing_type (arg);
   struct value *val;
 
-  if (value_lazy (arg))
-    val = allocate_value_lazy (encl_type);
-  else
-    val = allocate_value (encl_type);
+  val = allocate_value_lazy (encl_type);
+  val->limited = arg->limited;
+  if (!value_lazy (arg))
+    allocate_value_contents (val);
   val->type = arg->type;
   VALUE_LVAL (val) = VALUE_LVAL (arg);
   val->location = arg->location;
@@ -1679,7 +1728,7 @@ value_copy (struct value *arg)
   if (!value_lazy (val))
     {
       memcpy (value_contents_all_raw (val), value_contents_all_raw (arg),
-	      TYPE_LENGTH (value_enclosing_type (arg)));
+	      value_allocated_length (arg));
 
     }
   val->unavailable = arg->unavailable;
@@ -2218,6 +2267,18 @@ get_internalvar_function (struct internalvar *var,
     }
 }
 
+/* Number of times the contents of a convenience variable have been
+   changed.  */
+static unsigned int internalvar_generation;
+
+/* See value.h.  */
+
+unsigned int
+get_internalvar_generation (void)
+{
+  return internalvar_generation;
+}
+
 void
 set_internalvar_component (struct internalvar *var,
 			   LONGEST offset, LONGEST bitpos,
@@ -2227,6 +2288,8 @@ set_internalvar_component (struct internalvar *var,
   struct gdbarch *arch;
   int unit_size;
 
+  ++internalvar_generation;
+
   switch (var->kind)
     {
     case INTERNALVAR_VALUE:
@@ -2345,6 +2408,10 @@ set_internalvar_function (struct internalvar *var, struct internal_function *f)
 void
 clear_internalvar (struct internalvar *var)
 {
+  /* Every other way of changing a variable's contents goes through
+     here.  */
+  ++internalvar_generation;
+
   /* Clean up old contents.  */
   switch (var->kind)
     {
@@ -3746,11 +3813,177 @@ value_fetch_lazy_memory (struct value *val)
 
   CORE_ADDR addr = value_address (val);
   struct type *type = check_typedef (value_enclosing_type (val));
+  int unit_size = gdbarch_addressable_memory_unit_size (get_type_arch (type));
+  LONGEST offset = 0;
+
+  /* Read the value up to the end of the part of each limited array
+     that is wanted, and leave the rest of the array unavailable.  */
+  for (const limited_array &la : val->limited)
+    {
+      LONGEST end = la.offset + la.read;
+
+      read_value_memory (val, offset * TARGET_CHAR_BIT, value_stack (val),
+			 addr + offset, value_contents_all_raw (val) + offset,
+			 (end - offset) / unit_size);
+      mark_value_bytes_unavailable (val, end, la.length - la.read);
+      offset = la.offset + la.length;
+    }
+
+  if (TYPE_LENGTH (type) > offset)
+    read_value_memory (val, offset * TARGET_CHAR_BIT, value_stack (val),
+		       addr + offset, value_contents_all_raw (val) + offset,
+		       (TYPE_LENGTH (type) - offset) / unit_size);
+}
+
+/* See value.h.  */
+
+int
+value_limit_array (struct value *val, LONGEST offset,
+		   struct type *array_type, LONGEST length)
+{
+  struct type *type = check_typedef (value_enclosing_type (val));
+  struct type *elttype;
+  LONGEST eltlen;
+
+  if (!value_lazy (val)
+      || VALUE_LVAL (val) != lval_memory
+      || value_bitsize (val) != 0
+      || value_embedded_offset (val) != 0
+      || gdbarch_addressable_memory_unit_size (get_type_arch (type)) != 1)
+    return 0;
+
+  array_type = check_typedef (array_type);
+  if (TYPE_CODE (array_type) != TYPE_CODE_ARRAY
+      || offset < 0
+      || offset + TYPE_LENGTH (array_type) > TYPE_LENGTH (type))
+    return 0;
+
+  elttype = check_typedef (TYPE_TARGET_TYPE (array_type));
+  eltlen = TYPE_LENGTH (elttype);
+  if (eltlen == 0 || TYPE_LENGTH (array_type) % eltlen != 0)
+    return 0;
 
-  if (TYPE_LENGTH (type))
-      read_value_memory (val, 0, value_stack (val),
-			 addr, value_contents_all_raw (val),
-			 type_length_units (type));
+  /* Keep whole elements.  */
+  length -= length % eltlen;
+  if (length == 0 || length >= TYPE_LENGTH (array_type))
+    return 0;
+
+  limited_array la = { offset, TYPE_LENGTH (array_type), length };
+  auto it = std::lower_bound (val->limited.begin (), val->limited.end (),
+			      la,
+			      [] (const limited_array &a,
+				  const limited_array &b)
+			      {
+				return a.offset < b.offset;
+			      });
+
+  /* Arrays do not overlap, unless they are members of a union.  */
+  if ((it != val->limited.end ()
+       && it->offset < la.offset + la.length)
+      || (it != val->limited.begin ()
+	  && std::prev (it)->offset + std::prev (it)->length > la.offset))
+    return 0;
+
+  val->limited.insert (it, la);
+  return 1;
+}
+
+/* See value.h.  */
+
+void
+value_read_limited (struct value *val, LONGEST offset, LONGEST length)
+{
+  LONGEST end = offset + length;
+
+  if (val->lazy)
+    return;
+
+  for (limited_array &la : val->limited)
+    {
+      LONGEST old_end, new_read;
+      int whole = value_is_limited_array (val);
+
+      if (la.offset + la.length <= offset)
+	continue;
+      if (la.offset >= end || la.offset + la.read >= end)
+	return;
+
+      /* Grow geometrically, so that scanning a long run of repeated
+	 elements costs few reads.  */
+      old_end = la.offset + la.read;
+      new_read = std::min (std::max (end - la.offset, 2 * la.read),
+			   la.length);
+
+      /* The contents of an array limited as a whole are allocated
+	 only as far as it is read; do not let them grow past
+	 max-value-size.  */
+      if (whole && max_value_size > -1)
+	new_read = std::min (new_read,
+			     std::max ((LONGEST) max_value_size, la.read));
+      if (new_read <= la.read)
+	return;
+
+      /* Drop the unavailable marks of the part not read before; the
+	 part read below, and what remains, are marked again as
+	 needed.  */
+      LONGEST bit_start = old_end * TARGET_CHAR_BIT;
+      LONGEST bit_end = (la.offset + la.length) * TARGET_CHAR_BIT;
+      std::vector<range> unavailable;
+
+      for (const range &r : val->unavailable)
+	{
+	  if (r.offset < bit_start)
+	    unavailable.push_back ({r.offset,
+				    std::min (r.offset + r.length, bit_start)
+				    - r.offset});
+	  if (r.offset + r.length > bit_end)
+	    {
+	      LONGEST start = std::max (r.offset, bit_end);
+
+	      unavailable.push_back ({start, r.offset + r.length - start});
+	    }
+	}
+      val->unavailable = std::move (unavailable);
+
+      if (whole)
+	val->contents.reset ((gdb_byte *) xrealloc (val->contents.release (),
+						     new_read));
+
+      la.read = new_read;
+
+      TRY
+	{
+	  read_value_memory (val, old_end * TARGET_CHAR_BIT,
+			     value_stack (val), value_address (val) + old_end,
+			     value_contents_all_raw (val) + old_end,
+			     la.offset + new_read - old_end);
+	}
+      CATCH (ex, RETURN_MASK_ALL)
+	{
+	  mark_value_bytes_unavailable (val, old_end,
+					la.offset + la.length - old_end);
+	  throw_exception (ex);
+	}
+      END_CATCH
+
+      if (new_read < la.length)
+	mark_value_bytes_unavailable (val, la.offset + new_read,
+				      la.length - new_read);
+      return;
+    }
+}
+
+/* See value.h.  */
+
+int
+value_bytes_limited (const struct value *val, LONGEST offset,
+		     LONGEST length)
+{
+  for (const limited_array &la : val->limited)
+    if (ranges_overlap (la.offset + la.read, la.length - la.read,
+			offset, length))
+      return 1;
+  return 0;
 }
 
 /* Helper for value_fetch_lazy when the value is in a register.  */
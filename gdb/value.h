@@ -395,6 +395,32 @@ extern const gdb_byte *
 
 extern void value_fetch_lazy (struct value *val);
 
+/* Arrange for the array of type ARRAY_TYPE at byte OFFSET within the
+   lazy value in memory VAL to be read only up to its first LENGTH
+   bytes, rounded down to whole elements, when VAL is fetched.  The
+   rest of the array is then marked unavailable.  If the array is VAL
+   itself, no memory is allocated in GDB for the rest either.  This lets
+   GDB show the beginning of arrays that are too large to be read
+   entirely, or that would take long to read over a slow link.
+   Returns nonzero if the array was limited, zero if VAL is not a lazy
+   value in memory, or the array is no larger than LENGTH.  */
+
+extern int value_limit_array (struct value *val, LONGEST offset,
+			      struct type *array_type, LONGEST length);
+
+/* Make sure that the LENGTH bytes at OFFSET of the fetched value VAL
+   are read, if they belong to an array limited by value_limit_array.
+   More of the array may be read at once.  */
+
+extern void value_read_limited (struct value *val, LONGEST offset,
+				LONGEST length);
+
+/* Return nonzero if any of the LENGTH bytes at OFFSET of VAL were not
+   read because of value_limit_array.  */
+
+extern int value_bytes_limited (const struct value *val, LONGEST offset,
+				LONGEST length);
+
 /* If nonzero, this is the value of a variable which does not actually
    exist in the program, at least partially.  If the value is lazy,
    this may fetch it now.  */
@@ -957,6 +983,10 @@ extern void set_internalvar_string (struct internalvar *var,
 
 extern void clear_internalvar (struct internalvar *var);
 
+/* Return the number of times the contents of a convenience variable
+   have been changed.  */
+extern unsigned int get_internalvar_generation (void);
+
 extern void set_internalvar_component (struct internalvar *var,
 				       LONGEST offset,
 				       LONGEST bitpos, LONGEST bitsize,
@@ -31,6 +31,7 @@
 #include "inferior.h"
 #include "varobj-iter.h"
 #include "parser-defs.h"
+#include "observable.h"
 
 #if HAVE_PYTHON
 #include "python/python.h"
@@ -57,10 +58,13 @@ const char *varobj_format_string[] =
 /* True if we want to allow Python-based pretty-printing.  */
 static bool pretty_printing = false;
 
+static void varobj_state_changed (void);
+
 void
 varobj_enable_pretty_printing (void)
 {
   pretty_printing = true;
+  varobj_state_changed ();
 }
 
 /* Data structures */
@@ -95,6 +99,13 @@ struct varobj_root
      to symbols that do not exist anymore.  */
   bool is_valid = true;
 
+  /* The value of varobj_state_generation when this root was last
+     updated, or 0 if the next -var-update must look at it.  Kept at 0
+     for trees with pretty-printers, whose output may depend on more
+     than the state of the inferior, and when updated while a thread
+     was running.  */
+  unsigned long update_generation = 0;
+
   /* Language-related operations for this variable and its
      children.  */
   const struct lang_varobj_ops *lang_ops = NULL;
@@ -208,6 +219,55 @@ static struct varobj_root *rootlist;
 /* Pointer to the varobj hash table (built at run time).  */
 static struct vlist **varobj_table;
 
+/* Bumped whenever something that a varobj's value can depend on may
+   have changed without the frame cache being flushed, GDB writing to
+   the target or a convenience variable being set: the inferior was
+   resumed, a setting or the symbols changed...  */
+static unsigned long varobj_generation = 1;
+
+/* Return a number that changes whenever the value of a non-floating
+   varobj might have changed while all threads are stopped.  Since all
+   the counters only grow, so does their sum.  */
+
+static unsigned long
+varobj_state_generation (void)
+{
+  return (varobj_generation + get_frame_cache_generation ()
+	  + get_target_write_generation () + get_internalvar_generation ());
+}
+
+/* Return true if any thread is running.  A running thread can change
+   memory at any time, without GDB knowing, so no varobj can be
+   assumed not to have changed.  */
+
+static bool
+varobj_any_thread_running (void)
+{
+  struct thread_info *tp;
+
+  ALL_NON_EXITED_THREADS (tp)
+    if (tp->state == THREAD_RUNNING || tp->executing)
+      return true;
+
+  return false;
+}
+
+/* Note that the values of all varobjs may have changed.  */
+
+static void
+varobj_state_changed (void)
+{
+  ++varobj_generation;
+}
+
+/* Make the next -var-update look at the tree VAR belongs to.  */
+
+static void
+varobj_mark_dirty (struct varobj *var)
+{
+  var->root->update_generation = 0;
+}
+
 
 
 /* API Implementation */
@@ -521,6 +581,8 @@ varobj_set_display_format (struct varobj *var,
       var->format = variable_default_display (var);
     }
 
+  varobj_mark_dirty (var);
+
   if (varobj_value_is_changeable_p (var) 
       && var->value != nullptr && !value_lazy (var->value.get ()))
     {
@@ -591,6 +653,7 @@ varobj_set_frozen (struct varobj *var, bool frozen)
      should do -var-update anyway.  It would be bad to have different
      client-size logic for structure and other types.  */
   var->frozen = frozen;
+  varobj_mark_dirty (var);
 }
 
 bool
@@ -842,6 +905,7 @@ const std::vector<varobj *> &
 varobj_list_children (struct varobj *var, int *from, int *to)
 {
   var->dynamic->children_requested = true;
+  varobj_mark_dirty (var);
 
   if (varobj_is_dynamic_p (var))
     {
@@ -868,19 +932,22 @@ varobj_list_children (struct varobj *var, int *from, int *to)
   while (var->children.size () < var->num_children)
     var->children.push_back (NULL);
 
-  for (int i = 0; i < var->num_children; i++)
+  /* Only create the children that were asked for; creating a child
+     reads its value, which is slow for large arrays.  */
+  varobj_restrict_range (var->children, from, to);
+
+  for (int i = *from; i < *to; i++)
     {
       if (var->children[i] == NULL)
 	{
 	  /* Either it's the first call to varobj_list_children for
-	     this variable object, and the child was never created,
+	     this range of children, and the child was never created,
 	     or it was explicitly deleted by the client.  */
 	  std::string name = name_of_child (var, i);
 	  var->children[i] = create_child (var, i, name);
 	}
     }
 
-  varobj_restrict_range (var->children, from, to);
   return var->children;
 }
 
@@ -1076,6 +1143,7 @@ varobj_set_value (struct varobj *var, const char *expression)
      'updated' flag.  There's no need to optimize that, because return value
      of -var-update should be considered an approximation.  */
   var->updated = install_new_value (var, val, false /* Compare values.  */);
+  varobj_mark_dirty (var);
   input_radix = saved_input_radix;
   return true;
 }
@@ -1441,6 +1509,7 @@ varobj_set_child_range (struct varobj *var, int from, int to)
 {
   var->from = from;
   var->to = to;
+  varobj_mark_dirty (var);
 }
 
 void 
@@ -1454,6 +1523,7 @@ varobj_set_visualizer (struct varobj *var, const char *visualizer)
 
   gdbpy_enter_varobj enter_py (var);
 
+  varobj_mark_dirty (var);
   mainmod = PyImport_AddModule ("__main__");
   gdbpy_ref<> globals
     = gdbpy_ref<>::new_reference (PyModule_GetDict (mainmod));
@@ -1531,6 +1601,8 @@ varobj_update (struct varobj **varp, bool is_explicit)
   struct value *newobj;
   std::vector<varobj_update_result> stack;
   std::vector<varobj_update_result> result;
+  unsigned long generation = varobj_state_generation ();
+  bool cacheable = !varobj_any_thread_running ();
 
   /* Frozen means frozen -- we don't check for any change in
      this varobj, including its going out of scope, or
@@ -1550,6 +1622,20 @@ varobj_update (struct varobj **varp, bool is_explicit)
     {
       varobj_update_result r (*varp);
 
+      /* If nothing the tree depends on can have changed since it was
+	 last updated, none of its values can have either.  Floating
+	 varobjs also depend on the selected frame, so they are always
+	 re-evaluated.  */
+      if (cacheable && !(*varp)->root->floating && !(*varp)->frozen
+	  && (*varp)->root->update_generation == generation)
+	{
+	  if (varobjdebug)
+	    fprintf_unfiltered (gdb_stdlog,
+				"varobj: %s unchanged since last update\n",
+				(*varp)->obj_name.c_str ());
+	  return result;
+	}
+
       /* Update the root variable.  value_of_root can return NULL
 	 if the variable is no longer around, i.e. we stepped out of
 	 the frame in which a local existed.  We are letting the 
@@ -1572,6 +1658,7 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	  if (r.type_changed || r.changed)
 	    result.push_back (std::move (r));
 
+	  (*varp)->root->update_generation = cacheable ? generation : 0;
 	  return result;
 	}
 
@@ -1627,6 +1714,8 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	  std::vector<varobj *> changed, type_changed, unchanged, newobj;
 	  bool children_changed = false;
 
+	  cacheable = false;
+
 	  if (v->frozen)
 	    continue;
 
@@ -1724,6 +1813,9 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	result.push_back (std::move (r));
     }
 
+  if ((*varp)->root->rootvar == *varp)
+    (*varp)->root->update_generation = cacheable ? generation : 0;
+
   return result;
 }
 
@@ -2524,11 +2616,82 @@ varobj_invalidate (void)
   all_root_varobjs (varobj_invalidate_iter, NULL);
 }
 
+/* Observers for the events after which the value of any varobj may
+   have changed.  */
+
+static void
+varobj_observer_target_resumed (ptid_t ptid)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_memory_changed (struct inferior *inf, CORE_ADDR addr,
+				ssize_t len, const bfd_byte *data)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_register_changed (struct frame_info *frame, int regnum)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_traceframe_changed (int tfnum, int tpnum)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_target_changed (struct target_ops *target)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_objfile_changed (struct objfile *objfile)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_thread_exit (struct thread_info *tp, int silent)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_inferior_exit (struct inferior *inf)
+{
+  varobj_state_changed ();
+}
+
+static void
+varobj_observer_command_param_changed (const char *param, const char *value)
+{
+  varobj_state_changed ();
+}
+
 void
 _initialize_varobj (void)
 {
   varobj_table = XCNEWVEC (struct vlist *, VAROBJ_TABLE_SIZE);
 
+  gdb::observers::target_resumed.attach (varobj_observer_target_resumed);
+  gdb::observers::memory_changed.attach (varobj_observer_memory_changed);
+  gdb::observers::register_changed.attach (varobj_observer_register_changed);
+  gdb::observers::traceframe_changed.attach
+    (varobj_observer_traceframe_changed);
+  gdb::observers::target_changed.attach (varobj_observer_target_changed);
+  gdb::observers::new_objfile.attach (varobj_observer_objfile_changed);
+  gdb::observers::free_objfile.attach (varobj_observer_objfile_changed);
+  gdb::observers::thread_exit.attach (varobj_observer_thread_exit);
+  gdb::observers::inferior_exit.attach (varobj_observer_inferior_exit);
+  gdb::observers::command_param_changed.attach
+    (varobj_observer_command_param_changed);
+
   add_setshow_zuinteger_cmd ("varobj", class_maintenance,
 			     &varobjdebug,
 			     _("Set varobj debugging."),